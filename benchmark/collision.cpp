@@ -0,0 +1,99 @@
+#include "util.hpp"
+
+#include <mbgl/text/collision_tile.hpp>
+
+#include <algorithm>
+
+using namespace mbgl;
+
+namespace {
+
+// Source layers of a streets tile that are labeled.
+const char* const labelLayers[] = { "place_label", "poi_label", "road_label", "housenum_label", "water_label" };
+
+// Builds collision features for the labels of a tile the way SymbolBucket does, with boxes sized by
+// the length of their names. Labels of lines follow the line.
+std::vector<CollisionFeature> loadLabels(const VectorTile& tile) {
+    std::vector<CollisionFeature> features;
+    for (const char* layerName : labelLayers) {
+        auto layer = tile.getLayer(layerName);
+        if (!layer) {
+            continue;
+        }
+
+        layer->eachFeature([&] (const GeometryTileFeature& feature) {
+            const auto value = feature.getValue("name");
+            const std::size_t length = value && value->is<std::string>() ? value->get<std::string>().size() : 4;
+            const float halfWidth = 6.0f * std::max<std::size_t>(length, 1);
+            const float halfHeight = 12.0f;
+
+            for (const auto& geometry : feature.getGeometries()) {
+                if (geometry.empty()) {
+                    continue;
+                }
+
+                std::vector<Coordinate> line;
+                for (const auto& point : geometry) {
+                    line.emplace_back(point.x, point.y);
+                }
+
+                if (feature.getType() == FeatureType::LineString && line.size() > 1) {
+                    const std::size_t segment = (line.size() - 1) / 2;
+                    const Anchor anchor((line[segment].x + line[segment + 1].x) / 2.0f,
+                                        (line[segment].y + line[segment + 1].y) / 2.0f, 0, 0.5f, int(segment));
+                    features.emplace_back(line, anchor, -halfHeight, halfHeight, -halfWidth, halfWidth, 1, 0, true);
+                } else {
+                    const Anchor anchor(line.front().x, line.front().y, 0, 0.5f);
+                    features.emplace_back(std::vector<Coordinate>(), anchor,
+                                          -halfHeight, halfHeight, -halfWidth, halfWidth, 1, 0, false);
+                }
+            }
+        });
+    }
+    return features;
+}
+
+} // namespace
+
+TEST(Benchmark, CollisionIndex) {
+    std::vector<std::vector<CollisionFeature>> tiles;
+    std::size_t boxes = 0;
+    for (const auto& tile : benchmark::loadStreetsTiles()) {
+        tiles.push_back(loadLabels(*tile));
+        for (const auto& feature : tiles.back()) {
+            boxes += feature.boxes.size();
+        }
+    }
+    ASSERT_LT(0u, boxes);
+    benchmark::report("collision, boxes per tile", double(boxes) / tiles.size(), "");
+
+    // Places all labels of every tile at a few camera angles and pitches, as the workers do
+    // while the map rotates.
+    std::size_t placed = 0;
+    auto run = [&] (CollisionIndex index) {
+        placed = 0;
+        for (const float angle : { 0.0, 0.5, 1.5, 3.0 }) {
+            for (const float pitch : { 0.0, 0.7 }) {
+                for (auto features : tiles) {
+                    CollisionTile collisionTile(PlacementConfig(angle, pitch, false, index));
+                    for (auto& feature : features) {
+                        const float scale = collisionTile.placeFeature(feature);
+                        collisionTile.insertFeature(feature, scale);
+                        placed += scale < collisionTile.maxScale;
+                    }
+                }
+            }
+        }
+    };
+
+    const std::size_t placements = 4 * 2 * tiles.size();
+
+    const Duration rtree = benchmark::measure([&] { run(CollisionIndex::RTree); });
+    const std::size_t rtreePlaced = placed;
+    benchmark::report("collision, r-tree, per tile", benchmark::milliseconds(rtree / placements), "ms");
+
+    const Duration grid = benchmark::measure([&] { run(CollisionIndex::Grid); });
+    benchmark::report("collision, grid, per tile", benchmark::milliseconds(grid / placements), "ms");
+
+    EXPECT_EQ(rtreePlaced, placed);
+}
@@ -0,0 +1,135 @@
+#include "util.hpp"
+
+#include <mbgl/map/decoded_geometry_tile.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/filter_expression.hpp>
+
+#include <rapidjson/document.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Counts the allocations of the whole program, so that the benchmark can tell how many of them
+// a piece of code made.
+std::atomic<std::size_t> allocations(0);
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocations++;
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+using namespace mbgl;
+
+namespace {
+
+const char* layerNames[] = { "landuse", "water", "road", "building", "poi_label", "road_label" };
+
+// The number of style layers that read each source layer, like in the streets style.
+const int styleLayers = 10;
+
+template <typename Fn>
+std::size_t countAllocations(Fn&& fn) {
+    const std::size_t before = allocations;
+    fn();
+    return allocations - before;
+}
+
+} // namespace
+
+TEST(Benchmark, FeatureAllocations) {
+    const auto tiles = benchmark::loadStreetsTiles();
+
+    std::size_t features = 0;
+    for (const auto& tile : tiles) {
+        for (const auto& name : layerNames) {
+            if (auto layer = tile->getLayer(name)) {
+                features += layer->featureCount();
+            }
+        }
+    }
+    ASSERT_LT(0u, features);
+
+    // A filter that matches some of the features of every layer, like most style layers have.
+    rapidjson::Document document;
+    document.Parse<0>(R"(["!=", "class", "service"])");
+    const CompiledFilter filter(parseFilterExpression(document));
+
+    // Allocates a feature object and the geometries of every feature, for every style layer.
+    const std::size_t perFeatureObjects = countAllocations([&] {
+        for (const auto& tile : tiles) {
+            for (const auto& name : layerNames) {
+                auto layer = tile->getLayer(name);
+                if (!layer) {
+                    continue;
+                }
+                GeometryTileLayerFilter layerFilter(*layer, filter);
+                for (int i = 0; i < styleLayers; i++) {
+                    for (std::size_t j = 0; j < layer->featureCount(); j++) {
+                        auto feature = layer->getFeature(j);
+                        if (layerFilter(*feature)) {
+                            feature->getGeometries();
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    // Decodes every source layer once, and lets the style layers iterate over it, like TileWorker.
+    std::size_t decode = 0;
+    std::size_t decodedLayers = 0;
+    std::size_t iterate = 0;
+    for (const auto& tile : tiles) {
+        DecodedGeometryTile decodedTile(*tile);
+        GeometryCollection buffer;
+        for (const auto& name : layerNames) {
+            util::ptr<GeometryTileLayer> layer;
+            decode += countAllocations([&] {
+                layer = decodedTile.getLayer(name);
+            });
+            if (!layer) {
+                continue;
+            }
+            decodedLayers++;
+
+            // The first pass grows the geometry buffer.
+            GeometryTileLayerFilter layerFilter(*layer, filter);
+            layer->eachFeature([&] (const GeometryTileFeature& feature) {
+                feature.readGeometries(buffer);
+            });
+
+            iterate += countAllocations([&] {
+                for (int i = 0; i < styleLayers; i++) {
+                    layer->eachFeature([&] (const GeometryTileFeature& feature) {
+                        if (layerFilter(feature)) {
+                            feature.readGeometries(buffer);
+                        }
+                    });
+                }
+            });
+        }
+    }
+
+    const double iterations = double(features) * styleLayers;
+    benchmark::report("feature objects, allocations per feature", perFeatureObjects / iterations, "");
+    // Decoding grows a few arrays per layer, independent of the number of features.
+    benchmark::report("decoded tile, decode allocations per feature", double(decode) / features, "");
+    benchmark::report("decoded tile, decode allocations per layer", double(decode) / decodedLayers, "");
+    benchmark::report("decoded tile, iteration allocations per feature", iterate / iterations, "");
+}
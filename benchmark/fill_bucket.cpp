@@ -0,0 +1,54 @@
+#include "util.hpp"
+
+#include <mbgl/renderer/fill_bucket.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// Decodes the polygons of a source layer of the streets fixture tiles, one geometry collection per
+// feature and tile.
+std::vector<std::vector<GeometryCollection>> loadPolygons(const std::string& layerName) {
+    std::vector<std::vector<GeometryCollection>> tiles;
+    for (const auto& tile : benchmark::loadStreetsTiles({ "15-17605-10749", "15-17605-10750" })) {
+        tiles.emplace_back();
+        auto layer = tile->getLayer(layerName);
+        if (!layer) {
+            continue;
+        }
+        layer->eachFeature([&] (const GeometryTileFeature& feature) {
+            if (feature.getType() == FeatureType::Polygon) {
+                tiles.back().push_back(feature.getGeometries());
+            }
+        });
+    }
+    return tiles;
+}
+
+} // namespace
+
+TEST(Benchmark, FillBucket) {
+    for (const char* layerName : { "building", "landuse" }) {
+        const auto tiles = loadPolygons(layerName);
+        std::size_t features = 0;
+        for (const auto& tile : tiles) {
+            features += tile.size();
+        }
+        ASSERT_LT(0u, features);
+
+        // The tolerance that FillLayer uses for tiles that aren't overscaled.
+        const Duration duration = benchmark::measure([&] {
+            util::CancellationCheckpoint checkpoint;
+            for (const auto& tile : tiles) {
+                FillBucket bucket(1.0f);
+                for (const auto& geometries : tile) {
+                    bucket.addGeometry(geometries, checkpoint);
+                }
+            }
+        });
+
+        const std::string name = std::string("fill bucket, ") + layerName;
+        benchmark::report((name + ", per tile").c_str(), benchmark::milliseconds(duration / tiles.size()), "ms");
+        benchmark::report((name + ", per feature").c_str(), benchmark::nanoseconds(duration / features) / 1000, "us");
+    }
+}
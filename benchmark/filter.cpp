@@ -0,0 +1,79 @@
+#include "util.hpp"
+
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <rapidjson/document.h>
+
+using namespace mbgl;
+
+namespace {
+
+struct StyleFilter {
+    std::string sourceLayer;
+    FilterExpression filter;
+    CompiledFilter compiled;
+};
+
+// Returns the filters of all layers of a streets style, along with the source layer they apply to.
+std::vector<StyleFilter> loadStreetsFilters() {
+    rapidjson::Document document;
+    document.Parse<0>(util::read_file("ios/benchmark/assets/styles/streets-v8.json").c_str());
+
+    std::vector<StyleFilter> filters;
+    const rapidjson::Value& layers = document["layers"];
+    for (rapidjson::SizeType i = 0; i < layers.Size(); i++) {
+        const rapidjson::Value& layer = layers[i];
+        if (layer.HasMember("source-layer") && layer.HasMember("filter")) {
+            const FilterExpression filter = parseFilterExpression(layer["filter"]);
+            filters.push_back({ layer["source-layer"].GetString(), filter, CompiledFilter(filter) });
+        }
+    }
+    return filters;
+}
+
+} // namespace
+
+TEST(Benchmark, FilterThroughput) {
+    const auto filters = loadStreetsFilters();
+    const auto tiles = benchmark::loadStreetsTiles();
+    ASSERT_FALSE(filters.empty());
+
+    std::size_t evaluated = 0;
+    std::size_t matched = 0;
+
+    auto run = [&] (bool compiled) {
+        evaluated = 0;
+        matched = 0;
+        for (const auto& tile : tiles) {
+            for (const auto& filter : filters) {
+                auto layer = tile->getLayer(filter.sourceLayer);
+                if (!layer) {
+                    continue;
+                }
+
+                if (compiled) {
+                    GeometryTileLayerFilter layerFilter(*layer, filter.compiled);
+                    layer->eachFeature([&] (const GeometryTileFeature& feature) {
+                        evaluated++;
+                        matched += layerFilter(feature);
+                    });
+                } else {
+                    layer->eachFeature([&] (const GeometryTileFeature& feature) {
+                        evaluated++;
+                        matched += evaluate(filter.filter, GeometryTileFeatureExtractor(feature));
+                    });
+                }
+            }
+        }
+    };
+
+    const Duration interpreted = benchmark::measure([&] { run(false); });
+    const std::size_t interpretedMatched = matched;
+    benchmark::report("filter, interpreted", benchmark::nanoseconds(interpreted) / evaluated, "ns/feature");
+
+    const Duration compiled = benchmark::measure([&] { run(true); });
+    benchmark::report("filter, compiled", benchmark::nanoseconds(compiled) / evaluated, "ns/feature");
+
+    EXPECT_EQ(interpretedMatched, matched);
+}
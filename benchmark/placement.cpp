@@ -0,0 +1,87 @@
+#include "util.hpp"
+
+#include <mbgl/util/constants.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// One full turn, one degree per frame.
+const std::size_t rotationFrames = 360;
+
+// Frames without pending work after which the workers are considered idle.
+const std::size_t idleFrames = 10;
+
+struct Result {
+    std::size_t placements = 0;
+    Duration placementRun = Duration::zero();
+};
+
+// Rotates the camera one degree per frame and measures how much time the workers spend placing
+// symbols again. With `gesture` set, the camera is rotated by a gesture; otherwise, every frame sets
+// the angle as if the camera stood still.
+class Rotation : public benchmark::MapHarness<Result> {
+public:
+    Rotation(View& view, FileSource& fileSource, std::function<void (Result)> callback_, bool gesture_)
+        : MapHarness(view, fileSource, callback_),
+          gesture(gesture_) {
+        transform.setLatLngZoom({ 0, 0 }, 16);
+    }
+
+private:
+    // Whether all tiles are loaded and no placement is queued.
+    bool isIdle() {
+        idle = style->isLoaded() && style->workers.getStatistics().queued == 0 ? idle + 1 : 0;
+        return idle >= idleFrames;
+    }
+
+    void tick() override {
+        if (!started) {
+            update();
+            if (isIdle()) {
+                started = true;
+                start = style->workers.getStatistics();
+                transform.setGestureInProgress(gesture);
+            }
+        } else if (frame < rotationFrames) {
+            frame++;
+            transform.setAngle(frame * util::DEG2RAD);
+            update();
+        } else if (!stopped) {
+            stopped = true;
+            transform.setGestureInProgress(false);
+            update();
+        } else if (!isIdle()) {
+            update();
+        } else {
+            const Worker::Statistics end = style->workers.getStatistics();
+            Result result;
+            result.placements = end.placements - start.placements;
+            result.placementRun = end.placementRun - start.placementRun;
+            finish(result);
+        }
+    }
+
+    const bool gesture;
+
+    bool started = false;
+    bool stopped = false;
+    std::size_t idle = 0;
+    std::size_t frame = 0;
+    Worker::Statistics start;
+};
+
+} // namespace
+
+TEST(Benchmark, PlacementRotation) {
+    const Result exact = benchmark::runMapHarness<Rotation>(false);
+    const Result gesture = benchmark::runMapHarness<Rotation>(true);
+
+    benchmark::report("placement, exact, per frame", benchmark::milliseconds(exact.placementRun / rotationFrames), "ms");
+    benchmark::report("placement, exact, placements per frame", double(exact.placements) / rotationFrames, "");
+    benchmark::report("placement, rotation gesture, per frame", benchmark::milliseconds(gesture.placementRun / rotationFrames), "ms");
+    benchmark::report("placement, rotation gesture, placements per frame", double(gesture.placements) / rotationFrames, "");
+
+    // During the gesture, tiles are only placed again every few degrees.
+    EXPECT_LT(gesture.placements, exact.placements);
+}
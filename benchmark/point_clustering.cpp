@@ -0,0 +1,88 @@
+#include "util.hpp"
+
+#include <mbgl/annotation/point_cluster_index.hpp>
+#include <mbgl/map/tile_id.hpp>
+
+#include <random>
+#include <string>
+
+using namespace mbgl;
+
+namespace {
+
+// Points spread evenly over the contiguous United States.
+std::vector<LatLng> makePositions(std::size_t count) {
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> latitude(25, 49);
+    std::uniform_real_distribution<double> longitude(-125, -67);
+
+    std::vector<LatLng> positions;
+    positions.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        positions.emplace_back(latitude(generator), longitude(generator));
+    }
+    return positions;
+}
+
+// The z5 tiles that cover the points.
+std::vector<TileID> makeTiles() {
+    std::vector<TileID> tiles;
+    for (int32_t y = 10; y <= 13; y++) {
+        for (int32_t x = 4; x <= 10; x++) {
+            tiles.emplace_back(5, x, y, 5);
+        }
+    }
+    return tiles;
+}
+
+} // namespace
+
+TEST(Benchmark, PointClustering) {
+    const auto tiles = makeTiles();
+
+    for (const std::size_t count : { 10000, 100000, 1000000 }) {
+        const auto positions = makePositions(count);
+        const std::string name = std::to_string(count / 1000) + "k points";
+
+        const Duration load = benchmark::measure([&] {
+            PointClusterIndex index;
+            index.load(positions);
+        });
+
+        const Duration insert = benchmark::measure([&] {
+            PointClusterIndex index;
+            for (const auto& position : positions) {
+                index.insert(position);
+            }
+        });
+
+        PointClusterIndex index;
+        index.load(positions);
+
+        // Removes and adds back the first thousand points, like an app that moves some markers.
+        const std::size_t edits = 1000;
+        const Duration edit = benchmark::measure([&] {
+            for (std::size_t i = 0; i < edits; i++) {
+                index.remove(positions[i]);
+            }
+            for (std::size_t i = 0; i < edits; i++) {
+                index.insert(positions[i]);
+            }
+        });
+
+        std::size_t features = 0;
+        const Duration query = benchmark::measure([&] {
+            features = 0;
+            for (const auto& tile : tiles) {
+                features += index.getClusters(tile).size();
+            }
+        });
+
+        benchmark::report((name + ", load").c_str(), benchmark::milliseconds(load), "ms");
+        benchmark::report((name + ", insert one by one").c_str(), benchmark::milliseconds(insert), "ms");
+        benchmark::report((name + ", remove and insert, per point").c_str(), benchmark::nanoseconds(edit / (2 * edits)), "ns");
+        benchmark::report((name + ", clusters of a z5 tile").c_str(), benchmark::nanoseconds(query / tiles.size()) / 1000, "us");
+        benchmark::report((name + ", features in z5 tiles").c_str(), double(features), "");
+        benchmark::report((name + ", cells").c_str(), double(index.getStatistics().cells), "");
+    }
+}
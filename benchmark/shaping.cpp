@@ -0,0 +1,129 @@
+#include "util.hpp"
+
+#include <mbgl/style/value.hpp>
+#include <mbgl/text/font_stack.hpp>
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/util/utf.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+struct Label {
+    std::u32string text;
+    // Labels along lines aren't wrapped.
+    bool line;
+};
+
+// The labels of the label layers of the streets fixture tiles, one list per tile, in the order in
+// which SymbolBucket shapes them.
+std::vector<std::vector<Label>> loadLabels() {
+    const std::vector<std::pair<std::string, std::string>> layers = {
+        { "road_label", "name" }, { "poi_label", "name" }, { "housenum_label", "house_num" }
+    };
+
+    std::vector<std::vector<Label>> tiles;
+    for (const auto& tile : benchmark::loadStreetsTiles()) {
+        tiles.emplace_back();
+        for (const auto& layer : layers) {
+            auto tileLayer = tile->getLayer(layer.first);
+            if (!tileLayer) {
+                continue;
+            }
+            tileLayer->eachFeature([&] (const GeometryTileFeature& feature) {
+                auto value = feature.getValue(layer.second);
+                if (value) {
+                    const auto text = util::utf8_to_utf32::convert(toString(*value));
+                    if (!text.empty()) {
+                        tiles.back().push_back({ text, layer.first == "road_label" });
+                    }
+                }
+            });
+        }
+    }
+    return tiles;
+}
+
+// A font stack with glyphs of varying widths for all characters of the labels.
+FontStack makeFontStack(const std::vector<std::vector<Label>>& tiles) {
+    FontStack stack;
+    for (const auto& tile : tiles) {
+        for (const auto& label : tile) {
+            for (const char32_t character : label.text) {
+                SDFGlyph glyph;
+                glyph.id = character;
+                glyph.metrics.width = 8 + character % 8;
+                glyph.metrics.height = 20;
+                glyph.metrics.advance = glyph.metrics.width + 2;
+                stack.insert(character, glyph);
+            }
+        }
+    }
+    return stack;
+}
+
+// Shapes all labels like SymbolBucket does, with the layout properties of the streets style: 10 ems
+// wide, 1.2 ems high and centered. The keys are reused, so that they only allocate memory when a
+// label is longer than any before.
+template <typename Fn>
+void shapeAll(const std::vector<std::vector<Label>>& tiles, Fn&& shape) {
+    ShapingCache::Key point { "Open Sans Regular", {}, 240, 28.8, 0.5, 0.5, 0.5, 0, { 0, 0 } };
+    ShapingCache::Key line = point;
+    line.maxWidth = 0;
+
+    for (const auto& tile : tiles) {
+        for (const auto& label : tile) {
+            auto& key = label.line ? line : point;
+            key.text = label.text;
+            shape(key);
+        }
+    }
+}
+
+} // namespace
+
+TEST(Benchmark, ShapingCache) {
+    const auto tiles = loadLabels();
+    const FontStack stack = makeFontStack(tiles);
+
+    std::size_t labels = 0;
+    for (const auto& tile : tiles) {
+        labels += tile.size();
+    }
+    ASSERT_LT(0u, labels);
+
+    const Duration uncached = benchmark::measure([&] {
+        shapeAll(tiles, [&] (const ShapingCache::Key& key) {
+            stack.getShaping(key.text, key.maxWidth, key.lineHeight, key.horizontalAlign,
+                             key.verticalAlign, key.justify, key.spacing, key.translate);
+        });
+    });
+
+    // Every run starts with an empty cache, so only labels that repeat within and across the
+    // tiles hit it.
+    ShapingCache::Statistics cold;
+    const Duration cachedCold = benchmark::measure([&] {
+        ShapingCache cache;
+        shapeAll(tiles, [&] (const ShapingCache::Key& key) {
+            cache.get(key, stack);
+        });
+        cold = cache.getStatistics();
+    });
+
+    // The cache is kept between runs, like when tiles are parsed again after the style changed.
+    ShapingCache warmCache;
+    const Duration cachedWarm = benchmark::measure([&] {
+        shapeAll(tiles, [&] (const ShapingCache::Key& key) {
+            warmCache.get(key, stack);
+        });
+    });
+
+    const double hitRate = 100.0 * cold.hits / (cold.hits + cold.misses);
+
+    benchmark::report("shaping, uncached, per tile", benchmark::milliseconds(uncached / tiles.size()), "ms");
+    benchmark::report("shaping, empty cache, per tile", benchmark::milliseconds(cachedCold / tiles.size()), "ms");
+    benchmark::report("shaping, warm cache, per tile", benchmark::milliseconds(cachedWarm / tiles.size()), "ms");
+    benchmark::report("shaping, uncached, per label", benchmark::nanoseconds(uncached / labels) / 1000, "us");
+    benchmark::report("shaping, empty cache, per label", benchmark::nanoseconds(cachedCold / labels) / 1000, "us");
+    benchmark::report("shaping, empty cache, hit rate", hitRate, "%");
+}
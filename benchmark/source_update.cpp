@@ -0,0 +1,82 @@
+#include "util.hpp"
+
+#include <mbgl/util/math.hpp>
+
+#include <algorithm>
+
+using namespace mbgl;
+
+namespace {
+
+const std::size_t flightFrames = 300;
+const std::size_t staticFrames = 100;
+
+struct Timings {
+    std::vector<Duration> flight;
+    std::vector<Duration> still;
+};
+
+// Flies the camera along a scripted path and measures how long it takes the style to update its
+// sources in each frame, while tiles load and parse in the background.
+class FlyThrough : public benchmark::MapHarness<Timings> {
+public:
+    FlyThrough(View& view, FileSource& fileSource, std::function<void (Timings)> callback_)
+        : MapHarness(view, fileSource, callback_) {
+        setCamera(0);
+    }
+
+private:
+    // Pans east, then zooms in while panning, then pitches and rotates the camera.
+    void setCamera(std::size_t frame) {
+        const double t = double(frame) / flightFrames;
+        const double zoom = 14 + 3 * util::clamp((t - 1.0 / 3) * 3, 0.0, 1.0);
+        transform.setLatLngZoom({ 0, 0.5 * t }, zoom);
+        transform.setPitch(60 * util::clamp((t - 2.0 / 3) * 3, 0.0, 1.0));
+        transform.setAngle(M_PI * util::clamp((t - 2.0 / 3) * 3, 0.0, 1.0));
+    }
+
+    void tick() override {
+        if (!started) {
+            // Start flying once the initial viewport is completely loaded.
+            update();
+            started = style->isLoaded();
+        } else if (timings.flight.size() < flightFrames) {
+            setCamera(timings.flight.size() + 1);
+            timings.flight.push_back(update());
+        } else if (!settled) {
+            // Wait for the final viewport to load before measuring frames in which nothing changes.
+            update();
+            settled = style->isLoaded();
+        } else if (timings.still.size() < staticFrames) {
+            timings.still.push_back(update());
+        } else {
+            finish(std::move(timings));
+        }
+    }
+
+    bool started = false;
+    bool settled = false;
+    Timings timings;
+};
+
+Duration percentile(std::vector<Duration> durations, double p) {
+    std::sort(durations.begin(), durations.end());
+    return durations[std::min(durations.size() - 1, std::size_t(p * durations.size()))];
+}
+
+} // namespace
+
+TEST(Benchmark, SourceUpdateFlyThrough) {
+    const Timings timings = benchmark::runMapHarness<FlyThrough>();
+
+    ASSERT_EQ(flightFrames, timings.flight.size());
+    ASSERT_EQ(staticFrames, timings.still.size());
+
+    benchmark::report("source update, fly-through, p50", benchmark::milliseconds(percentile(timings.flight, 0.5)), "ms");
+    benchmark::report("source update, fly-through, p99", benchmark::milliseconds(percentile(timings.flight, 0.99)), "ms");
+    benchmark::report("source update, fly-through, max", benchmark::milliseconds(percentile(timings.flight, 1)), "ms");
+    benchmark::report("source update, static camera, p50", benchmark::milliseconds(percentile(timings.still, 0.5)), "ms");
+
+    // Frames in which the covering tiles don't change skip reconciliation entirely.
+    EXPECT_LE(percentile(timings.still, 0.5), percentile(timings.flight, 0.5));
+}
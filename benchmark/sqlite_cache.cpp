@@ -0,0 +1,184 @@
+#include "util.hpp"
+
+#include "sqlite_cache_impl.hpp"
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace mbgl;
+
+namespace {
+
+const char* const path = "test/fixtures/database/benchmark.db";
+
+// Roughly the number of tiles that arrive after zooming in quickly.
+const int tileCount = 200;
+
+void deleteDatabase() {
+    mkdir("test/fixtures/database", 0755);
+    for (const auto suffix : { "", "-wal", "-shm" }) {
+        unlink((std::string(path) + suffix).c_str());
+    }
+}
+
+Resource tile(int i) {
+    return { Resource::Tile, "http://example.com/tile/" + std::to_string(i) + ".pbf" };
+}
+
+std::shared_ptr<const Response> tileResponse() {
+    // Vector tiles are typically compressed already, so use data that doesn't compress well.
+    std::string data(16 * 1024, '\0');
+    uint32_t state = 1;
+    for (auto& c : data) {
+        state = state * 1103515245 + 12345;
+        c = char(state >> 24);
+    }
+
+    auto response = std::make_shared<Response>();
+    response->data = std::make_shared<std::string>(std::move(data));
+    return response;
+}
+
+// Stores all tiles and returns the number of puts per second, including the time it takes to commit
+// writes that are still queued.
+double putsPerSecond(const std::shared_ptr<const Response>& response) {
+    const TimePoint start = Clock::now();
+    {
+        SQLiteCache::Impl cache(path);
+        for (int i = 0; i < tileCount; i++) {
+            cache.put(tile(i), response);
+        }
+    }
+    return tileCount / std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+TEST(Benchmark, SQLiteCachePuts) {
+    const auto response = tileResponse();
+
+    // Without a RunLoop, every put is committed in its own transaction.
+    deleteDatabase();
+    const double unbatched = putsPerSecond(response);
+
+    deleteDatabase();
+    double batched;
+    {
+        util::RunLoop loop(uv_default_loop());
+        batched = putsPerSecond(response);
+    }
+    deleteDatabase();
+
+    benchmark::report("sqlite cache, puts in separate transactions", unbatched, "puts/s");
+    benchmark::report("sqlite cache, batched puts", batched, "puts/s");
+
+    EXPECT_GT(batched, unbatched);
+}
+
+TEST(Benchmark, SQLiteCacheGetLatencyDuringWrites) {
+    const auto response = tileResponse();
+
+    deleteDatabase();
+    {
+        util::RunLoop loop(uv_default_loop());
+        SQLiteCache::Impl cache(path);
+        for (int i = 0; i < tileCount; i++) {
+            cache.put(tile(i), response);
+        }
+    }
+
+    // Another connection keeps writing new tiles, one transaction at a time.
+    std::atomic<bool> done(false);
+    std::thread writer([&] {
+        SQLiteCache::Impl cache(path);
+        for (int i = tileCount; !done; i++) {
+            cache.put(tile(i), response);
+        }
+    });
+
+    std::vector<Duration> latencies;
+    std::size_t failed = 0;
+    {
+        SQLiteCache::Impl cache(path);
+        const TimePoint end = Clock::now() + std::chrono::seconds(1);
+        for (int i = 0; Clock::now() < end; i = (i + 1) % tileCount) {
+            const TimePoint start = Clock::now();
+            cache.get(tile(i), [&] (std::unique_ptr<Response> res) {
+                latencies.push_back(Clock::now() - start);
+                if (!res) {
+                    failed++;
+                }
+            });
+        }
+    }
+
+    done = true;
+    writer.join();
+    deleteDatabase();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&] (double p) {
+        return latencies[std::min(latencies.size() - 1, std::size_t(p * latencies.size()))];
+    };
+
+    benchmark::report("sqlite cache get during writes, p50 latency", benchmark::milliseconds(percentile(0.5)), "ms");
+    benchmark::report("sqlite cache get during writes, p99 latency", benchmark::milliseconds(percentile(0.99)), "ms");
+    benchmark::report("sqlite cache get during writes, failed reads", failed, "");
+
+    // Readers never have to wait for the writer with a write-ahead log.
+    EXPECT_EQ(0u, failed);
+}
+
+TEST(Benchmark, SQLiteCacheCompressedGets) {
+    // Decoded vector tiles compress to roughly half their size.
+    std::string data(32 * 1024, '\0');
+    uint32_t state = 1;
+    for (auto& c : data) {
+        state = state * 1103515245 + 12345;
+        c = char((state >> 24) & 0x0F);
+    }
+    auto response = std::make_shared<Response>();
+    response->data = std::make_shared<std::string>(std::move(data));
+
+    deleteDatabase();
+    {
+        SQLiteCache::Impl cache(path);
+        for (int i = 0; i < tileCount; i++) {
+            cache.put(tile(i), response);
+        }
+    }
+
+    SQLiteCache::Statistics statistics;
+    double getsPerSecond;
+    {
+        SQLiteCache::Impl cache(path);
+        const TimePoint start = Clock::now();
+        for (int i = 0; i < tileCount * 5; i++) {
+            cache.get(tile(i % tileCount), [] (std::unique_ptr<Response>) {});
+        }
+        getsPerSecond = tileCount * 5 / std::chrono::duration<double>(Clock::now() - start).count();
+        statistics = cache.getStatistics();
+    }
+    deleteDatabase();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    benchmark::report("sqlite cache, compressed gets", getsPerSecond, "gets/s");
+    benchmark::report("sqlite cache, bytes read per get", double(statistics.bytesRead) / statistics.hits, "bytes");
+    benchmark::report("sqlite cache, bytes copied per get", double(statistics.bytesCopied) / statistics.hits, "bytes");
+    // Kilobytes on Linux, bytes on OS X.
+    benchmark::report("sqlite cache, peak resident set size", usage.ru_maxrss, "");
+
+    // Every byte of a response is written once, straight from the stored data.
+    EXPECT_EQ(uint64_t(tileCount * 5), statistics.hits);
+    EXPECT_EQ(statistics.hits * response->data->size(), statistics.bytesCopied);
+}
@@ -0,0 +1,150 @@
+#ifndef MBGL_BENCHMARK_UTIL
+#define MBGL_BENCHMARK_UTIL
+
+#include <gtest/gtest.h>
+
+#include "../test/fixtures/mock_file_source.hpp"
+#include "../test/fixtures/mock_view.hpp"
+
+#include <mbgl/map/map_data.hpp>
+#include <mbgl/map/transform.hpp>
+#include <mbgl/map/vector_tile.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/texture_pool.hpp>
+#include <mbgl/util/thread.hpp>
+#include <mbgl/util/uv_detail.hpp>
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+namespace benchmark {
+
+// Runs the function repeatedly until the minimum duration has elapsed, and returns the average
+// duration of a single run.
+template <typename Fn>
+Duration measure(Fn&& fn, Duration minimum = std::chrono::milliseconds(500)) {
+    std::size_t runs = 0;
+    const TimePoint start = Clock::now();
+    Duration elapsed;
+    do {
+        fn();
+        runs++;
+        elapsed = Clock::now() - start;
+    } while (elapsed < minimum);
+    return elapsed / runs;
+}
+
+inline double nanoseconds(Duration duration) {
+    return std::chrono::duration<double, std::nano>(duration).count();
+}
+
+inline double milliseconds(Duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+inline void report(const char* name, double value, const char* unit) {
+    std::printf("[ BENCHMARK] %-52s %12.2f %s\n", name, value, unit);
+}
+
+// Reads fixture tiles of the streets source, by default a z0 tile and two neighbouring z15 tiles.
+inline std::vector<std::unique_ptr<VectorTile>> loadStreetsTiles(
+    const std::vector<std::string>& names = { "0-0-0", "15-17605-10749", "15-17605-10750" }) {
+    std::vector<std::unique_ptr<VectorTile>> tiles;
+    for (const auto& name : names) {
+        tiles.push_back(std::make_unique<VectorTile>(std::make_shared<std::string>(
+            util::read_file("test/fixtures/tiles/streets/" + name + ".vector.pbf"))));
+    }
+    return tiles;
+}
+
+// Renders the test style on the Map thread, one frame per tick of its run loop, without drawing.
+// Tiles load and parse in the background, just like they do in a running map. Benchmarks move the
+// camera in tick() and call finish() with their result once they are done.
+template <typename ResultType>
+class MapHarness : public Style::Observer {
+public:
+    using Result = ResultType;
+
+    MapHarness(View& view, FileSource& fileSource, std::function<void (Result)> callback_)
+        : data(MapMode::Continuous, GLContextMode::Unique, view.getPixelRatio()),
+          transform(view, ConstrainMode::HeightOnly),
+          timer(util::RunLoop::getLoop()),
+          callback(callback_) {
+        util::ThreadContext::setFileSource(&fileSource);
+
+        transform.resize({{ 1024, 768 }});
+
+        style = std::make_unique<Style>(data);
+        style->setJSON(util::read_file("test/fixtures/resources/style.json"), "");
+        style->setObserver(this);
+
+        timer.start(1, 1, [this] { tick(); });
+    }
+
+    // Style::Observer implementation.
+    void onTileDataChanged() override {}
+    void onResourceLoadingFailed(std::exception_ptr) override {}
+
+protected:
+    virtual void tick() = 0;
+
+    // Updates the style for the current time and camera, and returns how long that took.
+    Duration update() {
+        const TimePoint now = Clock::now();
+        data.setAnimationTime(now);
+        transform.updateTransitions(now);
+
+        style->update(transform.getState(), texturePool);
+        return Clock::now() - now;
+    }
+
+    void finish(Result result) {
+        timer.stop();
+        callback(std::move(result));
+    }
+
+    MapData data;
+    Transform transform;
+    TexturePool texturePool;
+    std::unique_ptr<Style> style;
+
+private:
+    uv::timer timer;
+    std::function<void (Result)> callback;
+};
+
+// Runs a MapHarness on a Map thread, with a mock view and file source, until it finishes. Additional
+// arguments are passed to the constructor of the harness.
+template <typename Harness, typename... Args>
+typename Harness::Result runMapHarness(Args&&... args) {
+    util::RunLoop loop(uv_default_loop());
+
+    MockView view;
+    MockFileSource fileSource(MockFileSource::Success, "");
+
+    typename Harness::Result result;
+    auto thread = std::make_unique<util::Thread<Harness>>(
+        util::ThreadContext{"Map", util::ThreadType::Map, util::ThreadPriority::Regular}, view, fileSource,
+        [&] (typename Harness::Result result_) {
+            result = std::move(result_);
+            loop.stop();
+        },
+        std::forward<Args>(args)...);
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+    thread.reset();
+
+    return result;
+}
+
+} // namespace benchmark
+} // namespace mbgl
+
+#endif
@@ -0,0 +1,100 @@
+#include "util.hpp"
+
+#include <mbgl/util/worker.hpp>
+#include <mbgl/util/work_request.hpp>
+#include <mbgl/util/thread.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <algorithm>
+
+using namespace mbgl;
+
+namespace {
+
+const std::size_t threadCount = 4;
+const std::size_t jobCount = 256;
+
+// Every 16th job is a heavy symbol tile; all others are cheap.
+Duration jobCost(std::size_t i) {
+    return i % 16 == 0 ? std::chrono::milliseconds(20) : std::chrono::microseconds(500);
+}
+
+void spin(Duration duration) {
+    const TimePoint end = Clock::now() + duration;
+    while (Clock::now() < end) {}
+}
+
+// Replicates the previous scheduling strategy: jobs are assigned round-robin to threads, each of
+// which has its own queue.
+class RoundRobinThread {
+public:
+    void run(Duration cost, std::function<void ()> callback) {
+        spin(cost);
+        callback();
+    }
+};
+
+Duration percentile(std::vector<Duration> latencies, double p) {
+    std::sort(latencies.begin(), latencies.end());
+    return latencies[std::min(latencies.size() - 1, std::size_t(p * latencies.size()))];
+}
+
+void reportLatencies(const std::string& name, const std::vector<Duration>& latencies) {
+    benchmark::report((name + ", p50 latency").c_str(), benchmark::milliseconds(percentile(latencies, 0.5)), "ms");
+    benchmark::report((name + ", p99 latency").c_str(), benchmark::milliseconds(percentile(latencies, 0.99)), "ms");
+    benchmark::report((name + ", max latency").c_str(), benchmark::milliseconds(percentile(latencies, 1)), "ms");
+}
+
+} // namespace
+
+TEST(Benchmark, WorkerSkewedLatency) {
+    std::vector<Duration> roundRobin(jobCount);
+    std::vector<Duration> shared(jobCount);
+
+    {
+        util::RunLoop loop(uv_default_loop());
+        const util::ThreadContext context = { "Worker", util::ThreadType::Worker, util::ThreadPriority::Low };
+        std::vector<std::unique_ptr<util::Thread<RoundRobinThread>>> threads;
+        for (std::size_t i = 0; i < threadCount; i++) {
+            threads.emplace_back(std::make_unique<util::Thread<RoundRobinThread>>(context));
+        }
+
+        std::vector<std::unique_ptr<WorkRequest>> requests;
+        std::size_t remaining = jobCount;
+        const TimePoint start = Clock::now();
+        for (std::size_t i = 0; i < jobCount; i++) {
+            requests.push_back(threads[i % threadCount]->invokeWithCallback(&RoundRobinThread::run, [&, i] {
+                roundRobin[i] = Clock::now() - start;
+                if (--remaining == 0) {
+                    loop.stop();
+                }
+            }, jobCost(i)));
+        }
+
+        uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+    }
+
+    {
+        util::RunLoop loop(uv_default_loop());
+        Worker worker(threadCount);
+
+        std::vector<std::unique_ptr<WorkRequest>> requests;
+        std::size_t remaining = jobCount;
+        const TimePoint start = Clock::now();
+        for (std::size_t i = 0; i < jobCount; i++) {
+            requests.push_back(worker.invoke(WorkPriority(), [i] { spin(jobCost(i)); }, [&, i] {
+                shared[i] = Clock::now() - start;
+                if (--remaining == 0) {
+                    loop.stop();
+                }
+            }));
+        }
+
+        uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+    }
+
+    reportLatencies("worker, round-robin", roundRobin);
+    reportLatencies("worker, shared queue", shared);
+
+    EXPECT_LT(percentile(shared, 0.99), percentile(roundRobin, 0.99));
+}
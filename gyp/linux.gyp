@@ -4,7 +4,7 @@
   ],
 
   'conditions': [
-    ['test', { 'includes': [ '../test/test.gypi' ] } ],
+    ['test', { 'includes': [ '../test/test.gypi', '../benchmark/benchmark.gypi' ] } ],
     ['render', { 'includes': [ '../bin/render.gypi' ] } ],
   ],
 }
@@ -3,6 +3,7 @@
     '../macosx/mapboxgl-app.gypi',
     '../linux/mapboxgl-app.gypi',
     '../test/test.gypi',
+    '../benchmark/benchmark.gypi',
     '../bin/render.gypi',
   ],
 }
@@ -155,6 +155,10 @@ public:
     void removeAnnotation(AnnotationID);
     void removeAnnotations(const AnnotationIDs&);
 
+    // Replaces nearby point annotations with a single marker at low zoom levels.
+    void setPointAnnotationClustering(bool);
+    bool getPointAnnotationClustering() const;
+
     AnnotationIDs getPointAnnotationsInBounds(const LatLngBounds&);
     LatLngBounds getBoundsForAnnotations(const AnnotationIDs&);
     double getTopOffsetPixelsForAnnotationSymbol(const std::string&);
@@ -164,9 +168,16 @@ public:
     void removeSprite(const std::string&);
 
     // Memory
-    void setSourceTileCacheSize(size_t);
+    // Sets the number of bytes that parsed tiles which are no longer visible may occupy in CPU
+    // and GPU memory. The budget is shared by all sources of the style.
+    void setTileCacheSize(size_t bytes);
     void onLowMemory();
 
+    // Sets the maximum number of tiles per source that are loaded ahead of time for the path and
+    // destination of an animated camera transition. 0 disables prefetching.
+    void setPrefetchTileBudget(uint16_t);
+    uint16_t getPrefetchTileBudget() const;
+
     // Debug
     void setDebug(bool value);
     void toggleDebug();
@@ -174,6 +185,8 @@ public:
     void setCollisionDebug(bool value);
     void toggleCollisionDebug();
     bool getCollisionDebug() const;
+    void setCollisionIndex(CollisionIndex);
+    CollisionIndex getCollisionIndex() const;
     bool isFullyLoaded() const;
     void dumpDebugLogs() const;
 
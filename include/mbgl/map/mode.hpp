@@ -26,6 +26,14 @@ enum class ConstrainMode : uint8_t {
     WidthAndHeight,
 };
 
+// The spatial index that symbol placement uses to find colliding labels. Both place symbols
+// identically; they only differ in speed. The R-tree is the default; Map::setCollisionIndex selects
+// the grid for comparison.
+enum class CollisionIndex : uint8_t {
+    Grid, // a uniform grid with boxes stored in flat arrays
+    RTree, // a dynamic R-tree
+};
+
 } // namespace mbgl
 
 #endif // MBGL_MAP_MODE
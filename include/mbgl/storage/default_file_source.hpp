@@ -4,6 +4,8 @@
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/file_cache.hpp>
 
+#include <cstdint>
+
 namespace mbgl {
 
 namespace util {
@@ -20,9 +22,38 @@ public:
 
     std::unique_ptr<FileRequest> request(const Resource&, Callback) override;
 
+    // Like request(), but the request starts out with the given priority instead of the default
+    // priority of its resource kind, so that it doesn't compete for a connection before its
+    // priority could be changed.
+    std::unique_ptr<FileRequest> request(const Resource&, RequestPriority, Callback);
+    void onLowMemory() override;
+
+    // Sets the number of bytes of response data that are kept in memory after all requests for
+    // them were cancelled, so that requesting them again doesn't have to go through the cache.
+    // Only used when there is a cache. A size of 0 disables the memory cache.
+    void setMemoryCacheSize(uint64_t size);
+
+    struct MemoryCacheStatistics {
+        struct Rate {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+        };
+
+        // Bytes of response data currently kept in memory.
+        uint64_t size = 0;
+        Rate tiles;
+        Rate glyphs;
+        Rate sprites;
+        Rate other;
+    };
+
+    // Blocks until the file source thread has processed all pending operations.
+    MemoryCacheStatistics getMemoryCacheStatistics() const;
+
 private:
     friend class DefaultFileRequest;
     void cancel(const Resource&, FileRequest*);
+    void setPriority(const Resource&, FileRequest*, RequestPriority);
 
     class Impl;
     const std::unique_ptr<util::Thread<Impl>> thread;
@@ -14,6 +14,10 @@ namespace mbgl {
 class FileRequest : private util::noncopyable {
 public:
     virtual ~FileRequest() = default;
+
+    // Changes the priority of a request that hasn't been sent yet, e.g. when a prefetched tile
+    // becomes visible. Requests start out with the default priority of their resource kind.
+    virtual void setPriority(RequestPriority) {}
 };
 
 class FileSource : private util::noncopyable {
@@ -28,6 +32,10 @@ public:
     // If the request is cancelled before the callback is executed, the callback will
     // not be executed.
     virtual std::unique_ptr<FileRequest> request(const Resource&, Callback) = 0;
+
+    // Releases memory that can be recovered, e.g. responses that are kept in memory. Called from
+    // Map::onLowMemory().
+    virtual void onLowMemory() {}
 };
 
 }
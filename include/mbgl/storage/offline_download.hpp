@@ -0,0 +1,177 @@
+#ifndef MBGL_STORAGE_OFFLINE_DOWNLOAD
+#define MBGL_STORAGE_OFFLINE_DOWNLOAD
+
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace mbgl {
+
+class FileSource;
+class FileRequest;
+class Source;
+
+// The area and zoom levels of a map that should be available offline.
+struct OfflineRegionDefinition {
+    std::string styleURL;
+    LatLngBounds bounds;
+    double minZoom = 0;
+    double maxZoom = 0;
+    float pixelRatio = 1;
+};
+
+// Requests every resource a map needs to display a region: the style, its sources, the tiles
+// covering the region at all zoom levels, the glyph ranges of all font stacks and the sprite.
+// Resources are loaded through the given FileSource. To seed a cache, pass a DefaultFileSource
+// that uses it: resources that are already cached and fresh are then not downloaded again, so
+// a download that was stopped, or that ran in another process, resumes where it left off.
+//
+// The cache evicts the least recently used resources once it is full, including the ones this
+// download stored earlier, so a region that doesn't fit would never be completely available
+// offline. Set the maximum cache size to have the download pause when the region exceeds it.
+//
+// All methods and observer callbacks run on the thread that created the download, which must
+// have a RunLoop.
+class OfflineDownload : private util::noncopyable {
+public:
+    struct Status {
+        // Whether the complete list of resources is known. Until then, the resource counts only
+        // include the resources that were found so far.
+        bool resolved = false;
+
+        uint64_t requiredResourceCount = 0;
+        uint64_t completedResourceCount = 0;
+        uint64_t failedResourceCount = 0;
+
+        // Bytes of response data of the completed resources.
+        uint64_t completedResourceSize = 0;
+
+        // The expected size of all resources. Once resolved, it extrapolates from a sample of
+        // tiles of every source and of glyph ranges, and gets more accurate as the download
+        // progresses.
+        uint64_t estimatedResourceSize = 0;
+
+        // Whether the estimated size exceeds the maximum cache size. Resources other than the
+        // ones needed to resolve the region aren't downloaded while it does.
+        bool exceedsCacheSize = false;
+
+        bool complete() const {
+            return resolved && completedResourceCount + failedResourceCount == requiredResourceCount;
+        }
+    };
+
+    class Observer {
+    public:
+        virtual ~Observer() = default;
+
+        // Called once the complete list of resources and the size estimate are known, before
+        // any resources other than the sampled ones are downloaded.
+        virtual void onResolved(const Status&) {}
+
+        virtual void onStatusChanged(const Status&) = 0;
+
+        // Failed resources are counted, but don't stop the download.
+        virtual void onResourceError(const Resource&, const Response::Error&) {}
+    };
+
+    OfflineDownload(FileSource&, OfflineRegionDefinition, Observer&);
+    ~OfflineDownload();
+
+    // Loads the style and its sources to find all resources of the region and to estimate their
+    // size. Calls Observer::onResolved() when done.
+    void resolve();
+
+    // Downloads all resources, resolving them first if necessary.
+    void start();
+
+    // Cancels all downloads in progress. They are requested again when the download is started
+    // again.
+    void stop();
+
+    // The number of requests that may be in progress at the same time. Defaults to 16.
+    void setMaximumConcurrentRequests(std::size_t);
+
+    // The maximum size of the cache that the download seeds, in bytes. 0, the default, disables
+    // the check.
+    void setMaximumCacheSize(uint64_t);
+
+    Status getStatus() const {
+        return status;
+    }
+
+private:
+    struct Entry {
+        Resource resource;
+        // Resources of the same group, e.g. tiles of one source, have a similar size.
+        std::size_t group;
+    };
+
+    struct Group {
+        uint64_t count = 0;
+        uint64_t completedCount = 0;
+        uint64_t completedSize = 0;
+    };
+
+    struct Fetch {
+        std::size_t entry;
+        bool resolving;
+        std::unique_ptr<FileRequest> request;
+    };
+
+    std::size_t addGroup();
+    std::size_t addResource(Resource, std::size_t group);
+    void enumerate();
+
+    void dispatch();
+    void cancelDownloads();
+    void fetch(std::size_t entry, bool resolving);
+    void finish(std::size_t entry, bool resolving, const Response&);
+    void loadStyle(const std::string& json);
+    void loadSource(Source&, const std::string& json);
+    void updateEstimate();
+
+    FileSource& fileSource;
+    const OfflineRegionDefinition definition;
+    Observer& observer;
+
+    bool resolveRequested = false;
+    bool downloading = false;
+    std::size_t maximumConcurrentRequests = 16;
+    uint64_t maximumCacheSize = 0;
+
+    std::vector<Entry> entries;
+    std::vector<Group> groups;
+    std::unordered_set<std::string> urls;
+
+    // The style and TileJSON documents, and the sampled resources, are requested while
+    // resolving. Everything else is requested in order once resolved.
+    std::deque<std::size_t> resolveQueue;
+    std::deque<std::size_t> downloadQueue;
+    std::size_t pendingResolves = 0;
+    bool enumerated = false;
+
+    std::vector<std::unique_ptr<Source>> sources;
+    std::unordered_map<std::size_t, Source*> sourceEntries;
+    std::string glyphURL;
+    std::string spriteURL;
+    std::unordered_set<std::string> fontStacks;
+
+    uint64_t nextFetch = 0;
+    std::unordered_map<uint64_t, Fetch> fetches;
+    bool dispatching = false;
+
+    Status status;
+};
+
+} // namespace mbgl
+
+#endif
@@ -1,11 +1,20 @@
 #ifndef MBGL_STORAGE_RESOURCE
 #define MBGL_STORAGE_RESOURCE
 
+#include <cstdint>
 #include <string>
 #include <functional>
 
 namespace mbgl {
 
+// Requests of a lower class are sent to the network first when the number of concurrent
+// requests is limited.
+enum class RequestPriority : uint8_t {
+    Required, // Styles, sources, and tiles that cover the viewport.
+    Resource, // Glyphs and sprites.
+    Prefetch, // Tiles that don't cover the viewport yet.
+};
+
 struct Resource {
     enum Kind : uint8_t {
         Unknown = 0,
@@ -24,6 +33,17 @@ struct Resource {
         return kind == res.kind && url == res.url;
     }
 
+    inline RequestPriority defaultPriority() const {
+        switch (kind) {
+        case Glyphs:
+        case SpriteImage:
+        case SpriteJSON:
+            return RequestPriority::Resource;
+        default:
+            return RequestPriority::Required;
+        }
+    }
+
     struct Hash {
         std::size_t operator()(Resource const& r) const {
             return std::hash<std::string>()(r.url) ^ (std::hash<uint8_t>()(r.kind) << 1);
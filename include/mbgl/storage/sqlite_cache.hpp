@@ -3,6 +3,7 @@
 
 #include <mbgl/storage/file_cache.hpp>
 
+#include <cstdint>
 #include <string>
 
 namespace mbgl {
@@ -20,6 +21,28 @@ public:
     std::unique_ptr<WorkRequest> get(const Resource &resource, Callback callback) override;
     void put(const Resource &resource, std::shared_ptr<const Response> response, Hint hint) override;
 
+    // Sets the number of bytes the cache may store. Once the cache grows beyond this size, it
+    // evicts the least recently used tiles first, and styles and glyphs last. A size of 0 disables
+    // eviction.
+    void setMaximumCacheSize(uint64_t size);
+
+    struct Statistics {
+        // Bytes of response data currently stored.
+        uint64_t size = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictedBytes = 0;
+
+        // Bytes of stored data read from the database for hits, and bytes of response data built
+        // from them. Responses are copied or inflated out of SQLite's buffer in a single pass, so
+        // bytesCopied / hits is the number of bytes copied per load.
+        uint64_t bytesRead = 0;
+        uint64_t bytesCopied = 0;
+    };
+
+    // Blocks until the cache thread has processed all pending operations.
+    Statistics getStatistics() const;
+
     class Impl;
 
 private:
@@ -49,8 +49,13 @@ struct LatLngBounds {
     inline LatLngBounds(const LatLng& sw_, const LatLng& ne_)
         : sw(sw_), ne(ne_) {}
 
+    // Constructs a LatLngBounds object that covers the whole world.
+    static inline LatLngBounds world() {
+        return { { -90, -180 }, { 90, 180 } };
+    }
+
     static inline LatLngBounds getExtendable() {
-        LatLngBounds bounds;
+        LatLngBounds bounds = world();
         return { bounds.ne, bounds.sw };
     }
 
@@ -78,15 +78,8 @@ NativeMapView::NativeMapView(JNIEnv *env, jobject obj_, float pixelRatio_, int a
     fileSource = std::make_unique<mbgl::DefaultFileSource>(fileCache.get());
     map = std::make_unique<mbgl::Map>(*this, *fileSource, MapMode::Continuous);
 
-    float zoomFactor   = map->getMaxZoom() - map->getMinZoom() + 1;
-    float cpuFactor    = availableProcessors;
-    float memoryFactor = static_cast<float>(totalMemory) / 1000.0f / 1000.0f / 1000.0f;
-    float sizeFactor   = (static_cast<float>(map->getWidth())  / mbgl::util::tileSize) *
-                         (static_cast<float>(map->getHeight()) / mbgl::util::tileSize);
-
-    size_t cacheSize = zoomFactor * cpuFactor * memoryFactor * sizeFactor * 0.5f;
-
-    map->setSourceTileCacheSize(cacheSize);
+    // Tiles that are no longer visible may keep up to 1/32 of the device memory.
+    map->setTileCacheSize(totalMemory / 32);
 
     map->pause();
 }
@@ -9,12 +9,271 @@
 #include <uv.h>
 #include "uv_zip.h"
 
+#include <zlib.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <map>
+#include <mutex>
 #include <cassert>
+#include <cstring>
+#include <ctime>
 #include <forward_list>
+#include <unordered_map>
 
 namespace mbgl {
 
+// A zip archive that is mapped into memory, with an index of its central directory. Stored
+// entries are copied straight out of the mapping, and deflated entries are inflated into the
+// response buffer, without going through libzip. Archives and entries this doesn't support
+// (ZIP64, encryption, other compression methods) are read with libzip instead.
+class ZipArchive {
+public:
+    enum class Result : uint8_t {
+        Found,
+        NotFound,
+        Unsupported,
+    };
+
+    explicit ZipArchive(const std::string& path);
+    ~ZipArchive();
+
+    // May be called from any thread. The archive is mapped and indexed by the first call.
+    Result read(const std::string& name, Response&);
+
+private:
+    struct Entry {
+        uint32_t index;
+        uint16_t method;
+        uint16_t flags;
+        uint32_t crc;
+        uint32_t compressedSize;
+        uint32_t size;
+        uint32_t localHeaderOffset;
+        int64_t modified;
+    };
+
+    bool load();
+    bool loadIndex();
+    const char* entryData(const Entry&) const;
+
+    const std::string path;
+    std::once_flag loaded;
+    bool valid = false;
+
+    const char* data = nullptr;
+    std::size_t size = 0;
+    std::unordered_map<std::string, Entry> entries;
+};
+
+namespace {
+
+const uint32_t localHeaderSignature = 0x04034B50;
+const uint32_t centralHeaderSignature = 0x02014B50;
+const uint32_t endOfCentralDirectorySignature = 0x06054B50;
+
+const std::size_t localHeaderSize = 30;
+const std::size_t centralHeaderSize = 46;
+const std::size_t endOfCentralDirectorySize = 22;
+
+const uint16_t methodStored = 0;
+const uint16_t methodDeflated = 8;
+const uint16_t flagEncrypted = 0x0001;
+
+uint16_t read16(const char* p) {
+    const auto u = reinterpret_cast<const uint8_t*>(p);
+    return uint16_t(u[0] | (u[1] << 8));
+}
+
+uint32_t read32(const char* p) {
+    const auto u = reinterpret_cast<const uint8_t*>(p);
+    return uint32_t(u[0]) | (uint32_t(u[1]) << 8) | (uint32_t(u[2]) << 16) | (uint32_t(u[3]) << 24);
+}
+
+// Converts an MS-DOS date and time in local time, the way libzip does.
+int64_t dosTime(uint16_t time, uint16_t date) {
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    tm.tm_isdst = -1;
+    tm.tm_year = ((date >> 9) & 127) + 1980 - 1900;
+    tm.tm_mon = ((date >> 5) & 15) - 1;
+    tm.tm_mday = date & 31;
+    tm.tm_hour = (time >> 11) & 31;
+    tm.tm_min = (time >> 5) & 63;
+    tm.tm_sec = (time << 1) & 62;
+    return mktime(&tm);
+}
+
+} // namespace
+
+ZipArchive::ZipArchive(const std::string& path_) : path(path_) {
+}
+
+ZipArchive::~ZipArchive() {
+    if (data) {
+        munmap(const_cast<char*>(data), size);
+    }
+}
+
+bool ZipArchive::load() {
+    std::call_once(loaded, [this] {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapping = mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            if (mapping != MAP_FAILED) {
+                data = reinterpret_cast<const char*>(mapping);
+                size = std::size_t(info.st_size);
+            }
+        }
+
+        // The mapping stays valid after the file is closed.
+        close(fd);
+
+        valid = data && loadIndex();
+    });
+
+    return valid;
+}
+
+bool ZipArchive::loadIndex() {
+    if (size < endOfCentralDirectorySize) {
+        return false;
+    }
+
+    // The end of central directory record is followed by a comment of up to 64 KB.
+    const char* eocd = nullptr;
+    const std::size_t maxCommentSize = 0xFFFF;
+    const std::size_t last = size - endOfCentralDirectorySize;
+    const std::size_t first = last > maxCommentSize ? last - maxCommentSize : 0;
+    for (std::size_t offset = last + 1; offset-- > first;) {
+        if (read32(data + offset) == endOfCentralDirectorySignature) {
+            eocd = data + offset;
+            break;
+        }
+    }
+    if (!eocd) {
+        return false;
+    }
+
+    const uint16_t count = read16(eocd + 10);
+    const uint32_t directorySize = read32(eocd + 12);
+    const uint32_t directoryOffset = read32(eocd + 16);
+    if (count == 0xFFFF || directoryOffset == 0xFFFFFFFF ||
+        uint64_t(directoryOffset) + directorySize > size) {
+        // ZIP64 archive, or a corrupt one.
+        return false;
+    }
+
+    entries.reserve(count);
+    const char* p = data + directoryOffset;
+    const char* const end = p + directorySize;
+    for (uint32_t i = 0; i < count; i++) {
+        if (end - p < std::ptrdiff_t(centralHeaderSize) || read32(p) != centralHeaderSignature) {
+            return false;
+        }
+
+        const uint16_t nameLength = read16(p + 28);
+        const std::size_t recordSize = centralHeaderSize + nameLength + read16(p + 30) + read16(p + 32);
+        if (std::size_t(end - p) < recordSize) {
+            return false;
+        }
+
+        Entry entry;
+        entry.index = i;
+        entry.flags = read16(p + 8);
+        entry.method = read16(p + 10);
+        entry.modified = dosTime(read16(p + 12), read16(p + 14));
+        entry.crc = read32(p + 16);
+        entry.compressedSize = read32(p + 20);
+        entry.size = read32(p + 24);
+        entry.localHeaderOffset = read32(p + 42);
+        entries.emplace(std::string(p + centralHeaderSize, nameLength), entry);
+
+        p += recordSize;
+    }
+
+    return true;
+}
+
+const char* ZipArchive::entryData(const Entry& entry) const {
+    // The local header repeats the name, but its extra field may differ from the central one.
+    const std::size_t offset = entry.localHeaderOffset;
+    if (offset + localHeaderSize > size || read32(data + offset) != localHeaderSignature) {
+        return nullptr;
+    }
+
+    const std::size_t dataOffset = offset + localHeaderSize + read16(data + offset + 26) + read16(data + offset + 28);
+    if (dataOffset + entry.compressedSize > size) {
+        return nullptr;
+    }
+
+    return data + dataOffset;
+}
+
+ZipArchive::Result ZipArchive::read(const std::string& name, Response& response) {
+    if (!load()) {
+        return Result::Unsupported;
+    }
+
+    auto it = entries.find(name);
+    if (it == entries.end()) {
+        return Result::NotFound;
+    }
+
+    const Entry& entry = it->second;
+    if ((entry.flags & flagEncrypted) || (entry.method != methodStored && entry.method != methodDeflated)) {
+        return Result::Unsupported;
+    }
+
+    const char* compressed = entryData(entry);
+    if (!compressed) {
+        return Result::Unsupported;
+    }
+
+    auto result = std::make_shared<std::string>();
+    if (entry.method == methodStored) {
+        result->assign(compressed, entry.compressedSize);
+    } else {
+        // Inflate the raw deflate stream straight into the response buffer, whose size is known
+        // from the central directory.
+        result->resize(entry.size);
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+            return Result::Unsupported;
+        }
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed));
+        stream.avail_in = entry.compressedSize;
+        stream.next_out = reinterpret_cast<Bytef*>(&(*result)[0]);
+        stream.avail_out = entry.size;
+        const int code = inflate(&stream, Z_FINISH);
+        const bool complete = code == Z_STREAM_END && stream.total_out == entry.size;
+        inflateEnd(&stream);
+
+        if (!complete) {
+            return Result::Unsupported;
+        }
+    }
+
+    if (crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(result->data()), uInt(result->size())) != entry.crc) {
+        return Result::Unsupported;
+    }
+
+    response.data = std::move(result);
+    response.modified = entry.modified;
+    response.etag = std::to_string(entry.index);
+    return Result::Found;
+}
+
 class AssetZipContext : public AssetContextBase {
 public:
     explicit AssetZipContext(uv_loop_t *loop);
@@ -28,6 +287,11 @@ public:
     uv_zip_t *getHandle(const std::string &path);
     void returnHandle(const std::string &path, uv_zip_t *zip);
 
+    std::shared_ptr<ZipArchive> getArchive(const std::string &path);
+
+    // Archives are mapped and indexed once, and shared with the requests that read from them.
+    std::map<std::string, std::shared_ptr<ZipArchive>> archives;
+
     // A list of resuable uv_zip handles to avoid creating and destroying them all the time.
     std::map<std::string, std::forward_list<uv_zip_t *>> handles;
     uv_loop_t *loop;
@@ -51,6 +315,14 @@ void AssetZipContext::returnHandle(const std::string &path, uv_zip_t *zip) {
     handles[path].push_front(zip);
 }
 
+std::shared_ptr<ZipArchive> AssetZipContext::getArchive(const std::string &path) {
+    auto &archive = archives[path];
+    if (!archive) {
+        archive = std::make_shared<ZipArchive>(path);
+    }
+    return archive;
+}
+
 AssetZipContext::~AssetZipContext() {
     // Close all zip handles
     for (auto &list : handles) {
@@ -81,7 +353,15 @@ private:
     std::unique_ptr<Response> response;
     uv_buf_t buffer;
 
+    const std::shared_ptr<ZipArchive> archive;
+    ZipArchive::Result result = ZipArchive::Result::Unsupported;
+    uv_work_t work;
+
 private:
+    static void readIndexed(uv_work_t *req);
+    static void afterReadIndexed(uv_work_t *req, int status);
+
+    void readWithLibzip();
     void openZipArchive();
     void archiveOpened(uv_zip_t *zip);
     void fileStated(uv_zip_t *zip);
@@ -104,7 +384,41 @@ AssetRequest::AssetRequest(AssetZipContext& context_, const Resource& resource_,
     : RequestBase(resource_, callback_),
       context(context_),
       root(assetRoot_),
-      path(std::string { "assets/" } + resource.url.substr(8)) {
+      path(std::string { "assets/" } + resource.url.substr(8)),
+      archive(context.getArchive(root)) {
+    work.data = this;
+    uv_queue_work(context.loop, &work, readIndexed, afterReadIndexed);
+}
+
+AssetRequest::~AssetRequest() {
+    MBGL_VERIFY_THREAD(tid);
+}
+
+void AssetRequest::readIndexed(uv_work_t *req) {
+    auto impl = reinterpret_cast<AssetRequest *>(req->data);
+    impl->response = std::make_unique<Response>();
+    impl->result = impl->archive->read(impl->path, *impl->response);
+}
+
+void AssetRequest::afterReadIndexed(uv_work_t *req, int) {
+    auto impl = reinterpret_cast<AssetRequest *>(req->data);
+    MBGL_VERIFY_THREAD(impl->tid);
+
+    if (impl->cancelled) {
+        delete impl;
+    } else if (impl->result == ZipArchive::Result::Found) {
+        impl->notify(std::move(impl->response));
+        delete impl;
+    } else if (impl->result == ZipArchive::Result::NotFound) {
+        impl->notifyError("No such file", Response::Error::Reason::NotFound);
+        delete impl;
+    } else {
+        impl->response.reset();
+        impl->readWithLibzip();
+    }
+}
+
+void AssetRequest::readWithLibzip() {
     auto zip = context.getHandle(root);
     if (zip) {
         archiveOpened(zip);
@@ -113,10 +427,6 @@ AssetRequest::AssetRequest(AssetZipContext& context_, const Resource& resource_,
     }
 }
 
-AssetRequest::~AssetRequest() {
-    MBGL_VERIFY_THREAD(tid);
-}
-
 void AssetRequest::openZipArchive() {
     uv_fs_t *req = new uv_fs_t();
     req->data = this;
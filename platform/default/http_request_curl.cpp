@@ -18,6 +18,8 @@
 
 #include <queue>
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <cassert>
 #include <cstring>
 #include <cstdio>
@@ -44,6 +46,33 @@ namespace mbgl {
 
 class HTTPCURLRequest;
 
+namespace {
+
+// Limits the number of transfers that run at the same time, so that a request with a high
+// priority never has to wait for hundreds of transfers that were started before it.
+const std::size_t maxActiveRequests = 20;
+
+// Without multiplexing, every transfer to a host needs a connection of its own.
+const std::size_t maxActiveRequestsPerHost = 6;
+const std::size_t maxMultiplexedRequestsPerHost = 16;
+
+// Prefetch requests leave some of the transfers, overall and to each host, to requests with a
+// higher priority. Otherwise, a required request that is made after the prefetch requests were
+// started would have to wait until one of them completes.
+const std::size_t reservedActiveRequests = 4;
+const std::size_t reservedActiveRequestsPerHost = 2;
+
+std::string hostOf(const std::string& url) {
+    const size_t begin = url.find("://");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    const size_t end = url.find('/', begin + 3);
+    return url.substr(begin + 3, end == std::string::npos ? std::string::npos : end - begin - 3);
+}
+
+} // namespace
+
 class HTTPCURLContext : public HTTPContextBase {
     MBGL_STORE_THREAD(tid)
 
@@ -65,6 +94,17 @@ public:
     void returnHandle(CURL *handle);
     void checkMultiInfo();
 
+    // Queues a request until it can be started without exceeding the connection limits.
+    void enqueue(HTTPCURLRequest*);
+    void dequeue(HTTPCURLRequest*);
+    void setPriority(HTTPCURLRequest*, RequestPriority);
+
+    // Called when an active request completed or was cancelled.
+    void finish(HTTPCURLRequest*);
+
+    // Starts queued requests in the order of their priority, as long as the limits allow it.
+    void dispatch();
+
     uv_loop_t *loop = nullptr;
 
     // Used as the CURL timer function to periodically check for socket updates.
@@ -80,6 +120,24 @@ public:
     // A queue that we use for storing resuable CURL easy handles to avoid creating and destroying
     // them all the time.
     std::queue<CURL *> handles;
+
+    // Whether requests to the same host can share a connection with HTTP/2.
+    bool multiplexing = false;
+
+    struct RunsFirst {
+        bool operator()(const HTTPCURLRequest*, const HTTPCURLRequest*) const;
+    };
+
+    // Requests that haven't been added to the multi handle yet.
+    std::set<HTTPCURLRequest*, RunsFirst> queue;
+    uint64_t sequence = 0;
+
+    std::size_t active = 0;
+    std::unordered_map<std::string, std::size_t> activePerHost;
+
+    // Defers starting requests to the next loop iteration, so that all requests made in the same
+    // iteration are started in the order of their priority.
+    std::unique_ptr<uv::async> dispatchAsync;
 };
 
 class HTTPCURLRequest : public HTTPRequestBase {
@@ -94,10 +152,16 @@ public:
     ~HTTPCURLRequest();
 
     void cancel() final;
+    void setPriority(RequestPriority) final;
 
     void handleResult(CURLcode code);
 
 private:
+    friend class HTTPCURLContext;
+
+    // Adds the request to the multi handle.
+    void start();
+
     static size_t headerCallback(char *const buffer, const size_t size, const size_t nmemb, void *userp);
     static size_t writeCallback(void *const contents, const size_t size, const size_t nmemb, void *userp);
 
@@ -114,6 +178,13 @@ private:
     curl_slist *headers = nullptr;
 
     char error[CURL_ERROR_SIZE];
+
+    RequestPriority priority;
+    uint64_t sequence = 0;
+    const std::string host;
+
+    // Whether the request was added to the multi handle.
+    bool active = false;
 };
 
 
@@ -172,6 +243,16 @@ HTTPCURLContext::HTTPCURLContext(uv_loop_t *loop_)
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, this));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, startTimeout));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERDATA, this));
+
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (43) << 8 | 0) // Multiplexing was added in 7.43.0
+    if (curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2) {
+        multiplexing = true;
+        handleError(curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX));
+    }
+#endif
+
+    dispatchAsync = std::make_unique<uv::async>(loop, [this] { dispatch(); });
+    dispatchAsync->unref();
 }
 
 HTTPCURLContext::~HTTPCURLContext() {
@@ -190,6 +271,76 @@ HTTPCURLContext::~HTTPCURLContext() {
     uv::close(timeout);
 }
 
+bool HTTPCURLContext::RunsFirst::operator()(const HTTPCURLRequest* a, const HTTPCURLRequest* b) const {
+    if (a->priority != b->priority) {
+        return a->priority < b->priority;
+    }
+    return a->sequence < b->sequence;
+}
+
+void HTTPCURLContext::enqueue(HTTPCURLRequest* request) {
+    request->sequence = sequence++;
+    queue.insert(request);
+    dispatchAsync->send();
+}
+
+void HTTPCURLContext::dequeue(HTTPCURLRequest* request) {
+    queue.erase(request);
+}
+
+void HTTPCURLContext::setPriority(HTTPCURLRequest* request, RequestPriority priority) {
+    if (request->active) {
+        // The transfer is in progress already.
+        request->priority = priority;
+        return;
+    }
+
+    // The position in the queue depends on the priority, so it has to be reinserted.
+    queue.erase(request);
+    request->priority = priority;
+    queue.insert(request);
+}
+
+void HTTPCURLContext::finish(HTTPCURLRequest* request) {
+    assert(active > 0);
+    active--;
+
+    auto it = activePerHost.find(request->host);
+    if (it != activePerHost.end() && --it->second == 0) {
+        activePerHost.erase(it);
+    }
+
+    if (!queue.empty()) {
+        dispatchAsync->send();
+    }
+}
+
+void HTTPCURLContext::dispatch() {
+    MBGL_VERIFY_THREAD(tid);
+    const std::size_t maxPerHost = multiplexing ? maxMultiplexedRequestsPerHost : maxActiveRequestsPerHost;
+
+    for (auto it = queue.begin(); it != queue.end();) {
+        HTTPCURLRequest* request = *it;
+        const bool prefetch = request->priority == RequestPriority::Prefetch;
+        if (active >= (prefetch ? maxActiveRequests - reservedActiveRequests : maxActiveRequests)) {
+            // The queue is ordered by priority, so the remaining requests can't be started either.
+            break;
+        }
+
+        std::size_t& perHost = activePerHost[request->host];
+        if (perHost >= (prefetch ? maxPerHost - reservedActiveRequestsPerHost : maxPerHost)) {
+            // Requests to other hosts may still be started.
+            ++it;
+            continue;
+        }
+
+        it = queue.erase(it);
+        perHost++;
+        active++;
+        request->start();
+    }
+}
+
 HTTPRequestBase* HTTPCURLContext::createRequest(const Resource& resource,
                                             RequestBase::Callback callback,
                                             uv_loop_t* loop_,
@@ -415,7 +566,9 @@ HTTPCURLRequest::HTTPCURLRequest(HTTPCURLContext* context_, const Resource& reso
     : HTTPRequestBase(resource_, callback_),
       context(context_),
       existingResponse(response_),
-      handle(context->getHandle()) {
+      handle(context->getHandle()),
+      priority(resource_.defaultPriority()),
+      host(hostOf(resource_.url)) {
     // Zero out the error buffer.
     memset(error, 0, sizeof(error));
 
@@ -457,15 +610,28 @@ HTTPCURLRequest::HTTPCURLRequest(HTTPCURLContext* context_, const Resource& reso
 #endif
     handleError(curl_easy_setopt(handle, CURLOPT_USERAGENT, "MapboxGL/1.0"));
     handleError(curl_easy_setopt(handle, CURLOPT_SHARE, context->share));
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (47) << 8 | 0) // CURL_HTTP_VERSION_2TLS was added in 7.47.0
+    if (context->multiplexing) {
+        // Use HTTP/2 where the server supports it, and wait for an existing connection to the
+        // host instead of opening another one.
+        handleError(curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS));
+        handleError(curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L));
+    }
+#endif
 
-    // Start requesting the information.
-    handleError(curl_multi_add_handle(context->multi, handle));
+    // Start requesting the information as soon as the connection limits allow it.
+    context->enqueue(this);
 }
 
 HTTPCURLRequest::~HTTPCURLRequest() {
     MBGL_VERIFY_THREAD(tid);
 
-    handleError(curl_multi_remove_handle(context->multi, handle));
+    if (active) {
+        handleError(curl_multi_remove_handle(context->multi, handle));
+        context->finish(this);
+    } else {
+        context->dequeue(this);
+    }
     context->returnHandle(handle);
     handle = nullptr;
 
@@ -479,6 +645,17 @@ void HTTPCURLRequest::cancel() {
    delete this;
 }
 
+void HTTPCURLRequest::setPriority(RequestPriority priority_) {
+    MBGL_VERIFY_THREAD(tid);
+    context->setPriority(this, priority_);
+}
+
+void HTTPCURLRequest::start() {
+    MBGL_VERIFY_THREAD(tid);
+    active = true;
+    handleError(curl_multi_add_handle(context->multi, handle));
+}
+
 // This function is called when we have new data for a request. We just append it to the string
 // containing the previous data.
 size_t HTTPCURLRequest::writeCallback(void *const contents, const size_t size, const size_t nmemb, void *userp) {
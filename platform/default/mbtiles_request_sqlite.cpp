@@ -0,0 +1,322 @@
+#include <mbgl/storage/mbtiles_context_base.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/url.hpp>
+#include <mbgl/util/util.hpp>
+
+#include "sqlite3.hpp"
+#include <sqlite3.h>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <uv.h>
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+namespace {
+
+const std::string protocol = "mbtiles://";
+
+// Archives may be read by all threads of the libuv thread pool at once. Connections beyond this
+// number are closed when they are returned rather than kept around.
+const std::size_t maxIdleConnections = 4;
+
+// A read-only connection to an archive, with the tile lookup prepared once.
+struct Connection {
+    Connection(const std::string& path)
+        : db(path, mapbox::sqlite::ReadOnly | mapbox::sqlite::NoMutex),
+          tileStmt(db.prepare("SELECT `tile_data` FROM `tiles` "
+                              "WHERE `zoom_level` = ? AND `tile_column` = ? AND `tile_row` = ?")) {
+    }
+
+    mapbox::sqlite::Database db;
+    mapbox::sqlite::Statement tileStmt;
+};
+
+// Idle connections by archive path. A connection is only used by one request at a time.
+class ConnectionPool {
+public:
+    std::unique_ptr<Connection> acquire(const std::string& path) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto& list = idle[path];
+            if (!list.empty()) {
+                auto connection = std::move(list.back());
+                list.pop_back();
+                return connection;
+            }
+        }
+        return std::make_unique<Connection>(path);
+    }
+
+    void release(const std::string& path, std::unique_ptr<Connection> connection) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& list = idle[path];
+        if (list.size() < maxIdleConnections) {
+            list.push_back(std::move(connection));
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, std::vector<std::unique_ptr<Connection>>> idle;
+};
+
+bool isGzip(const mapbox::sqlite::Blob& blob) {
+    return blob.size >= 2 && uint8_t(blob.data[0]) == 0x1F && uint8_t(blob.data[1]) == 0x8B;
+}
+
+// Parses a comma separated list of numbers, like the `bounds` and `center` metadata values.
+std::vector<double> parseNumbers(const std::string& value) {
+    std::vector<double> result;
+    std::istringstream stream(value);
+    std::string number;
+    while (std::getline(stream, number, ',')) {
+        char* end = nullptr;
+        const double parsed = std::strtod(number.c_str(), &end);
+        if (end == number.c_str()) {
+            return {};
+        }
+        result.push_back(parsed);
+    }
+    return result;
+}
+
+} // namespace
+
+class MBTilesRequest : public RequestBase {
+    MBGL_STORE_THREAD(tid)
+
+public:
+    MBTilesRequest(std::shared_ptr<ConnectionPool>, const Resource&, Callback, uv_loop_t*);
+    ~MBTilesRequest();
+
+    void cancel() final;
+
+private:
+    static void work(uv_work_t*);
+    static void afterWork(uv_work_t*, int status);
+
+    // Both run on a thread of the libuv thread pool.
+    void readTile(Connection&);
+    void readTileJSON(Connection&);
+
+    void setError(Response::Error::Reason, const std::string& message);
+
+    const std::shared_ptr<ConnectionPool> pool;
+    uv_work_t req;
+    bool canceled = false;
+
+    std::string path;
+    bool isTile = false;
+    int64_t z = 0, x = 0, y = 0;
+
+    std::unique_ptr<Response> response;
+};
+
+class MBTilesSQLiteContext : public MBTilesContextBase {
+public:
+    RequestBase* createRequest(const Resource& resource,
+                               RequestBase::Callback callback,
+                               uv_loop_t* loop) final {
+        return new MBTilesRequest(pool, resource, callback, loop);
+    }
+
+private:
+    // Shared with the requests, since they may still be running on the thread pool when the
+    // context is destroyed.
+    const std::shared_ptr<ConnectionPool> pool = std::make_shared<ConnectionPool>();
+};
+
+MBTilesRequest::MBTilesRequest(std::shared_ptr<ConnectionPool> pool_,
+                               const Resource& resource_,
+                               Callback callback_,
+                               uv_loop_t* loop)
+    : RequestBase(resource_, callback_),
+      pool(std::move(pool_)) {
+    req.data = this;
+
+    path = util::percentDecode(resource.url.substr(protocol.size()));
+
+    // Tile URLs end in /{z}/{x}/{y}; everything else refers to the archive itself.
+    int64_t coordinates[3];
+    std::string::size_type end = path.size();
+    int found = 0;
+    while (found < 3 && end > 0) {
+        const auto slash = path.rfind('/', end - 1);
+        if (slash == std::string::npos || slash + 1 == end) {
+            break;
+        }
+        const std::string component = path.substr(slash + 1, end - slash - 1);
+        if (component.find_first_not_of("0123456789") != std::string::npos) {
+            break;
+        }
+        // Saturates instead of overflowing, so that huge numbers are rejected by readTile().
+        coordinates[2 - found++] = std::strtoll(component.c_str(), nullptr, 10);
+        end = slash;
+    }
+
+    if (found == 3 && end > 0) {
+        isTile = true;
+        z = coordinates[0];
+        x = coordinates[1];
+        y = coordinates[2];
+        path.resize(end);
+    }
+
+    uv_queue_work(loop, &req, work, afterWork);
+}
+
+MBTilesRequest::~MBTilesRequest() {
+    MBGL_VERIFY_THREAD(tid);
+}
+
+void MBTilesRequest::work(uv_work_t* req) {
+    auto self = reinterpret_cast<MBTilesRequest*>(req->data);
+    self->response = std::make_unique<Response>();
+
+    try {
+        auto connection = self->pool->acquire(self->path);
+        if (self->isTile) {
+            self->readTile(*connection);
+        } else {
+            self->readTileJSON(*connection);
+        }
+        self->pool->release(self->path, std::move(connection));
+    } catch (const mapbox::sqlite::Exception& ex) {
+        const auto reason = ex.code == SQLITE_CANTOPEN ? Response::Error::Reason::NotFound
+                                                       : Response::Error::Reason::Other;
+        self->setError(reason, ex.what());
+    } catch (const std::exception& ex) {
+        self->setError(Response::Error::Reason::Other, ex.what());
+    }
+}
+
+void MBTilesRequest::readTile(Connection& connection) {
+    // Check that the tile exists in the pyramid before flipping its row, which would overflow
+    // otherwise.
+    if (z < 0 || z > 30 || x < 0 || y < 0 || x >= (int64_t(1) << z) || y >= (int64_t(1) << z)) {
+        setError(Response::Error::Reason::NotFound, "Invalid tile coordinates " +
+                 util::toString(z) + "/" + util::toString(x) + "/" + util::toString(y));
+        return;
+    }
+
+    auto& stmt = connection.tileStmt;
+    stmt.reset();
+    stmt.bind(1, z);
+    stmt.bind(2, x);
+    // MBTiles stores rows in TMS order, counting from the south.
+    stmt.bind(3, (int64_t(1) << z) - 1 - y);
+
+    if (!stmt.run()) {
+        setError(Response::Error::Reason::NotFound, "Tile not found in " + path);
+        return;
+    }
+
+    // Vector tiles are usually stored gzipped. Inflate them straight from the memory owned by
+    // SQLite instead of copying the compressed data first.
+    const auto blob = stmt.get<mapbox::sqlite::Blob>(0);
+    if (isGzip(blob)) {
+        response->data = std::make_shared<std::string>(util::decompress(blob.data, blob.size));
+    } else {
+        response->data = std::make_shared<std::string>(blob.data, blob.size);
+    }
+    stmt.reset();
+}
+
+void MBTilesRequest::readTileJSON(Connection& connection) {
+    auto stmt = connection.db.prepare("SELECT `name`, `value` FROM `metadata`");
+    std::unordered_map<std::string, std::string> metadata;
+    while (stmt.run()) {
+        metadata.emplace(stmt.get<std::string>(0), stmt.get<std::string>(1));
+    }
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+
+    writer.Key("tilejson");
+    writer.String("2.1.0");
+
+    writer.Key("tiles");
+    writer.StartArray();
+    writer.String(std::string(resource.url + "/{z}/{x}/{y}").c_str());
+    writer.EndArray();
+
+    for (const char* key : { "name", "description", "attribution", "version", "format" }) {
+        auto it = metadata.find(key);
+        if (it != metadata.end()) {
+            writer.Key(key);
+            writer.String(it->second.c_str(), rapidjson::SizeType(it->second.size()));
+        }
+    }
+
+    for (const char* key : { "minzoom", "maxzoom" }) {
+        auto it = metadata.find(key);
+        if (it != metadata.end() && !it->second.empty() &&
+            it->second.find_first_not_of("0123456789") == std::string::npos) {
+            writer.Key(key);
+            writer.Uint(unsigned(std::atoi(it->second.c_str())));
+        }
+    }
+
+    for (const auto& property : { std::make_pair("bounds", 4), std::make_pair("center", 3) }) {
+        auto it = metadata.find(property.first);
+        if (it == metadata.end()) {
+            continue;
+        }
+        const auto numbers = parseNumbers(it->second);
+        if (numbers.size() == std::size_t(property.second)) {
+            writer.Key(property.first);
+            writer.StartArray();
+            for (const double number : numbers) {
+                writer.Double(number);
+            }
+            writer.EndArray();
+        }
+    }
+
+    writer.EndObject();
+
+    response->data = std::make_shared<std::string>(buffer.GetString(), buffer.GetSize());
+}
+
+void MBTilesRequest::setError(Response::Error::Reason reason, const std::string& message) {
+    response = std::make_unique<Response>();
+    response->error = std::make_unique<Response::Error>(reason, message);
+}
+
+void MBTilesRequest::afterWork(uv_work_t* req, int status) {
+    auto self = reinterpret_cast<MBTilesRequest*>(req->data);
+    MBGL_VERIFY_THREAD(self->tid);
+
+    if (status != UV_ECANCELED && !self->canceled) {
+        self->notify(std::move(self->response));
+    }
+
+    delete self;
+}
+
+void MBTilesRequest::cancel() {
+    canceled = true;
+    // uv_cancel fails when the query is already running. In that case, afterWork() checks the
+    // canceled flag and deletes the request without notifying.
+    uv_cancel(reinterpret_cast<uv_req_t*>(&req));
+}
+
+std::unique_ptr<MBTilesContextBase> MBTilesContextBase::createContext(uv_loop_t*) {
+    return std::make_unique<MBTilesSQLiteContext>();
+}
+
+} // namespace mbgl
@@ -64,6 +64,16 @@ void Database::exec(const std::string &sql) {
     }
 }
 
+bool Database::hasMoved() const {
+    assert(db);
+    int moved = 0;
+    const int err = sqlite3_file_control(db, nullptr, SQLITE_FCNTL_HAS_MOVED, &moved);
+    if (err != SQLITE_OK) {
+        throw Exception { err, sqlite3_errmsg(db) };
+    }
+    return moved;
+}
+
 Statement Database::prepare(const char *query) {
     assert(db);
     return std::move(Statement(db, query));
@@ -176,6 +186,14 @@ template <> std::string Statement::get(int offset) {
     };
 }
 
+template <> Blob Statement::get(int offset) {
+    assert(stmt);
+    Blob blob;
+    blob.data = reinterpret_cast<const char *>(sqlite3_column_blob(stmt, offset));
+    blob.size = size_t(sqlite3_column_bytes(stmt, offset));
+    return blob;
+}
+
 void Statement::reset() {
     assert(stmt);
     sqlite3_reset(stmt);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <stdexcept>
 
@@ -24,6 +25,13 @@ struct Exception : std::runtime_error {
     const int code = 0;
 };
 
+// Points to a column value in memory owned by SQLite. It stays valid until the statement is run,
+// reset or destroyed, and lets callers read large values without copying them first.
+struct Blob {
+    const char *data = nullptr;
+    std::size_t size = 0;
+};
+
 class Statement;
 
 class Database {
@@ -42,6 +50,9 @@ public:
     void exec(const std::string &sql);
     Statement prepare(const char *query);
 
+    // Whether the database file was deleted or renamed after it was opened.
+    bool hasMoved() const;
+
 private:
     sqlite3 *db = nullptr;
 };
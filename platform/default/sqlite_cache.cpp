@@ -6,21 +6,70 @@
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/thread.hpp>
 #include <mbgl/util/mapbox.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/uv_detail.hpp>
 #include <mbgl/platform/log.hpp>
 
 #include "sqlite3.hpp"
 #include <sqlite3.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace mbgl {
 
 using namespace mapbox::sqlite;
 
+namespace {
+
+// Bump this whenever the schema changes. Databases with a version that createSchema() doesn't know
+// how to migrate are trashed, which is fine since they only contain cached data.
+const int schemaVersion = 3;
+
+// The order in which kinds of resources are evicted. Tiles are plentiful and cheap to fetch again
+// individually, while styles and glyphs are needed to render anything at all.
+const Resource::Kind evictionOrder[] = {
+    Resource::Tile,
+    Resource::Unknown,
+    Resource::SpriteImage,
+    Resource::SpriteJSON,
+    Resource::Source,
+    Resource::Glyphs,
+    Resource::Style,
+};
+
+// Upper bound for the number of entries evicted in a single transaction.
+const int evictionBatchSize = 64;
+
+// Number of hits after which access times are written to the database.
+const std::size_t accessFlushThreshold = 64;
+
+// Compressed entries that claim to be larger than this when decompressed, or to have been
+// compressed by a larger factor than deflate can achieve, are treated as corrupt.
+const uint64_t maxUncompressedSize = 64 * 1024 * 1024;
+const uint64_t maxCompressionRatio = 1032;
+
+// Writes are committed in one transaction once this many are queued, or after the delay (in
+// milliseconds) has passed since the first one was queued.
+const std::size_t writeBatchSize = 128;
+const uint64_t writeBatchDelay = 200;
+
+} // namespace
+
 SQLiteCache::SQLiteCache(const std::string& path_)
     : thread(std::make_unique<util::Thread<Impl>>(util::ThreadContext{"SQLiteCache", util::ThreadType::Unknown, util::ThreadPriority::Low}, path_)) {
 }
 
 SQLiteCache::~SQLiteCache() = default;
 
+void SQLiteCache::setMaximumCacheSize(uint64_t size) {
+    thread->invoke(&Impl::setMaximumCacheSize, size);
+}
+
+SQLiteCache::Statistics SQLiteCache::getStatistics() const {
+    return thread->invokeSync<Statistics>(&Impl::getStatistics);
+}
+
 SQLiteCache::Impl::Impl(const std::string& path_)
     : path(path_) {
 }
@@ -28,10 +77,17 @@ SQLiteCache::Impl::Impl(const std::string& path_)
 SQLiteCache::Impl::~Impl() {
     // Deleting these SQLite objects may result in exceptions, but we're in a destructor, so we
     // can't throw anything.
+    flushWrites();
+
     try {
+        flushAccessTimes();
         getStmt.reset();
         putStmt.reset();
         refreshStmt.reset();
+        sizeStmt.reset();
+        accessStmt.reset();
+        evictSelectStmt.reset();
+        evictDeleteStmt.reset();
         db.reset();
     } catch (mapbox::sqlite::Exception& ex) {
         Log::Error(Event::Database, ex.code, ex.what());
@@ -40,6 +96,17 @@ SQLiteCache::Impl::~Impl() {
 
 void SQLiteCache::Impl::createDatabase() {
     db = std::make_unique<Database>(path.c_str(), ReadWrite | Create);
+
+    // Other connections to the same database, e.g. from other processes, only hold the write lock
+    // while they commit a batch, so it's worth waiting for them briefly.
+    db->exec("PRAGMA busy_timeout = 100");
+}
+
+void SQLiteCache::Impl::configureDatabase() {
+    // With a write-ahead log, commits only need to sync the log. Reads of other connections to the
+    // same file, e.g. from other processes, don't block while this one writes. Within this cache,
+    // reads and writes share one connection and thread, so they never overlap anyway.
+    db->exec("PRAGMA journal_mode = WAL; PRAGMA synchronous = NORMAL");
 }
 
 void SQLiteCache::Impl::createSchema() {
@@ -52,12 +119,34 @@ void SQLiteCache::Impl::createSchema() {
         "    `etag` TEXT,"
         "    `expires` INTEGER," // Timestamp when the server says the file expires.
         "    `data` BLOB,"
-        "    `compressed` INTEGER NOT NULL DEFAULT 0" // Whether the data is compressed.
+        "    `compressed` INTEGER NOT NULL DEFAULT 0," // Whether the data is compressed.
+        "    `accessed` INTEGER NOT NULL DEFAULT 0," // Sequence number of the last access.
+        "    `size` INTEGER NOT NULL DEFAULT 0," // Size of the stored data in bytes.
+        "    `uncompressed_size` INTEGER NOT NULL DEFAULT 0" // Size of the data after decompression.
         ");"
-        "CREATE INDEX IF NOT EXISTS `http_cache_kind_idx` ON `http_cache` (`kind`);";
+        "CREATE INDEX IF NOT EXISTS `http_cache_kind_accessed_idx` ON `http_cache` (`kind`, `accessed`);";
+
+    const std::string versionSQL = "PRAGMA user_version = " + std::to_string(schemaVersion);
 
     try {
-        db->exec(sql);
+        configureDatabase();
+
+        int version = 0;
+        {
+            Statement versionStmt = db->prepare("PRAGMA user_version");
+            if (versionStmt.run()) {
+                version = versionStmt.get<int>(0);
+            }
+        }
+
+        if (version != schemaVersion) {
+            migrateSchema(version);
+            db->exec(sql);
+            db->exec(versionSQL);
+        } else {
+            db->exec(sql);
+        }
+
         schema = true;
     } catch (mapbox::sqlite::Exception &ex) {
         if (ex.code == SQLITE_NOTADB) {
@@ -68,15 +157,78 @@ void SQLiteCache::Impl::createSchema() {
             } catch (util::IOException& ioEx) {
                 Log::Error(Event::Database, ex.code, ex.what());
             }
-            db = std::make_unique<Database>(path.c_str(), ReadWrite | Create);
+            createDatabase();
         } else {
             Log::Error(Event::Database, ex.code, ex.what());
         }
 
+        // A new database file needs the same settings as one that was opened successfully.
+        configureDatabase();
+
         // Creating the database table + index failed. That means there may already be one, likely
         // with different columsn. Drop it and try to create a new one.
         db->exec("DROP TABLE IF EXISTS `http_cache`");
         db->exec(sql);
+        db->exec(versionSQL);
+    }
+
+    loadUsage();
+}
+
+void SQLiteCache::Impl::migrateSchema(int version) {
+    bool exists = false;
+    {
+        Statement tableStmt = db->prepare(
+            "SELECT 1 FROM `sqlite_master` WHERE `type` = 'table' AND `name` = 'http_cache'");
+        exists = tableStmt.run();
+    }
+
+    if (!exists) {
+        // This is a new database.
+        return;
+    }
+
+    // Version 0 is the schema without size accounting. Version 2 lacks the uncompressed size. The
+    // uncompressed size of compressed entries isn't known without inflating them, so it is left at
+    // 0, which get() treats as unknown. Entries keep an access sequence number of 0, so they are
+    // evicted before anything that is read or written after the migration.
+    const char* migrationSQL = nullptr;
+    if (version == 0) {
+        migrationSQL = ""
+            "ALTER TABLE `http_cache` ADD COLUMN `accessed` INTEGER NOT NULL DEFAULT 0;"
+            "ALTER TABLE `http_cache` ADD COLUMN `size` INTEGER NOT NULL DEFAULT 0;"
+            "ALTER TABLE `http_cache` ADD COLUMN `uncompressed_size` INTEGER NOT NULL DEFAULT 0;"
+            "UPDATE `http_cache` SET `size` = IFNULL(LENGTH(CAST(`data` AS BLOB)), 0);"
+            "DROP INDEX IF EXISTS `http_cache_kind_idx`;";
+    } else if (version == 2) {
+        migrationSQL = ""
+            "ALTER TABLE `http_cache` ADD COLUMN `uncompressed_size` INTEGER NOT NULL DEFAULT 0;";
+    }
+
+    if (!migrationSQL) {
+        // There is no migration from this version, e.g. because it is newer than this one.
+        Log::Warning(Event::Database, "Trashing cache with unknown schema version %d", version);
+        db->exec("DROP TABLE IF EXISTS `http_cache`");
+        return;
+    }
+
+    db->exec("BEGIN IMMEDIATE");
+    try {
+        db->exec(migrationSQL);
+        db->exec("UPDATE `http_cache` SET `uncompressed_size` = `size` WHERE NOT `compressed`");
+        db->exec("COMMIT");
+    } catch (mapbox::sqlite::Exception&) {
+        // The table is dropped and created again by the caller.
+        rollback();
+        throw;
+    }
+}
+
+void SQLiteCache::Impl::loadUsage() {
+    Statement usageStmt = db->prepare("SELECT SUM(`size`), MAX(`accessed`) FROM `http_cache`");
+    if (usageStmt.run()) {
+        statistics.size = usageStmt.get<int64_t>(0);
+        accessSequence = usageStmt.get<int64_t>(1);
     }
 }
 
@@ -89,6 +241,17 @@ std::unique_ptr<WorkRequest> SQLiteCache::get(const Resource &resource, Callback
 }
 
 void SQLiteCache::Impl::get(const Resource &resource, Callback callback) {
+    const auto canonicalURL = util::mapbox::canonicalURL(resource.url);
+
+    // Responses that haven't been written yet are served from the write queue.
+    auto pending = pendingWrites.find(canonicalURL);
+    if (pending != pendingWrites.end()) {
+        statistics.hits++;
+        pending->second.accessed = ++accessSequence;
+        callback(std::make_unique<Response>(*pending->second.response));
+        return;
+    }
+
     try {
         // This is called in the SQLite event loop.
         if (!db) {
@@ -102,13 +265,14 @@ void SQLiteCache::Impl::get(const Resource &resource, Callback callback) {
         if (!getStmt) {
             // Initialize the statement                                  0         1
             getStmt = std::make_unique<Statement>(db->prepare("SELECT `status`, `modified`, "
-            //     2         3        4          5                                       1
-                "`etag`, `expires`, `data`, `compressed` FROM `http_cache` WHERE `url` = ?"));
+            //     2         3        4          5                 6
+                "`etag`, `expires`, `data`, `compressed`, `uncompressed_size` "
+            //                               1
+                "FROM `http_cache` WHERE `url` = ?"));
         } else {
             getStmt->reset();
         }
 
-        const auto canonicalURL = util::mapbox::canonicalURL(resource.url);
         getStmt->bind(1, canonicalURL.c_str());
         if (getStmt->run()) {
             // There is data.
@@ -121,13 +285,46 @@ void SQLiteCache::Impl::get(const Resource &resource, Callback callback) {
             response->modified = getStmt->get<int64_t>(1);
             response->etag = getStmt->get<std::string>(2);
             response->expires = getStmt->get<int64_t>(3);
-            response->data = std::make_shared<std::string>(std::move(getStmt->get<std::string>(4)));
+
+            // Compressed data is inflated straight out of SQLite's buffer into a buffer of the final
+            // size, so every byte of the response is written exactly once.
+            const Blob blob = getStmt->get<Blob>(4);
             if (getStmt->get<int>(5)) { // == compressed
-                response->data = std::make_shared<std::string>(std::move(util::decompress(*response->data)));
+                // The stored size of the decompressed data determines the size of the allocation,
+                // so it must be plausible: a corrupt entry could make us allocate gigabytes.
+                // Entries that were migrated from older schema versions have a size of 0
+                // (unknown) and are inflated up to the limit.
+                const auto size = getStmt->get<int64_t>(6);
+                const uint64_t limit = std::min(maxUncompressedSize, uint64_t(blob.size) * maxCompressionRatio);
+                std::string data;
+                if (size >= 0 && uint64_t(size) <= limit) {
+                    data = util::decompress(blob.data, blob.size, size, size ? size : limit);
+                }
+                if (size < 0 || uint64_t(size) > limit || (size && data.size() != uint64_t(size))) {
+                    getStmt->reset();
+                    Log::Warning(Event::Database, "Ignoring cache entry with an invalid size");
+                    statistics.misses++;
+                    callback(nullptr);
+                    return;
+                }
+                response->data = std::make_shared<std::string>(std::move(data));
+            } else {
+                response->data = std::make_shared<std::string>(blob.data, blob.size);
             }
+            getStmt->reset();
+            statistics.hits++;
+            pendingAccesses[canonicalURL] = ++accessSequence;
+            statistics.bytesRead += blob.size;
+            statistics.bytesCopied += response->data->size();
+
+            if (pendingAccesses.size() >= accessFlushThreshold) {
+                flushAccessTimes();
+            }
+
             callback(std::move(response));
         } else {
             // There is no data.
+            statistics.misses++;
             callback(nullptr);
         }
     } catch (mapbox::sqlite::Exception& ex) {
@@ -151,6 +348,45 @@ void SQLiteCache::put(const Resource &resource, std::shared_ptr<const Response>
 }
 
 void SQLiteCache::Impl::put(const Resource& resource, std::shared_ptr<const Response> response) {
+    // Every transaction requires a sync to disk, so we queue up writes and commit them in batches.
+    // Repeated writes of the same URL replace each other in the queue.
+    const auto canonicalURL = util::mapbox::canonicalURL(resource.url);
+    PendingWrite& write = pendingWrites[canonicalURL];
+    write.kind = resource.kind;
+    write.response = response;
+    write.accessed = ++accessSequence;
+    pendingAccesses.erase(canonicalURL);
+
+    if (pendingWrites.size() >= writeBatchSize || !util::RunLoop::Get()) {
+        // Without a RunLoop on this thread, there is no way to defer the write.
+        flushWrites();
+    } else if (!writeScheduled) {
+        if (!writeTimer) {
+            writeTimer = std::make_unique<uv::timer>(util::RunLoop::getLoop());
+        }
+        writeScheduled = true;
+        writeTimer->start(writeBatchDelay, 0, [this] {
+            writeScheduled = false;
+            flushWrites();
+        });
+    }
+}
+
+void SQLiteCache::Impl::flushWrites() {
+    if (writeScheduled) {
+        writeScheduled = false;
+        writeTimer->stop();
+    }
+
+    if (pendingWrites.empty()) {
+        return;
+    }
+
+    // Failed writes are not retried; the responses will be fetched from the network again.
+    auto writes = std::move(pendingWrites);
+    pendingWrites.clear();
+
+    bool transaction = false;
     try {
         if (!db) {
             createDatabase();
@@ -160,55 +396,114 @@ void SQLiteCache::Impl::put(const Resource& resource, std::shared_ptr<const Resp
             createSchema();
         }
 
+        if (!sizeStmt) {
+            sizeStmt = std::make_unique<Statement>( //                              1
+                db->prepare("SELECT `size` FROM `http_cache` WHERE `url` = ?"));
+        }
+
         if (!putStmt) {
             putStmt = std::make_unique<Statement>(db->prepare("REPLACE INTO `http_cache` ("
             //     1       2       3         4         5         6        7          8
-                "`url`, `status`, `kind`, `modified`, `etag`, `expires`, `data`, `compressed`"
-                ") VALUES(?, ?, ?, ?, ?, ?, ?, ?)"));
-        } else {
-            putStmt->reset();
+                "`url`, `status`, `kind`, `modified`, `etag`, `expires`, `data`, `compressed`, "
+            //     9          10            11
+                "`accessed`, `size`, `uncompressed_size`"
+                ") VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"));
         }
 
-        const auto canonicalURL = util::mapbox::canonicalURL(resource.url);
-        putStmt->bind(1 /* url */, canonicalURL.c_str());
-        if (response->error) {
-            putStmt->bind(2 /* status */, int(response->error->reason));
-        } else {
-            putStmt->bind(2 /* status */, 1 /* success */);
-        }
-        putStmt->bind(3 /* kind */, int(resource.kind));
-        putStmt->bind(4 /* modified */, response->modified);
-        putStmt->bind(5 /* etag */, response->etag.c_str());
-        putStmt->bind(6 /* expires */, response->expires);
-
-        std::string data;
-        if (resource.kind != Resource::SpriteImage && response->data) {
-            // Do not compress images, since they are typically compressed already.
-            data = util::compress(*response->data);
-        }
-
-        if (!data.empty() && data.size() < response->data->size()) {
-            // Store the compressed data when it is smaller than the original
-            // uncompressed data.
-            putStmt->bind(7 /* data */, data, false); // do not retain the string internally.
-            putStmt->bind(8 /* compressed */, true);
-        } else if (response->data) {
-            putStmt->bind(7 /* data */, *response->data, false); // do not retain the string internally.
-            putStmt->bind(8 /* compressed */, false);
-        } else {
-            putStmt->bind(7 /* data */, "", false);
-            putStmt->bind(8 /* compressed */, false);
+        if (db->hasMoved()) {
+            // In rollback journal mode, SQLite refuses to write to a database file that was
+            // deleted. With a write-ahead log, it doesn't check and the writes would get lost.
+            throw mapbox::sqlite::Exception { SQLITE_READONLY, sqlite3_errstr(SQLITE_READONLY) };
         }
 
-        putStmt->run();
+        db->exec("BEGIN IMMEDIATE");
+        transaction = true;
+
+        uint64_t added = 0;
+        uint64_t removed = 0;
+        for (const auto& it : writes) {
+            const std::string& canonicalURL = it.first;
+            const Response& response = *it.second.response;
+
+            // We're replacing the existing entry, if any.
+            sizeStmt->reset();
+            sizeStmt->bind(1, canonicalURL.c_str());
+            removed += sizeStmt->run() ? sizeStmt->get<int64_t>(0) : 0;
+            sizeStmt->reset();
+
+            putStmt->reset();
+            putStmt->bind(1 /* url */, canonicalURL.c_str());
+            if (response.error) {
+                putStmt->bind(2 /* status */, int(response.error->reason));
+            } else {
+                putStmt->bind(2 /* status */, 1 /* success */);
+            }
+            putStmt->bind(3 /* kind */, int(it.second.kind));
+            putStmt->bind(4 /* modified */, response.modified);
+            putStmt->bind(5 /* etag */, response.etag.c_str());
+            putStmt->bind(6 /* expires */, response.expires);
+
+            std::string data;
+            if (it.second.kind != Resource::SpriteImage && response.data) {
+                // Do not compress images, since they are typically compressed already.
+                data = util::compress(*response.data);
+            }
+
+            uint64_t size = 0;
+            if (!data.empty() && data.size() < response.data->size()) {
+                // Store the compressed data when it is smaller than the original
+                // uncompressed data.
+                putStmt->bind(7 /* data */, data, false); // do not retain the string internally.
+                putStmt->bind(8 /* compressed */, true);
+                size = data.size();
+            } else if (response.data) {
+                putStmt->bind(7 /* data */, *response.data, false); // do not retain the string internally.
+                putStmt->bind(8 /* compressed */, false);
+                size = response.data->size();
+            } else {
+                putStmt->bind(7 /* data */, "", false);
+                putStmt->bind(8 /* compressed */, false);
+            }
+
+            putStmt->bind(9 /* accessed */, it.second.accessed);
+            putStmt->bind(10 /* size */, int64_t(size));
+            putStmt->bind(11 /* uncompressed_size */, int64_t(response.data ? response.data->size() : 0));
+
+            putStmt->run();
+            putStmt->reset();
+            added += size;
+        }
+
+        db->exec("COMMIT");
+        transaction = false;
+
+        statistics.size = statistics.size + added - removed;
+
+        if (maximumSize && statistics.size > maximumSize) {
+            evict();
+        }
     } catch (mapbox::sqlite::Exception& ex) {
         Log::Error(Event::Database, ex.code, ex.what());
     } catch (std::runtime_error& ex) {
         Log::Error(Event::Database, "%s", ex.what());
     }
+
+    if (transaction) {
+        rollback();
+    }
 }
 
 void SQLiteCache::Impl::refresh(const Resource& resource, int64_t expires) {
+    const auto canonicalURL = util::mapbox::canonicalURL(resource.url);
+
+    auto pending = pendingWrites.find(canonicalURL);
+    if (pending != pendingWrites.end()) {
+        auto response = std::make_shared<Response>(*pending->second.response);
+        response->expires = expires;
+        pending->second.response = response;
+        return;
+    }
+
     try {
         if (!db) {
             createDatabase();
@@ -225,7 +520,6 @@ void SQLiteCache::Impl::refresh(const Resource& resource, int64_t expires) {
             refreshStmt->reset();
         }
 
-        const auto canonicalURL = util::mapbox::canonicalURL(resource.url);
         refreshStmt->bind(1, int64_t(expires));
         refreshStmt->bind(2, canonicalURL.c_str());
         refreshStmt->run();
@@ -234,6 +528,144 @@ void SQLiteCache::Impl::refresh(const Resource& resource, int64_t expires) {
     }
 }
 
+void SQLiteCache::Impl::setMaximumCacheSize(uint64_t size) {
+    maximumSize = size;
+
+    if (!db || !schema || !maximumSize || statistics.size <= maximumSize) {
+        return;
+    }
+
+    try {
+        evict();
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, ex.code, ex.what());
+    }
+}
+
+void SQLiteCache::Impl::rollback() {
+    try {
+        db->exec("ROLLBACK");
+    } catch (mapbox::sqlite::Exception&) {
+        // SQLite already rolled back the transaction for some kinds of errors.
+    }
+}
+
+SQLiteCache::Statistics SQLiteCache::Impl::getStatistics() const {
+    return statistics;
+}
+
+void SQLiteCache::Impl::flushAccessTimes() {
+    if (pendingAccesses.empty() || !db) {
+        return;
+    }
+
+    // Don't retry failed updates; the entries will just look older than they are.
+    auto accesses = std::move(pendingAccesses);
+    pendingAccesses.clear();
+
+    // Failing to record access times must not fail the read that triggered the flush.
+    try {
+        if (!accessStmt) {
+            accessStmt = std::make_unique<Statement>( //                   1               2
+                db->prepare("UPDATE `http_cache` SET `accessed` = ? WHERE `url` = ?"));
+        }
+
+        db->exec("BEGIN IMMEDIATE");
+        try {
+            for (const auto& access : accesses) {
+                accessStmt->reset();
+                accessStmt->bind(1, access.second);
+                accessStmt->bind(2, access.first.c_str());
+                accessStmt->run();
+            }
+            accessStmt->reset();
+            db->exec("COMMIT");
+        } catch (mapbox::sqlite::Exception&) {
+            accessStmt->reset();
+            rollback();
+            throw;
+        }
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, ex.code, ex.what());
+    }
+}
+
+void SQLiteCache::Impl::evict() {
+    // Eviction is ordered by access time, so make sure it's current.
+    flushAccessTimes();
+
+    if (!evictSelectStmt) {
+        evictSelectStmt = std::make_unique<Statement>(db->prepare("SELECT `url`, `size` "
+            //                               1                          2
+            "FROM `http_cache` WHERE `kind` = ? ORDER BY `accessed` LIMIT ?"));
+    }
+
+    if (!evictDeleteStmt) {
+        evictDeleteStmt = std::make_unique<Statement>( //           1
+            db->prepare("DELETE FROM `http_cache` WHERE `url` = ?"));
+    }
+
+    // Evict a bit more than necessary, so that we don't have to evict again on every put.
+    const uint64_t target = maximumSize - maximumSize / 10;
+
+    // Every batch is committed separately, so that the write lock is released in between.
+    while (statistics.size > target) {
+        if (evictBatch(target) == 0) {
+            // There is nothing left to evict, e.g. because another connection deleted entries.
+            break;
+        }
+    }
+}
+
+std::size_t SQLiteCache::Impl::evictBatch(uint64_t target) {
+    int remaining = evictionBatchSize;
+    std::vector<std::pair<std::string, uint64_t>> candidates;
+    const Statistics previous = statistics;
+
+    db->exec("BEGIN IMMEDIATE");
+    try {
+        for (const auto kind : evictionOrder) {
+            if (statistics.size <= target || remaining == 0) {
+                break;
+            }
+
+            candidates.clear();
+            evictSelectStmt->reset();
+            evictSelectStmt->bind(1, int(kind));
+            evictSelectStmt->bind(2, remaining);
+            while (evictSelectStmt->run()) {
+                candidates.emplace_back(evictSelectStmt->get<std::string>(0),
+                                        evictSelectStmt->get<int64_t>(1));
+            }
+            evictSelectStmt->reset();
+
+            for (const auto& candidate : candidates) {
+                if (statistics.size <= target) {
+                    break;
+                }
+
+                evictDeleteStmt->reset();
+                evictDeleteStmt->bind(1, candidate.first.c_str());
+                evictDeleteStmt->run();
+
+                statistics.size -= std::min(statistics.size, candidate.second);
+                statistics.evictedBytes += candidate.second;
+                remaining--;
+            }
+        }
+        evictDeleteStmt->reset();
+        db->exec("COMMIT");
+    } catch (mapbox::sqlite::Exception&) {
+        evictSelectStmt->reset();
+        evictDeleteStmt->reset();
+        statistics = previous;
+        rollback();
+        throw;
+    }
+
+    return evictionBatchSize - remaining;
+}
+
 std::shared_ptr<SQLiteCache> SharedSQLiteCache::get(const std::string &path) {
     std::shared_ptr<SQLiteCache> temp = masterPtr.lock();
     if (!temp) {
@@ -2,6 +2,14 @@
 #define MBGL_STORAGE_DEFAULT_SQLITE_CACHE_IMPL
 
 #include <mbgl/storage/sqlite_cache.hpp>
+#include <mbgl/storage/resource.hpp>
+
+#include <string>
+#include <unordered_map>
+
+namespace uv {
+class timer;
+}
 
 namespace mapbox {
 namespace sqlite {
@@ -21,16 +29,67 @@ public:
     void put(const Resource& resource, std::shared_ptr<const Response> response);
     void refresh(const Resource& resource, int64_t expires);
 
+    void setMaximumCacheSize(uint64_t size);
+    Statistics getStatistics() const;
+
 private:
     void createDatabase();
+    void configureDatabase();
     void createSchema();
 
+    // Converts the cache table of an older schema version in place, so that upgrading doesn't
+    // discard the cache. Drops the table if there is no migration from this version.
+    void migrateSchema(int version);
+    void loadUsage();
+
+    // Commits all queued writes in a single transaction.
+    void flushWrites();
+
+    void rollback();
+
+    // Writes the access times of all entries that were read since the last flush. Errors are
+    // logged, not thrown.
+    void flushAccessTimes();
+
+    // Evicts the least recently used entries until the cache is below its maximum size again.
+    void evict();
+
+    // Evicts entries in one transaction until the size is at the target, but at most a fixed number
+    // of them to bound the time the database is locked. Returns the number of evicted entries.
+    std::size_t evictBatch(uint64_t target);
+
     const std::string path;
     std::unique_ptr<::mapbox::sqlite::Database> db;
     std::unique_ptr<::mapbox::sqlite::Statement> getStmt;
     std::unique_ptr<::mapbox::sqlite::Statement> putStmt;
     std::unique_ptr<::mapbox::sqlite::Statement> refreshStmt;
+    std::unique_ptr<::mapbox::sqlite::Statement> sizeStmt;
+    std::unique_ptr<::mapbox::sqlite::Statement> accessStmt;
+    std::unique_ptr<::mapbox::sqlite::Statement> evictSelectStmt;
+    std::unique_ptr<::mapbox::sqlite::Statement> evictDeleteStmt;
     bool schema = false;
+
+    uint64_t maximumSize = 50 * 1024 * 1024;
+    Statistics statistics;
+
+    // Entries are ordered by a sequence number of their last access rather than a timestamp, so
+    // that accesses within the same second are ordered as well.
+    int64_t accessSequence = 0;
+
+    // Access times that haven't been written to the database yet, by canonical URL. Hits only
+    // update this map, so that reading from the cache doesn't require a write for every hit.
+    std::unordered_map<std::string, int64_t> pendingAccesses;
+
+    struct PendingWrite {
+        Resource::Kind kind = Resource::Unknown;
+        std::shared_ptr<const Response> response;
+        int64_t accessed = 0;
+    };
+
+    // Responses that haven't been committed to the database yet, by canonical URL.
+    std::unordered_map<std::string, PendingWrite> pendingWrites;
+    std::unique_ptr<uv::timer> writeTimer;
+    bool writeScheduled = false;
 };
 
 
@@ -661,15 +661,8 @@ std::chrono::steady_clock::duration durationInSeconds(float duration)
 {
     if ( ! self.isDormant)
     {
-        CGFloat zoomFactor   = _mbglMap->getMaxZoom() - _mbglMap->getMinZoom() + 1;
-        CGFloat cpuFactor    = (CGFloat)[[NSProcessInfo processInfo] processorCount];
-        CGFloat memoryFactor = (CGFloat)[[NSProcessInfo processInfo] physicalMemory] / 1000 / 1000 / 1000;
-        CGFloat sizeFactor   = ((CGFloat)_mbglMap->getWidth()  / mbgl::util::tileSize) *
-                               ((CGFloat)_mbglMap->getHeight() / mbgl::util::tileSize);
-
-        NSUInteger cacheSize = zoomFactor * cpuFactor * memoryFactor * sizeFactor * 0.5;
-
-        _mbglMap->setSourceTileCacheSize(cacheSize);
+        // Tiles that are no longer visible may keep up to 1/32 of the device memory.
+        _mbglMap->setTileCacheSize((size_t)([[NSProcessInfo processInfo] physicalMemory] / 32));
 
         _mbglMap->renderSync();
 
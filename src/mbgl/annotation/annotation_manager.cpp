@@ -5,11 +5,25 @@
 
 #include <boost/function_output_iterator.hpp>
 
+#include <cmath>
+
 namespace mbgl {
 
 const std::string AnnotationManager::SourceID = "com.mapbox.annotations";
 const std::string AnnotationManager::PointLayerID = "com.mapbox.annotations.points";
 
+namespace {
+
+// Beyond this number of changed areas, they are merged into one, which may cause tiles in
+// between them to be updated needlessly.
+const std::size_t maxDirtyBounds = 64;
+
+// Shapes are clipped to tiles with a buffer of 64 units out of 4096, so they appear in
+// neighbouring tiles as well.
+const double tileBuffer = 64.0 / 4096.0;
+
+} // namespace
+
 AnnotationManager::AnnotationManager() = default;
 AnnotationManager::~AnnotationManager() = default;
 
@@ -23,7 +37,11 @@ AnnotationManager::addPointAnnotations(const std::vector<PointAnnotation>& point
         auto annotation = std::make_shared<PointAnnotationImpl>(annotationID, point);
         pointTree.insert(annotation);
         pointAnnotations.emplace(annotationID, annotation);
+        if (pointClusters) {
+            pointClusters->insert(point.position);
+        }
         annotationIDs.push_back(annotationID);
+        markDirty(annotation->bounds());
     }
 
     return annotationIDs;
@@ -36,8 +54,9 @@ AnnotationManager::addShapeAnnotations(const std::vector<ShapeAnnotation>& shape
 
     for (const auto& shape : shapes) {
         const uint32_t annotationID = nextID++;
-        shapeAnnotations.emplace(annotationID,
-            std::make_unique<ShapeAnnotationImpl>(annotationID, shape, maxZoom));
+        auto annotation = std::make_unique<ShapeAnnotationImpl>(annotationID, shape, maxZoom);
+        markDirty(annotation->bounds());
+        shapeAnnotations.emplace(annotationID, std::move(annotation));
         annotationIDs.push_back(annotationID);
     }
 
@@ -47,15 +66,46 @@ AnnotationManager::addShapeAnnotations(const std::vector<ShapeAnnotation>& shape
 void AnnotationManager::removeAnnotations(const AnnotationIDs& ids) {
     for (const auto& id : ids) {
         if (pointAnnotations.find(id) != pointAnnotations.end()) {
+            markDirty(pointAnnotations.at(id)->bounds());
             pointTree.remove(pointAnnotations.at(id));
+            if (pointClusters) {
+                pointClusters->remove(pointAnnotations.at(id)->point.position);
+            }
             pointAnnotations.erase(id);
         } else if (shapeAnnotations.find(id) != shapeAnnotations.end()) {
+            markDirty(shapeAnnotations.at(id)->bounds());
             obsoleteShapeAnnotationLayers.push_back(shapeAnnotations.at(id)->layerID);
             shapeAnnotations.erase(id);
         }
     }
 }
 
+void AnnotationManager::setPointClustering(bool enabled) {
+    if (enabled == getPointClustering()) {
+        return;
+    }
+
+    if (enabled) {
+        std::vector<LatLng> positions;
+        positions.reserve(pointAnnotations.size());
+        for (const auto& point : pointAnnotations) {
+            positions.push_back(point.second->point.position);
+        }
+        pointClusters = std::make_unique<PointClusterIndex>();
+        pointClusters->load(positions);
+    } else {
+        pointClusters.reset();
+    }
+
+    if (!pointAnnotations.empty()) {
+        markDirty(LatLngBounds::world());
+    }
+}
+
+bool AnnotationManager::getPointClustering() const {
+    return bool(pointClusters);
+}
+
 AnnotationIDs AnnotationManager::getPointAnnotationsInBounds(const LatLngBounds& bounds) const {
     AnnotationIDs result;
 
@@ -91,12 +141,30 @@ std::unique_ptr<AnnotationTile> AnnotationManager::getTile(const TileID& tileID)
         PointLayerID,
         std::make_unique<AnnotationTileLayer>()).first->second;
 
-    LatLngBounds tileBounds(tileID);
+    if (pointClusters && tileID.z <= pointClusters->maxZoom) {
+        for (const auto& cluster : pointClusters->getClusters(tileID)) {
+            if (cluster.count > 1) {
+                cluster.updateLayer(tileID, pointLayer);
+                continue;
+            }
+
+            // The query includes the points on the edges of the cell, which may belong to the
+            // cells next to it.
+            pointTree.query(boost::geometry::index::intersects(cluster.bounds()),
+                boost::make_function_output_iterator([&](const auto& val){
+                    if (cluster.contains(val->point.position)) {
+                        val->updateLayer(tileID, pointLayer);
+                    }
+                }));
+        }
+    } else {
+        LatLngBounds tileBounds(tileID);
 
-    pointTree.query(boost::geometry::index::intersects(tileBounds),
-        boost::make_function_output_iterator([&](const auto& val){
-            val->updateLayer(tileID, pointLayer);
-        }));
+        pointTree.query(boost::geometry::index::intersects(tileBounds),
+            boost::make_function_output_iterator([&](const auto& val){
+                val->updateLayer(tileID, pointLayer);
+            }));
+    }
 
     for (const auto& shape : shapeAnnotations) {
         shape.second->updateTile(tileID, *tile);
@@ -138,11 +206,56 @@ void AnnotationManager::updateStyle(Style& style) {
 
     obsoleteShapeAnnotationLayers.clear();
 
+    updateTiles();
+}
+
+void AnnotationManager::updateTiles() {
+    if (dirtyBounds.empty()) {
+        return;
+    }
+
     for (auto& monitor : monitors) {
-        monitor->update(getTile(monitor->tileID));
+        if (isDirty(monitor->tileID)) {
+            monitor->update(getTile(monitor->tileID));
+        }
+    }
+
+    dirtyBounds.clear();
+}
+
+void AnnotationManager::markDirty(const LatLngBounds& bounds) {
+    dirtyBounds.push_back(bounds);
+
+    if (dirtyBounds.size() > maxDirtyBounds) {
+        LatLngBounds merged = LatLngBounds::getExtendable();
+        for (const auto& dirty : dirtyBounds) {
+            merged.extend(dirty);
+        }
+        dirtyBounds.assign(1, merged);
     }
 }
 
+bool AnnotationManager::isDirty(const TileID& tileID) const {
+    // Compares in projected coordinates, where tiles are squares, so that the buffer around
+    // them has the same size at all latitudes.
+    const double scale = std::pow(2.0, tileID.z);
+    const double minX = (tileID.x - tileBuffer) / scale;
+    const double maxX = (tileID.x + 1 + tileBuffer) / scale;
+    const double minY = (tileID.y - tileBuffer) / scale;
+    const double maxY = (tileID.y + 1 + tileBuffer) / scale;
+
+    for (const auto& bounds : dirtyBounds) {
+        // Latitudes increase northwards, but projected coordinates southwards.
+        const PrecisionPoint sw = bounds.sw.project();
+        const PrecisionPoint ne = bounds.ne.project();
+        if (sw.x <= maxX && ne.x >= minX && ne.y <= maxY && sw.y >= minY) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void AnnotationManager::addTileMonitor(AnnotationTileMonitor& monitor) {
     monitors.insert(&monitor);
     monitor.update(getTile(monitor.tileID));
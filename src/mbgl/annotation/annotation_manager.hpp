@@ -3,10 +3,12 @@
 
 #include <mbgl/annotation/annotation.hpp>
 #include <mbgl/annotation/point_annotation_impl.hpp>
+#include <mbgl/annotation/point_cluster_index.hpp>
 #include <mbgl/annotation/shape_annotation_impl.hpp>
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/noncopyable.hpp>
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <set>
@@ -31,8 +33,19 @@ public:
     AnnotationIDs getPointAnnotationsInBounds(const LatLngBounds&) const;
     LatLngBounds getBoundsForAnnotations(const AnnotationIDs&) const;
 
+    // Tiles up to the maximum zoom level of the cluster index carry one feature per cluster of
+    // nearby points instead of one per point. Clusters have a "cluster" and a "point_count"
+    // property; clusters of a single point are the point itself.
+    void setPointClustering(bool);
+    bool getPointClustering() const;
+
     void updateStyle(Style&);
 
+    // Regenerates the tiles of the monitors that intersect annotations that were added or removed
+    // since the last call, so that many edits within one frame cause a single update. Called by
+    // updateStyle().
+    void updateTiles();
+
     void addTileMonitor(AnnotationTileMonitor&);
     void removeTileMonitor(AnnotationTileMonitor&);
 
@@ -42,12 +55,19 @@ public:
 private:
     std::unique_ptr<AnnotationTile> getTile(const TileID&);
 
+    void markDirty(const LatLngBounds&);
+    bool isDirty(const TileID&) const;
+
     AnnotationID nextID = 0;
     PointAnnotationImpl::Tree pointTree;
     PointAnnotationImpl::Map pointAnnotations;
+    std::unique_ptr<PointClusterIndex> pointClusters;
     ShapeAnnotationImpl::Map shapeAnnotations;
     std::vector<std::string> obsoleteShapeAnnotationLayers;
     std::set<AnnotationTileMonitor*> monitors;
+
+    // The bounds of annotations that were added or removed since the tiles were last updated.
+    std::vector<LatLngBounds> dirtyBounds;
 };
 
 }
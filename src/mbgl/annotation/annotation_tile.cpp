@@ -19,6 +19,15 @@ mapbox::util::optional<Value> AnnotationTileFeature::getValue(const std::string&
     return mapbox::util::optional<Value>();
 }
 
+bool AnnotationTileLayer::everyFeature(const std::function<bool (const GeometryTileFeature&)>& function) const {
+    for (const auto& feature : features) {
+        if (!function(*feature)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 util::ptr<GeometryTileLayer> AnnotationTile::getLayer(const std::string& name) const {
     auto it = layers.find(name);
     if (it != layers.end()) {
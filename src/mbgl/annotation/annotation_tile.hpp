@@ -17,6 +17,7 @@ public:
     FeatureType getType() const override { return type; }
     mapbox::util::optional<Value> getValue(const std::string&) const override;
     GeometryCollection getGeometries() const override { return geometries; }
+    const GeometryCollection& readGeometries(GeometryCollection&) const override { return geometries; }
 
     const FeatureType type;
     const std::unordered_map<std::string, std::string> properties;
@@ -27,6 +28,7 @@ class AnnotationTileLayer : public GeometryTileLayer {
 public:
     std::size_t featureCount() const override { return features.size(); }
     util::ptr<const GeometryTileFeature> getFeature(std::size_t i) const override { return features[i]; }
+    bool everyFeature(const std::function<bool (const GeometryTileFeature&)>&) const override;
 
     std::vector<util::ptr<const AnnotationTileFeature>> features;
 };
@@ -0,0 +1,158 @@
+#include <mbgl/annotation/point_cluster_index.hpp>
+#include <mbgl/annotation/annotation_tile.hpp>
+#include <mbgl/map/tile_id.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace mbgl {
+
+namespace {
+
+uint32_t cellCoordinate(double projected, uint8_t zoom) {
+    const double cells = std::pow(2.0, zoom + PointClusterIndex::cellBits);
+    return uint32_t(std::min(std::max(std::floor(projected * cells), 0.0), cells - 1));
+}
+
+uint64_t cellKey(uint32_t x, uint32_t y) {
+    return (uint64_t(x) << 32) | y;
+}
+
+uint64_t cellKey(const PrecisionPoint& pp, uint8_t zoom) {
+    return cellKey(cellCoordinate(pp.x, zoom), cellCoordinate(pp.y, zoom));
+}
+
+} // namespace
+
+LatLngBounds PointClusterIndex::Cluster::bounds() const {
+    const int8_t cellZoom = zoom + cellBits;
+    return LatLngBounds(TileID{ cellZoom, int32_t(x), int32_t(y), cellZoom });
+}
+
+bool PointClusterIndex::Cluster::contains(const LatLng& position) const {
+    const PrecisionPoint pp = position.project();
+    return cellCoordinate(pp.x, zoom) == x && cellCoordinate(pp.y, zoom) == y;
+}
+
+void PointClusterIndex::Cluster::updateLayer(const TileID& tileID, AnnotationTileLayer& layer) const {
+    std::unordered_map<std::string, std::string> featureProperties;
+    featureProperties.emplace("sprite", "default_marker");
+    featureProperties.emplace("cluster", "true");
+    featureProperties.emplace("point_count", std::to_string(count));
+
+    const uint16_t extent = 4096;
+    const uint32_t z2 = 1 << tileID.z;
+    const Coordinate coordinate(extent * (center.x * z2 - tileID.x), extent * (center.y * z2 - tileID.y));
+
+    layer.features.emplace_back(
+        std::make_shared<const AnnotationTileFeature>(FeatureType::Point,
+                                                      GeometryCollection {{ {{ coordinate }} }},
+                                                      featureProperties));
+}
+
+PointClusterIndex::PointClusterIndex(uint8_t maxZoom_)
+    : maxZoom(maxZoom_),
+      levels(maxZoom + 1) {
+}
+
+void PointClusterIndex::load(const std::vector<LatLng>& positions) {
+    levels.assign(maxZoom + 1, Level());
+    points = positions.size();
+
+    Level& top = levels[maxZoom];
+    top.reserve(positions.size());
+    for (const auto& position : positions) {
+        const PrecisionPoint pp = position.project();
+        Cell& cell = top[cellKey(pp, maxZoom)];
+        cell.count++;
+        cell.x += pp.x;
+        cell.y += pp.y;
+    }
+
+    // Every cell is the sum of its four quadrants on the level above.
+    for (int z = maxZoom - 1; z >= 0; z--) {
+        const Level& children = levels[z + 1];
+        Level& level = levels[z];
+        level.reserve(children.size() / 2);
+        for (const auto& child : children) {
+            const uint32_t x = uint32_t(child.first >> 32) >> 1;
+            const uint32_t y = uint32_t(child.first) >> 1;
+            Cell& cell = level[cellKey(x, y)];
+            cell.count += child.second.count;
+            cell.x += child.second.x;
+            cell.y += child.second.y;
+        }
+    }
+}
+
+void PointClusterIndex::insert(const LatLng& position) {
+    const PrecisionPoint pp = position.project();
+    for (uint8_t z = 0; z <= maxZoom; z++) {
+        Cell& cell = levels[z][cellKey(pp, z)];
+        cell.count++;
+        cell.x += pp.x;
+        cell.y += pp.y;
+    }
+    points++;
+}
+
+void PointClusterIndex::remove(const LatLng& position) {
+    const PrecisionPoint pp = position.project();
+    // Starts at the top, so that a point that isn't in the index doesn't change any level.
+    for (int z = maxZoom; z >= 0; z--) {
+        auto it = levels[z].find(cellKey(pp, z));
+        if (it == levels[z].end()) {
+            return;
+        }
+        if (--it->second.count == 0) {
+            levels[z].erase(it);
+        } else {
+            it->second.x -= pp.x;
+            it->second.y -= pp.y;
+        }
+    }
+    points--;
+}
+
+std::vector<PointClusterIndex::Cluster> PointClusterIndex::getClusters(const TileID& tileID) const {
+    std::vector<Cluster> clusters;
+
+    if (tileID.z < 0 || tileID.z > maxZoom) {
+        return clusters;
+    }
+
+    const int32_t tiles = 1 << tileID.z;
+    if (tileID.x < 0 || tileID.x >= tiles || tileID.y < 0 || tileID.y >= tiles) {
+        return clusters;
+    }
+
+    const Level& level = levels[tileID.z];
+    const uint32_t cells = 1 << cellBits;
+    const uint32_t minX = uint32_t(tileID.x) << cellBits;
+    const uint32_t minY = uint32_t(tileID.y) << cellBits;
+
+    for (uint32_t y = minY; y < minY + cells; y++) {
+        for (uint32_t x = minX; x < minX + cells; x++) {
+            auto it = level.find(cellKey(x, y));
+            if (it != level.end()) {
+                const Cell& cell = it->second;
+                clusters.push_back({ uint8_t(tileID.z), x, y, cell.count,
+                                     { cell.x / cell.count, cell.y / cell.count } });
+            }
+        }
+    }
+
+    return clusters;
+}
+
+PointClusterIndex::Statistics PointClusterIndex::getStatistics() const {
+    Statistics statistics;
+    statistics.points = points;
+    for (const auto& level : levels) {
+        statistics.cells += level.size();
+    }
+    return statistics;
+}
+
+} // namespace mbgl
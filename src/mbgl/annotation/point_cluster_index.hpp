@@ -0,0 +1,79 @@
+#ifndef MBGL_POINT_CLUSTER_INDEX
+#define MBGL_POINT_CLUSTER_INDEX
+
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+class TileID;
+class AnnotationTileLayer;
+
+// Groups point annotations into clusters for every zoom level up to a maximum, so that tiles at
+// low zoom levels carry one feature per cluster instead of one per point. Every tile is divided
+// into a grid of cells, and the points in a cell form a cluster at the mean of their positions.
+// The cells of one zoom level are the quadrants of the cells of the level below, so the levels
+// form a pyramid: it is built bottom-up in one pass, and points are inserted or removed by
+// updating the one cell per level that contains them.
+class PointClusterIndex : private util::noncopyable {
+public:
+    // Tiles are divided into 2^cellBits × 2^cellBits cells, i.e. 64 pixels wide on 512 pixel tiles.
+    static const uint8_t cellBits = 3;
+
+    struct Cluster {
+        uint8_t zoom;
+        // The position of the cell, in cells of this zoom level.
+        uint32_t x;
+        uint32_t y;
+        uint32_t count;
+        // The mean position of the points, in projected coordinates.
+        PrecisionPoint center;
+
+        LatLngBounds bounds() const;
+        bool contains(const LatLng&) const;
+        void updateLayer(const TileID&, AnnotationTileLayer&) const;
+    };
+
+    struct Statistics {
+        std::size_t points = 0;
+        // Non-empty cells of all zoom levels.
+        std::size_t cells = 0;
+    };
+
+    explicit PointClusterIndex(uint8_t maxZoom = 12);
+
+    // Replaces the contents of the index.
+    void load(const std::vector<LatLng>&);
+
+    void insert(const LatLng&);
+    void remove(const LatLng&);
+
+    // Returns the clusters of the cells within the tile, including those of a single point.
+    std::vector<Cluster> getClusters(const TileID&) const;
+
+    Statistics getStatistics() const;
+
+    const uint8_t maxZoom;
+
+private:
+    struct Cell {
+        uint32_t count = 0;
+        // The sum of the projected positions, for the mean.
+        double x = 0;
+        double y = 0;
+    };
+
+    // The x position of the cell in the upper, and the y position in the lower 32 bits.
+    using Level = std::unordered_map<uint64_t, Cell>;
+
+    std::vector<Level> levels;
+    std::size_t points = 0;
+};
+
+} // namespace mbgl
+
+#endif
@@ -146,7 +146,7 @@ void ShapeAnnotationImpl::updateTile(const TileID& tileID, AnnotationTile& tile)
 }
 
 LatLngBounds ShapeAnnotationImpl::bounds() const {
-    LatLngBounds result;
+    LatLngBounds result = LatLngBounds::getExtendable();
 
     for (const auto& segment : shape.segments) {
         for (const auto& point : segment) {
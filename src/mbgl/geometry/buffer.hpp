@@ -39,6 +39,12 @@ public:
         return pos == 0;
     }
 
+    // Returns the number of bytes of data in this buffer, whether they are still held in CPU
+    // memory or were already uploaded to the GPU.
+    inline std::size_t bytes() const {
+        return static_cast<std::size_t>(pos);
+    }
+
     // Transfers this buffer to the GPU and binds the buffer to the GL context.
     void bind() {
         if (buffer) {
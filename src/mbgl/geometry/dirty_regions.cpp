@@ -0,0 +1,154 @@
+#include <mbgl/geometry/dirty_regions.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace mbgl {
+
+namespace {
+
+// A separate upload only pays off if merging two regions would upload more than this many
+// additional pixels.
+const uint64_t mergeSlack = 64 * 64;
+
+// Beyond this many regions, they are merged into their bounding box.
+const std::size_t maxRegions = 32;
+
+uint64_t area(const Rect<uint32_t>& rect) {
+    return uint64_t(rect.w) * rect.h;
+}
+
+bool intersects(const Rect<uint32_t>& a, const Rect<uint32_t>& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+Rect<uint32_t> boundingBox(const Rect<uint32_t>& a, const Rect<uint32_t>& b) {
+    const uint32_t x1 = std::min(a.x, b.x);
+    const uint32_t y1 = std::min(a.y, b.y);
+    const uint32_t x2 = std::max(a.x + a.w, b.x + b.w);
+    const uint32_t y2 = std::max(a.y + a.h, b.y + b.h);
+    return { x1, y1, x2 - x1, y2 - y1 };
+}
+
+} // namespace
+
+DirtyRegions::DirtyRegions(uint32_t width_, uint32_t height_, uint32_t bytesPerPixel_)
+    : width(width_), height(height_), bytesPerPixel(bytesPerPixel_) {
+}
+
+void DirtyRegions::add(Rect<uint32_t> rect) {
+    if (rect.x >= width || rect.y >= height) {
+        return;
+    }
+    rect.w = std::min(rect.w, width - rect.x);
+    rect.h = std::min(rect.h, height - rect.y);
+    if (!rect.hasArea()) {
+        return;
+    }
+
+    // Merging may make the region overlap others that it didn't overlap before.
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (auto it = regions.begin(); it != regions.end(); ++it) {
+            const Rect<uint32_t> combined = boundingBox(rect, *it);
+            if (intersects(rect, *it) || area(combined) <= area(rect) + area(*it) + mergeSlack) {
+                rect = combined;
+                regions.erase(it);
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    regions.push_back(rect);
+
+    if (regions.size() > maxRegions) {
+        Rect<uint32_t> all = regions.front();
+        for (const auto& region : regions) {
+            all = boundingBox(all, region);
+        }
+        regions.assign(1, all);
+    }
+}
+
+void DirtyRegions::addAll() {
+    regions.assign(1, Rect<uint32_t> { 0, 0, width, height });
+}
+
+uint32_t DirtyRegions::stagedStride(const Rect<uint32_t>& rect) const {
+    return (rect.w * bytesPerPixel + 3) & ~uint32_t(3);
+}
+
+void DirtyRegions::stage(const void* pixels) {
+    // Regions that weren't uploaded yet are staged again, from the current pixels.
+    for (const auto& region : stagedRegions) {
+        add(region);
+    }
+    stagedRegions.clear();
+
+    std::size_t size = 0;
+    for (const auto& region : regions) {
+        size += std::size_t(stagedStride(region)) * region.h;
+    }
+    staging.resize(size);
+
+    const uint8_t* source = reinterpret_cast<const uint8_t*>(pixels);
+    uint8_t* target = staging.data();
+    for (const auto& region : regions) {
+        const uint32_t stride = stagedStride(region);
+        const std::size_t rowBytes = std::size_t(region.w) * bytesPerPixel;
+        for (uint32_t y = 0; y < region.h; y++) {
+            std::memcpy(target + std::size_t(y) * stride,
+                        source + (std::size_t(region.y + y) * width + region.x) * bytesPerPixel,
+                        rowBytes);
+        }
+        target += std::size_t(stride) * region.h;
+    }
+
+    std::swap(regions, stagedRegions);
+}
+
+void DirtyRegions::upload(GLenum format, bool allocate) {
+    if (allocate) {
+        assert(stagedRegions.size() == 1);
+        assert(stagedRegions.front() == (Rect<uint32_t> { 0, 0, width, height }));
+        MBGL_CHECK_ERROR(glTexImage2D(
+            GL_TEXTURE_2D, // GLenum target
+            0, // GLint level
+            format, // GLint internalformat
+            width, // GLsizei width
+            height, // GLsizei height
+            0, // GLint border
+            format, // GLenum format
+            GL_UNSIGNED_BYTE, // GLenum type
+            staging.data() // const GLvoid* data
+        ));
+    } else {
+        const uint8_t* source = staging.data();
+        for (const auto& region : stagedRegions) {
+            MBGL_CHECK_ERROR(glTexSubImage2D(
+                GL_TEXTURE_2D, // GLenum target
+                0, // GLint level
+                region.x, // GLint xoffset
+                region.y, // GLint yoffset
+                region.w, // GLsizei width
+                region.h, // GLsizei height
+                format, // GLenum format
+                GL_UNSIGNED_BYTE, // GLenum type
+                source // const GLvoid* data
+            ));
+            source += std::size_t(stagedStride(region)) * region.h;
+        }
+    }
+
+    statistics.frameBytes += staging.size();
+    statistics.totalBytes += staging.size();
+    statistics.regions += stagedRegions.size();
+
+    stagedRegions.clear();
+    staging.clear();
+}
+
+} // namespace mbgl
@@ -0,0 +1,67 @@
+#ifndef MBGL_GEOMETRY_DIRTY_REGIONS
+#define MBGL_GEOMETRY_DIRTY_REGIONS
+
+#include <mbgl/platform/gl.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/rect.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+// Tracks the regions of an atlas texture that changed since they were last uploaded, so that only
+// those are uploaded again. Their pixels are staged in a separate buffer while the atlas is locked,
+// and uploaded from there after it is unlocked, so that threads adding images to the atlas don't
+// wait for the GL calls.
+class DirtyRegions : private util::noncopyable {
+public:
+    struct Statistics {
+        // Bytes uploaded since the last call to startFrame().
+        std::size_t frameBytes = 0;
+        std::size_t totalBytes = 0;
+        // The number of regions that were uploaded, each with a separate GL call.
+        std::size_t regions = 0;
+    };
+
+    DirtyRegions(uint32_t width, uint32_t height, uint32_t bytesPerPixel);
+
+    // Marks a region of the atlas as changed. It is clipped to the atlas, and merged with regions
+    // it overlaps or is close to.
+    void add(Rect<uint32_t>);
+    void addAll();
+
+    bool empty() const { return regions.empty(); }
+    const std::vector<Rect<uint32_t>>& getRegions() const { return regions; }
+
+    // Copies the pixels of all changed regions out of the atlas data, and starts tracking changes
+    // anew. Must be called while the atlas is locked.
+    void stage(const void* pixels);
+
+    // Uploads the staged regions to the texture that is currently bound. With `allocate` set, the
+    // texture storage is specified as well; the whole atlas must have been staged then.
+    void upload(GLenum format, bool allocate);
+
+    // Resets the per-frame counter.
+    void startFrame() { statistics.frameBytes = 0; }
+
+    Statistics getStatistics() const { return statistics; }
+
+private:
+    // Rows of staged regions are padded to four bytes, the default GL unpack alignment.
+    uint32_t stagedStride(const Rect<uint32_t>&) const;
+
+    const uint32_t width;
+    const uint32_t height;
+    const uint32_t bytesPerPixel;
+
+    std::vector<Rect<uint32_t>> regions;
+    std::vector<Rect<uint32_t>> stagedRegions;
+    std::vector<uint8_t> staging;
+
+    Statistics statistics;
+};
+
+} // namespace mbgl
+
+#endif
@@ -14,20 +14,29 @@
 
 using namespace mbgl;
 
-GlyphAtlas::GlyphAtlas(uint16_t width_, uint16_t height_)
-    : width(width_),
-      height(height_),
-      bin(width_, height_),
+GlyphAtlas::Page::Page(uint16_t width_, uint16_t height_)
+    : bin(width_, height_),
       data(std::make_unique<uint8_t[]>(width_ * height_)),
+      dirtyRegions(width_, height_, 1),
       dirty(true) {
 }
 
+GlyphAtlas::GlyphAtlas(uint16_t width_, uint16_t height_, std::size_t maxPages_)
+    : width(width_),
+      height(height_),
+      maxPages(std::max<std::size_t>(std::min<std::size_t>(maxPages_, 256), 1)) {
+    pages.emplace_back(std::make_unique<Page>(width_, height_));
+    statistics.pages = 1;
+}
+
 GlyphAtlas::~GlyphAtlas() {
     assert(util::ThreadContext::currentlyOn(util::ThreadType::Map));
 
-    if (texture) {
-        mbgl::util::ThreadContext::getGLObjectStore()->abandonTexture(texture);
-        texture = 0;
+    for (auto& page : pages) {
+        if (page->texture) {
+            mbgl::util::ThreadContext::getGLObjectStore()->abandonTexture(page->texture);
+            page->texture = 0;
+        }
     }
 }
 
@@ -48,32 +57,34 @@ void GlyphAtlas::addGlyphs(uintptr_t tileUID,
             continue;
         }
 
-        const SDFGlyph& sdf = sdf_it->second;
-        Rect<uint16_t> rect = addGlyph(tileUID, stackName, sdf);
-        face.emplace(chr, Glyph{rect, sdf.metrics});
+        face.emplace(chr, addGlyph(tileUID, stackName, sdf_it->second));
     }
 }
 
-Rect<uint16_t> GlyphAtlas::addGlyph(uintptr_t tileUID,
-                                    const std::string& stackName,
-                                    const SDFGlyph& glyph)
+Glyph GlyphAtlas::addGlyph(uintptr_t tileUID,
+                           const std::string& stackName,
+                           const SDFGlyph& glyph)
 {
     // Use constant value for now.
     const uint8_t buffer = 3;
 
-    std::map<uint32_t, GlyphValue>& face = index[stackName];
-    std::map<uint32_t, GlyphValue>::iterator it = face.find(glyph.id);
+    Face& face = index[stackName];
+    Face::iterator it = face.find(glyph.id);
 
     // The glyph is already in this texture.
     if (it != face.end()) {
         GlyphValue& value = it->second;
+        if (value.ids.empty()) {
+            unused.erase(value.unused);
+            statistics.unusedGlyphs--;
+        }
         value.ids.insert(tileUID);
-        return value.rect;
+        return Glyph { value.rect, glyph.metrics, value.page };
     }
 
     // The glyph bitmap has zero width.
     if (glyph.bitmap.empty()) {
-        return Rect<uint16_t>{ 0, 0, 0, 0 };
+        return Glyph { Rect<uint16_t>{ 0, 0, 0, 0 }, glyph.metrics };
     }
 
     uint16_t buffered_width = glyph.metrics.width + buffer * 2;
@@ -90,112 +101,139 @@ Rect<uint16_t> GlyphAtlas::addGlyph(uintptr_t tileUID,
     pack_width += (4 - pack_width % 4);
     pack_height += (4 - pack_height % 4);
 
-    Rect<uint16_t> rect = bin.allocate(pack_width, pack_height);
-    if (rect.w == 0) {
+    uint8_t pageIndex = 0;
+    Rect<uint16_t> rect;
+    if (!allocate(pack_width, pack_height, pageIndex, rect)) {
         Log::Error(Event::OpenGL, "glyph bitmap overflow");
-        return rect;
+        statistics.overflows++;
+        return Glyph { rect, glyph.metrics };
     }
 
     assert(rect.x + rect.w <= width);
     assert(rect.y + rect.h <= height);
 
-    face.emplace(glyph.id, GlyphValue { rect, tileUID });
+    face.emplace(glyph.id, GlyphValue { pageIndex, rect, tileUID });
+    statistics.glyphs++;
 
     // Copy the bitmap
+    Page& page = *pages[pageIndex];
     const uint8_t* source = reinterpret_cast<const uint8_t*>(glyph.bitmap.data());
     for (uint32_t y = 0; y < buffered_height; y++) {
         uint32_t y1 = width * (rect.y + y + padding) + rect.x + padding;
         uint32_t y2 = buffered_width * y;
         for (uint32_t x = 0; x < buffered_width; x++) {
-            data[y1 + x] = source[y2 + x];
+            page.data[y1 + x] = source[y2 + x];
+        }
+    }
+
+    page.dirtyRegions.add({ rect.x, rect.y, rect.w, rect.h });
+    page.dirty = true;
+
+    return Glyph { rect, glyph.metrics, pageIndex };
+}
+
+bool GlyphAtlas::allocate(uint16_t packWidth, uint16_t packHeight, uint8_t& pageIndex, Rect<uint16_t>& rect) {
+    for (std::size_t i = 0; i < pages.size(); i++) {
+        rect = pages[i]->bin.allocate(packWidth, packHeight);
+        if (rect.w != 0) {
+            pageIndex = uint8_t(i);
+            return true;
+        }
+    }
+
+    // Make room by evicting glyphs that no tile uses, least recently used first. Only the page
+    // that held the evicted glyph can have gained enough room.
+    while (!unused.empty()) {
+        const UnusedGlyph glyph = unused.front();
+        unused.pop_front();
+
+        auto it = glyph.face->find(glyph.id);
+        assert(it != glyph.face->end());
+        const uint8_t evictedPage = it->second.page;
+        const Rect<uint16_t> evictedRect = it->second.rect;
+        glyph.face->erase(it);
+
+        Page& page = *pages[evictedPage];
+        clear(page, evictedRect);
+        page.bin.release(evictedRect);
+        statistics.glyphs--;
+        statistics.unusedGlyphs--;
+        statistics.evictions++;
+
+        rect = page.bin.allocate(packWidth, packHeight);
+        if (rect.w != 0) {
+            pageIndex = evictedPage;
+            return true;
+        }
+    }
+
+    if (pages.size() < maxPages) {
+        pages.emplace_back(std::make_unique<Page>(width, height));
+        statistics.pages = pages.size();
+        rect = pages.back()->bin.allocate(packWidth, packHeight);
+        if (rect.w != 0) {
+            pageIndex = uint8_t(pages.size() - 1);
+            return true;
         }
     }
 
-    dirty = true;
+    return false;
+}
 
-    return rect;
+void GlyphAtlas::clear(Page& page, const Rect<uint16_t>& rect) {
+    uint8_t *target = page.data.get();
+    for (uint32_t y = 0; y < rect.h; y++) {
+        uint32_t y1 = width * (rect.y + y) + rect.x;
+        for (uint32_t x = 0; x < rect.w; x++) {
+            target[y1 + x] = 0;
+        }
+    }
 }
 
 void GlyphAtlas::removeGlyphs(uintptr_t tileUID) {
     std::lock_guard<std::mutex> lock(mtx);
 
     for (auto& faces : index) {
-        std::map<uint32_t, GlyphValue>& face = faces.second;
-        for (auto it = face.begin(); it != face.end(); /* we advance in the body */) {
-            GlyphValue& value = it->second;
-            value.ids.erase(tileUID);
-
-            if (value.ids.empty()) {
-                const Rect<uint16_t>& rect = value.rect;
-
-                // Clear out the bitmap.
-                uint8_t *target = data.get();
-                for (uint32_t y = 0; y < rect.h; y++) {
-                    uint32_t y1 = width * (rect.y + y) + rect.x;
-                    for (uint32_t x = 0; x < rect.w; x++) {
-                        target[y1 + x] = 0;
-                    }
-                }
-
-                bin.release(rect);
-
-                // Make sure to post-increment the iterator: This will return the
-                // current iterator, but will go to the next position before we
-                // erase the element from the map. That way, the iterator stays
-                // valid.
-                face.erase(it++);
-            } else {
-                ++it;
+        Face& face = faces.second;
+        for (auto& it : face) {
+            GlyphValue& value = it.second;
+            if (value.ids.erase(tileUID) && value.ids.empty()) {
+                // Keep the glyph around until its room is needed.
+                value.unused = unused.insert(unused.end(), UnusedGlyph { &face, it.first });
+                statistics.unusedGlyphs++;
             }
         }
     }
 }
 
-void GlyphAtlas::upload() {
-    if (dirty) {
-        const bool first = !texture;
-        bind();
+GlyphAtlas::Page* GlyphAtlas::getPage(std::size_t index_) {
+    std::lock_guard<std::mutex> lock(mtx);
+    return index_ < pages.size() ? pages[index_].get() : nullptr;
+}
 
+void GlyphAtlas::upload() {
+    std::vector<Page*> current;
+    {
         std::lock_guard<std::mutex> lock(mtx);
-
-        if (first) {
-            MBGL_CHECK_ERROR(glTexImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                GL_ALPHA, // GLint internalformat
-                width, // GLsizei width
-                height, // GLsizei height
-                0, // GLint border
-                GL_ALPHA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid* data
-            ));
-        } else {
-            MBGL_CHECK_ERROR(glTexSubImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                0, // GLint xoffset
-                0, // GLint yoffset
-                width, // GLsizei width
-                height, // GLsizei height
-                GL_ALPHA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid* data
-            ));
+        for (auto& page : pages) {
+            current.push_back(page.get());
         }
+    }
 
-        dirty = false;
-
-#if defined(DEBUG)
-        // platform::showDebugImage("Glyph Atlas", reinterpret_cast<char*>(data.get()), width, height);
-#endif
+    for (Page* page : current) {
+        page->dirtyRegions.startFrame();
+        if (page->dirty) {
+            uploadPage(*page);
+        }
     }
 }
 
-void GlyphAtlas::bind() {
-    if (!texture) {
-        MBGL_CHECK_ERROR(glGenTextures(1, &texture));
-        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, texture));
+void GlyphAtlas::uploadPage(Page& page) {
+    const bool first = !page.texture;
+
+    if (first) {
+        MBGL_CHECK_ERROR(glGenTextures(1, &page.texture));
+        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, page.texture));
 #ifndef GL_ES_VERSION_2_0
         MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
 #endif
@@ -204,6 +242,66 @@ void GlyphAtlas::bind() {
         MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
         MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
     } else {
-        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, texture));
+        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, page.texture));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (first) {
+            page.dirtyRegions.addAll();
+        }
+        page.dirtyRegions.stage(page.data.get());
+        page.dirty = false;
     }
-};
+
+    page.dirtyRegions.upload(GL_ALPHA, first);
+
+#if defined(DEBUG)
+    // platform::showDebugImage("Glyph Atlas", reinterpret_cast<char*>(page.data.get()), width, height);
+#endif
+}
+
+GlyphAtlas::Statistics GlyphAtlas::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return statistics;
+}
+
+DirtyRegions::Statistics GlyphAtlas::getUploadStatistics() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    DirtyRegions::Statistics result;
+    for (const auto& page : pages) {
+        const auto pageStatistics = page->dirtyRegions.getStatistics();
+        result.frameBytes += pageStatistics.frameBytes;
+        result.totalBytes += pageStatistics.totalBytes;
+        result.regions += pageStatistics.regions;
+    }
+    return result;
+}
+
+void GlyphAtlas::dumpDebugLogs() const {
+    const auto atlas = getStatistics();
+    Log::Info(Event::General, "GlyphAtlas::pages: %zu/%zu", atlas.pages, maxPages);
+    Log::Info(Event::General, "GlyphAtlas::glyphs: %zu", atlas.glyphs);
+    Log::Info(Event::General, "GlyphAtlas::unusedGlyphs: %zu", atlas.unusedGlyphs);
+    Log::Info(Event::General, "GlyphAtlas::evictions: %zu", atlas.evictions);
+    Log::Info(Event::General, "GlyphAtlas::overflows: %zu", atlas.overflows);
+
+    const auto uploads = getUploadStatistics();
+    Log::Info(Event::General, "GlyphAtlas::frameUploadBytes: %zu", uploads.frameBytes);
+    Log::Info(Event::General, "GlyphAtlas::totalUploadBytes: %zu", uploads.totalBytes);
+    Log::Info(Event::General, "GlyphAtlas::uploadedRegions: %zu", uploads.regions);
+}
+
+void GlyphAtlas::bind(std::size_t index_) {
+    Page* page = getPage(index_);
+    if (!page) {
+        return;
+    }
+
+    if (!page->texture) {
+        // The page was added after this frame's upload.
+        uploadPage(*page);
+    } else {
+        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, page->texture));
+    }
+}
@@ -2,21 +2,40 @@
 #define MBGL_GEOMETRY_GLYPH_ATLAS
 
 #include <mbgl/geometry/binpack.hpp>
+#include <mbgl/geometry/dirty_regions.hpp>
 #include <mbgl/text/glyph_store.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/platform/gl.hpp>
 
 #include <string>
 #include <set>
+#include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <atomic>
+#include <vector>
 
 namespace mbgl {
 
+// Packs the glyphs that tiles use into textures of a fixed size. Glyphs that no tile uses anymore
+// stay in the atlas until their room is needed, so that tiles coming back into view don't upload
+// them again; then the least recently used of them are evicted. When there isn't enough room even
+// so, the atlas grows by another texture page, up to a maximum number of pages. Glyphs report the
+// page they are on, and every page has to be bound separately for drawing.
 class GlyphAtlas : public util::noncopyable {
 public:
-    GlyphAtlas(uint16_t width, uint16_t height);
+    struct Statistics {
+        std::size_t pages = 0;
+        // Glyphs in the atlas, including the ones no tile uses anymore.
+        std::size_t glyphs = 0;
+        std::size_t unusedGlyphs = 0;
+        std::size_t evictions = 0;
+        // Glyphs that didn't fit into the atlas, even after evicting all unused glyphs.
+        std::size_t overflows = 0;
+    };
+
+    GlyphAtlas(uint16_t width, uint16_t height, std::size_t maxPages = 4);
     ~GlyphAtlas();
 
     void addGlyphs(uintptr_t tileUID,
@@ -26,34 +45,69 @@ public:
                    GlyphPositions&);
     void removeGlyphs(uintptr_t tileUID);
 
-    // Binds the atlas texture to the GPU, and uploads data if it is out of date.
-    void bind();
+    // Binds the texture of a page to the GPU, and uploads its data if the page was added after the
+    // last call to upload().
+    void bind(std::size_t page = 0);
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // the texture is only bound when the data is out of date (=dirty). Only the regions that
+    // changed are uploaded. Called once per frame.
     void upload();
 
+    Statistics getStatistics() const;
+    DirtyRegions::Statistics getUploadStatistics() const;
+    void dumpDebugLogs() const;
+
     const GLsizei width;
     const GLsizei height;
+    const std::size_t maxPages;
 
 private:
+    struct Page {
+        Page(uint16_t width, uint16_t height);
+
+        BinPack<uint16_t> bin;
+        const std::unique_ptr<uint8_t[]> data;
+        DirtyRegions dirtyRegions;
+        std::atomic<bool> dirty;
+        GLuint texture = 0;
+    };
+
+    struct GlyphValue;
+    using Face = std::map<uint32_t, GlyphValue>;
+
+    // Refers to a glyph that no tile uses.
+    struct UnusedGlyph {
+        Face* face;
+        uint32_t id;
+    };
+
+    // Least recently used glyphs first.
+    using UnusedGlyphs = std::list<UnusedGlyph>;
+
     struct GlyphValue {
-        GlyphValue(const Rect<uint16_t>& rect_, uintptr_t id)
-            : rect(rect_), ids({ id }) {}
+        GlyphValue(uint8_t page_, const Rect<uint16_t>& rect_, uintptr_t id)
+            : page(page_), rect(rect_), ids({ id }) {}
+        uint8_t page;
         Rect<uint16_t> rect;
         std::set<uintptr_t> ids;
+        // Only valid while no tile uses the glyph.
+        UnusedGlyphs::iterator unused;
     };
 
-    Rect<uint16_t> addGlyph(uintptr_t tileID,
-                            const std::string& stackName,
-                            const SDFGlyph&);
+    Glyph addGlyph(uintptr_t tileID,
+                   const std::string& stackName,
+                   const SDFGlyph&);
+    bool allocate(uint16_t width, uint16_t height, uint8_t& page, Rect<uint16_t>&);
+    void clear(Page&, const Rect<uint16_t>&);
+    Page* getPage(std::size_t);
+    void uploadPage(Page&);
 
-    std::mutex mtx;
-    BinPack<uint16_t> bin;
-    std::map<std::string, std::map<uint32_t, GlyphValue>> index;
-    const std::unique_ptr<uint8_t[]> data;
-    std::atomic<bool> dirty;
-    GLuint texture = 0;
+    mutable std::mutex mtx;
+    std::vector<std::unique_ptr<Page>> pages;
+    std::map<std::string, Face> index;
+    UnusedGlyphs unused;
+    Statistics statistics;
 };
 
 };
@@ -47,8 +47,8 @@ bool CircleLayer::recalculate(const StyleCalculationParameters& parameters) {
 std::unique_ptr<Bucket> CircleLayer::createBucket(StyleBucketParameters& parameters) const {
     auto bucket = std::make_unique<CircleBucket>();
 
-    parameters.eachFilteredFeature(filter, [&] (const auto& feature) {
-        bucket->addGeometry(feature.getGeometries());
+    parameters.eachFilteredFeature(filter, [&] (const auto&, const auto& geometries) {
+        bucket->addGeometry(geometries);
     });
 
     return std::move(bucket);
@@ -1,6 +1,8 @@
 #include <mbgl/layer/fill_layer.hpp>
 #include <mbgl/style/style_bucket_parameters.hpp>
 #include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/map/tile_id.hpp>
+#include <mbgl/util/constants.hpp>
 
 namespace mbgl {
 
@@ -58,10 +60,13 @@ bool FillLayer::recalculate(const StyleCalculationParameters& parameters) {
 }
 
 std::unique_ptr<Bucket> FillLayer::createBucket(StyleBucketParameters& parameters) const {
-    auto bucket = std::make_unique<FillBucket>();
+    // Drops vertices that are less than an eighth of a pixel off the outline at the zoom level of
+    // the tile, which doesn't show even on high resolution screens.
+    const float tolerance = 4096.0f / (util::tileSize * parameters.tileID.overscaling) / 8;
+    auto bucket = std::make_unique<FillBucket>(tolerance);
 
-    parameters.eachFilteredFeature(filter, [&] (const auto& feature) {
-        bucket->addGeometry(feature.getGeometries());
+    parameters.eachFilteredFeature(filter, [&] (const auto&, const auto& geometries) {
+        bucket->addGeometry(geometries, parameters.checkpoint);
     });
 
     return std::move(bucket);
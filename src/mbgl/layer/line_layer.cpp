@@ -79,8 +79,8 @@ std::unique_ptr<Bucket> LineLayer::createBucket(StyleBucketParameters& parameter
     bucket->layout.miterLimit.calculate(p);
     bucket->layout.roundLimit.calculate(p);
 
-    parameters.eachFilteredFeature(filter, [&] (const auto& feature) {
-        bucket->addGeometry(feature.getGeometries());
+    parameters.eachFilteredFeature(filter, [&] (const auto&, const auto& geometries) {
+        bucket->addGeometry(geometries);
     });
 
     return std::move(bucket);
@@ -166,7 +166,7 @@ std::unique_ptr<Bucket> SymbolLayer::createBucket(StyleBucketParameters& paramet
     bucket->layout.icon.size.calculate(StyleCalculationParameters(p.z + 1));
     bucket->layout.text.size.calculate(StyleCalculationParameters(p.z + 1));
 
-    bucket->parseFeatures(parameters.layer, filter);
+    bucket->parseFeatures(parameters.layer, filter, parameters.checkpoint);
 
     if (bucket->needsDependencies(parameters.glyphStore, parameters.spriteStore)) {
         parameters.partialParse = true;
@@ -181,7 +181,8 @@ std::unique_ptr<Bucket> SymbolLayer::createBucket(StyleBucketParameters& paramet
                             parameters.spriteAtlas,
                             parameters.glyphAtlas,
                             parameters.glyphStore,
-                            parameters.collisionTile);
+                            parameters.collisionTile,
+                            parameters.checkpoint);
     }
 
     return std::move(bucket);
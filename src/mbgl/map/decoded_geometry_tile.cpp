@@ -0,0 +1,180 @@
+#include <mbgl/map/decoded_geometry_tile.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+// Reads a feature from the arrays of the layer. A single object is moved from one feature to the
+// next while iterating over the layer.
+class DecodedGeometryTileLayer::Feature : public GeometryTileFeature {
+public:
+    Feature(const DecodedGeometryTileLayer& layer_, std::size_t index_)
+        : index(index_), layer(layer_) {}
+
+    FeatureType getType() const override { return record().type; }
+    mapbox::util::optional<Value> getValue(const std::string&) const override;
+    GeometryCollection getGeometries() const override;
+    const GeometryCollection& readGeometries(GeometryCollection&) const override;
+    const Value* getInternedValue(uint32_t) const override;
+    void eachInternedValue(const std::function<void (uint32_t, const Value&)>&) const override;
+
+    std::size_t index;
+
+private:
+    const Record& record() const { return layer.records[index]; }
+
+    const DecodedGeometryTileLayer& layer;
+};
+
+mapbox::util::optional<Value> DecodedGeometryTileLayer::Feature::getValue(const std::string& key) const {
+    if (!layer.hasKeyIDs()) {
+        return layer.sources[index]->getValue(key);
+    }
+
+    const auto keyID = layer.getKeyID(key);
+    if (!keyID) {
+        return {};
+    }
+
+    const Value* value = getInternedValue(*keyID);
+    if (!value) {
+        return {};
+    }
+
+    return *value;
+}
+
+GeometryCollection DecodedGeometryTileLayer::Feature::getGeometries() const {
+    GeometryCollection lines;
+    readGeometries(lines);
+    return lines;
+}
+
+const GeometryCollection& DecodedGeometryTileLayer::Feature::readGeometries(GeometryCollection& lines) const {
+    const Record& feature = record();
+    const std::size_t count = feature.endRing - feature.firstRing;
+
+    // Reuse the lines already present in the buffer, along with their allocated storage.
+    if (lines.size() < count) {
+        const std::size_t size = lines.size();
+        lines.resize(count);
+        for (std::size_t i = size; i < count && !layer.spareLines.empty(); i++) {
+            lines[i].swap(layer.spareLines.back());
+            layer.spareLines.pop_back();
+        }
+    } else {
+        for (std::size_t i = count; i < lines.size(); i++) {
+            layer.spareLines.push_back(std::move(lines[i]));
+        }
+    }
+
+    uint32_t begin = feature.firstRing == 0 ? 0 : layer.rings[feature.firstRing - 1];
+    for (std::size_t i = 0; i < count; i++) {
+        const uint32_t end = layer.rings[feature.firstRing + i];
+        lines[i].assign(layer.coordinates.begin() + begin, layer.coordinates.begin() + end);
+        begin = end;
+    }
+
+    lines.resize(count);
+    return lines;
+}
+
+const Value* DecodedGeometryTileLayer::Feature::getInternedValue(uint32_t keyID) const {
+    // The properties of a feature are ordered by key ID.
+    const Record& feature = record();
+    const auto begin = layer.properties.begin() + feature.firstProperty;
+    const auto end = layer.properties.begin() + feature.endProperty;
+    auto it = std::lower_bound(begin, end, keyID, [] (const std::pair<uint32_t, const Value*>& property, uint32_t id) {
+        return property.first < id;
+    });
+    if (it == end || it->first != keyID) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void DecodedGeometryTileLayer::Feature::eachInternedValue(const std::function<void (uint32_t, const Value&)>& function) const {
+    const Record& feature = record();
+    for (uint32_t i = feature.firstProperty; i < feature.endProperty; i++) {
+        function(layer.properties[i].first, *layer.properties[i].second);
+    }
+}
+
+DecodedGeometryTileLayer::DecodedGeometryTileLayer(util::ptr<GeometryTileLayer> layer_)
+    : layer(layer_) {
+    const std::size_t count = layer->featureCount();
+    records.reserve(count);
+
+    // Scratch buffer that is reused for decoding the geometries of all features.
+    GeometryCollection buffer;
+
+    if (layer->hasKeyIDs()) {
+        layer->eachFeature([&] (const GeometryTileFeature& feature) {
+            decode(feature, buffer);
+        });
+    } else {
+        sources.reserve(count);
+        for (std::size_t i = 0; i < count; i++) {
+            sources.push_back(layer->getFeature(i));
+            decode(*sources.back(), buffer);
+        }
+    }
+}
+
+void DecodedGeometryTileLayer::decode(const GeometryTileFeature& feature, GeometryCollection& buffer) {
+    Record record;
+    record.type = feature.getType();
+
+    record.firstRing = rings.size();
+    for (const auto& ring : feature.readGeometries(buffer)) {
+        coordinates.insert(coordinates.end(), ring.begin(), ring.end());
+        rings.push_back(coordinates.size());
+    }
+    record.endRing = rings.size();
+
+    record.firstProperty = properties.size();
+    feature.eachInternedValue([&] (uint32_t keyID, const Value& value) {
+        properties.emplace_back(keyID, &value);
+    });
+    record.endProperty = properties.size();
+
+    records.push_back(record);
+}
+
+util::ptr<const GeometryTileFeature> DecodedGeometryTileLayer::getFeature(std::size_t i) const {
+    return std::make_shared<Feature>(*this, i);
+}
+
+bool DecodedGeometryTileLayer::everyFeature(const std::function<bool (const GeometryTileFeature&)>& function) const {
+    Feature feature(*this, 0);
+    for (; feature.index < records.size(); feature.index++) {
+        if (!function(feature)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DecodedGeometryTile::DecodedGeometryTile(const GeometryTile& tile_)
+    : tile(tile_) {
+}
+
+util::ptr<GeometryTileLayer> DecodedGeometryTile::getLayer(const std::string& name) const {
+    auto it = layers.find(name);
+    if (it != layers.end()) {
+        return it->second;
+    }
+
+    const auto start = Clock::now();
+
+    util::ptr<GeometryTileLayer> decoded;
+    if (auto layer = tile.getLayer(name)) {
+        decoded = std::make_shared<DecodedGeometryTileLayer>(layer);
+    }
+    layers.emplace(name, decoded);
+
+    decodeTime += Clock::now() - start;
+    return decoded;
+}
+
+} // namespace mbgl
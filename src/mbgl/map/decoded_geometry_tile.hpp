@@ -0,0 +1,83 @@
+#ifndef MBGL_MAP_DECODED_GEOMETRY_TILE
+#define MBGL_MAP_DECODED_GEOMETRY_TILE
+
+#include <mbgl/map/geometry_tile.hpp>
+#include <mbgl/util/chrono.hpp>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace mbgl {
+
+// A layer whose features have been decoded from the underlying tile data up front. The types,
+// geometries and properties of all features are stored in a few arrays that are shared by the
+// whole layer, so that decoding and iterating doesn't allocate memory per feature.
+class DecodedGeometryTileLayer : public GeometryTileLayer {
+public:
+    DecodedGeometryTileLayer(util::ptr<GeometryTileLayer>);
+
+    std::size_t featureCount() const override { return records.size(); }
+    util::ptr<const GeometryTileFeature> getFeature(std::size_t) const override;
+
+    // Reuses a single feature object for all features.
+    bool everyFeature(const std::function<bool (const GeometryTileFeature&)>&) const override;
+
+    bool hasKeyIDs() const override { return layer->hasKeyIDs(); }
+    mapbox::util::optional<uint32_t> getKeyID(const std::string& key) const override { return layer->getKeyID(key); }
+
+private:
+    class Feature;
+
+    struct Record {
+        FeatureType type;
+        // Ranges in the rings and properties arrays.
+        uint32_t firstRing;
+        uint32_t endRing;
+        uint32_t firstProperty;
+        uint32_t endProperty;
+    };
+
+    void decode(const GeometryTileFeature&, GeometryCollection& buffer);
+
+    const util::ptr<GeometryTileLayer> layer;
+    std::vector<Record> records;
+
+    // The coordinates of all rings of all features, and the end of every ring in it.
+    std::vector<Coordinate> coordinates;
+    std::vector<uint32_t> rings;
+
+    // The interned properties of all features, ordered by key ID within each feature, if the layer
+    // supports key IDs. The values are owned by the underlying layer.
+    std::vector<std::pair<uint32_t, const Value*>> properties;
+
+    // Otherwise, the underlying features, for looking up their properties.
+    std::vector<util::ptr<const GeometryTileFeature>> sources;
+
+    // Lines that geometry buffers had no use for, along with their allocated storage, for
+    // features with more lines. A decoded tile is only used by a single thread.
+    mutable GeometryCollection spareLines;
+};
+
+// Wraps a GeometryTile for the duration of a single parse and decodes every source layer at most
+// once, no matter how many style layers reference it. The wrapped tile must outlive this object.
+class DecodedGeometryTile : public GeometryTile {
+public:
+    DecodedGeometryTile(const GeometryTile&);
+
+    util::ptr<GeometryTileLayer> getLayer(const std::string&) const override;
+
+    // Accumulated time spent decoding source layers.
+    Duration getDecodeTime() const { return decodeTime; }
+
+private:
+    const GeometryTile& tile;
+
+    // Also stores null pointers for source layers that don't exist in the tile.
+    mutable std::unordered_map<std::string, util::ptr<GeometryTileLayer>> layers;
+    mutable Duration decodeTime = Duration::zero();
+};
+
+} // namespace mbgl
+
+#endif
@@ -1,9 +1,32 @@
 #include <mbgl/map/geometry_tile.hpp>
 #include <mbgl/style/filter_expression.hpp>
 #include <mbgl/style/filter_expression_private.hpp>
+#include <mbgl/style/compiled_filter_private.hpp>
 
 namespace mbgl {
 
+const GeometryCollection& GeometryTileFeature::readGeometries(GeometryCollection& buffer) const {
+    buffer = getGeometries();
+    return buffer;
+}
+
+void GeometryTileLayer::eachFeature(const std::function<void (const GeometryTileFeature&)>& function) const {
+    everyFeature([&] (const GeometryTileFeature& feature) {
+        function(feature);
+        return true;
+    });
+}
+
+bool GeometryTileLayer::everyFeature(const std::function<bool (const GeometryTileFeature&)>& function) const {
+    const std::size_t count = featureCount();
+    for (std::size_t i = 0; i < count; i++) {
+        if (!function(*getFeature(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 mapbox::util::optional<Value> GeometryTileFeatureExtractor::getValue(const std::string& key) const {
     if (key == "$type") {
         return Value(uint64_t(feature.getType()));
@@ -12,6 +35,30 @@ mapbox::util::optional<Value> GeometryTileFeatureExtractor::getValue(const std::
     return feature.getValue(key);
 }
 
+GeometryTileLayerFilter::GeometryTileLayerFilter(const GeometryTileLayer& layer,
+                                                 const CompiledFilter& filter_)
+    : filter(filter_),
+      keyed(layer.hasKeyIDs()) {
+    if (keyed) {
+        for (const auto& key : filter.getKeys()) {
+            keyIDs.push_back(layer.getKeyID(key));
+        }
+    }
+}
+
+bool GeometryTileLayerFilter::operator()(const GeometryTileFeature& feature) const {
+    if (keyed) {
+        return filter.evaluate(feature.getType(), [&] (std::size_t key) -> const Value* {
+            const auto& keyID = keyIDs[key];
+            return keyID ? feature.getInternedValue(*keyID) : nullptr;
+        });
+    } else {
+        return filter.evaluate(feature.getType(), [&] (std::size_t key) {
+            return feature.getValue(filter.getKeys()[key]);
+        });
+    }
+}
+
 template bool evaluate(const FilterExpression&, const GeometryTileFeatureExtractor&);
 
 }
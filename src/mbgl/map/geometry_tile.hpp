@@ -31,6 +31,20 @@ public:
     virtual FeatureType getType() const = 0;
     virtual mapbox::util::optional<Value> getValue(const std::string& key) const = 0;
     virtual GeometryCollection getGeometries() const = 0;
+
+    // Decodes the geometries into the caller-provided buffer, reusing its allocated storage.
+    // The returned reference either points to the buffer or, when the feature already holds
+    // decoded geometries, to the feature's own storage. It remains valid until the buffer is
+    // modified or the feature is destroyed or reused.
+    virtual const GeometryCollection& readGeometries(GeometryCollection& buffer) const;
+
+    // Looks up a value by a key ID obtained from GeometryTileLayer::getKeyID. Returns null if the
+    // feature doesn't have a value for this key. The value is owned by the layer.
+    virtual const Value* getInternedValue(uint32_t) const { return nullptr; }
+
+    // Calls the function with the key ID and the value of every property of the feature, in
+    // ascending order of key IDs, if the layer supports key IDs. The values are owned by the layer.
+    virtual void eachInternedValue(const std::function<void (uint32_t, const Value&)>&) const {}
 };
 
 class GeometryTileLayer : private util::noncopyable {
@@ -38,6 +52,22 @@ public:
     virtual ~GeometryTileLayer() = default;
     virtual std::size_t featureCount() const = 0;
     virtual util::ptr<const GeometryTileFeature> getFeature(std::size_t) const = 0;
+
+    // Calls the function for every feature of this layer, in order. The feature reference is
+    // only valid for the duration of the call: implementations may reuse a single feature
+    // object for all features to avoid allocating one per feature.
+    void eachFeature(const std::function<void (const GeometryTileFeature&)>&) const;
+
+    // Like eachFeature, but stops as soon as the function returns false. Returns whether all
+    // features were visited.
+    virtual bool everyFeature(const std::function<bool (const GeometryTileFeature&)>&) const;
+
+    // Layers may intern the property keys of their features. In that case, getKeyID resolves a
+    // key to an ID that is valid for all features of this layer, or returns nothing if no feature
+    // has this key. Values can then be looked up with GeometryTileFeature::getInternedValue,
+    // which avoids string comparisons and copying values for every feature.
+    virtual bool hasKeyIDs() const { return false; }
+    virtual mapbox::util::optional<uint32_t> getKeyID(const std::string&) const { return {}; }
 };
 
 class GeometryTile : private util::noncopyable {
@@ -47,6 +77,7 @@ public:
 };
 
 class FileRequest;
+class CompiledFilter;
 
 class GeometryTileMonitor : private util::noncopyable {
 public:
@@ -74,6 +105,22 @@ private:
     const GeometryTileFeature& feature;
 };
 
+// Evaluates a compiled filter against the features of a single layer. If the layer supports
+// key IDs, the keys of the filter are resolved once up front rather than for every feature.
+class GeometryTileLayerFilter {
+public:
+    GeometryTileLayerFilter(const GeometryTileLayer&, const CompiledFilter&);
+
+    bool operator()(const GeometryTileFeature&) const;
+
+private:
+    const CompiledFilter& filter;
+    const bool keyed;
+
+    // The layer's key IDs for the filter's keys.
+    std::vector<mapbox::util::optional<uint32_t>> keyIDs;
+};
+
 }
 
 #endif
@@ -14,6 +14,10 @@
 
 namespace mbgl {
 
+// The number of points along the remainder of an animated transition, including its destination,
+// for which tiles are prefetched.
+const std::size_t cameraPathSamples = 4;
+
 Map::Map(View& view_, FileSource& fileSource, MapMode mapMode, GLContextMode contextMode, ConstrainMode constrainMode)
     : view(view_),
       transform(std::make_unique<Transform>(view, constrainMode)),
@@ -91,7 +95,8 @@ void Map::update(Update flags) {
     if (flags & Update::Dimensions) {
         transform->resize(view.getSize());
     }
-    context->invoke(&MapContext::triggerUpdate, transform->getState(), flags);
+    context->invoke(&MapContext::triggerUpdate, transform->getState(), flags,
+                    transform->getTransitionPath(cameraPathSamples));
 }
 
 #pragma mark - Style
@@ -398,6 +403,15 @@ void Map::removeAnnotations(const AnnotationIDs& annotations) {
     update(Update::Annotations);
 }
 
+void Map::setPointAnnotationClustering(bool enabled) {
+    data->getAnnotationManager()->setPointClustering(enabled);
+    update(Update::Annotations);
+}
+
+bool Map::getPointAnnotationClustering() const {
+    return data->getAnnotationManager()->getPointClustering();
+}
+
 AnnotationIDs Map::getPointAnnotationsInBounds(const LatLngBounds& bounds) {
     return data->getAnnotationManager()->getPointAnnotationsInBounds(bounds);
 }
@@ -448,6 +462,15 @@ bool Map::getCollisionDebug() const {
     return data->getCollisionDebug();
 }
 
+void Map::setCollisionIndex(CollisionIndex index) {
+    data->setCollisionIndex(index);
+    update(Update::Repaint);
+}
+
+CollisionIndex Map::getCollisionIndex() const {
+    return data->getCollisionIndex();
+}
+
 bool Map::isFullyLoaded() const {
     return context->invokeSync<bool>(&MapContext::isLoaded);
 }
@@ -504,8 +527,16 @@ Duration Map::getDefaultTransitionDelay() const {
     return data->getDefaultTransitionDelay();
 }
 
-void Map::setSourceTileCacheSize(size_t size) {
-    context->invoke(&MapContext::setSourceTileCacheSize, size);
+void Map::setTileCacheSize(size_t size) {
+    context->invoke(&MapContext::setTileCacheSize, size);
+}
+
+void Map::setPrefetchTileBudget(uint16_t budget) {
+    data->setPrefetchTileBudget(budget);
+}
+
+uint16_t Map::getPrefetchTileBudget() const {
+    return data->getPrefetchTileBudget();
 }
 
 void Map::onLowMemory() {
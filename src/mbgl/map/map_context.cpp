@@ -80,8 +80,9 @@ void MapContext::pause() {
     asyncInvalidate->send();
 }
 
-void MapContext::triggerUpdate(const TransformState& state, const Update flags) {
+void MapContext::triggerUpdate(const TransformState& state, const Update flags, std::vector<TransformState> path) {
     transformState = state;
+    cameraPath = std::move(path);
     updateFlags |= flags;
 
     asyncUpdate->send();
@@ -97,6 +98,9 @@ void MapContext::setStyleURL(const std::string& url) {
     styleJSON.clear();
 
     style = std::make_unique<Style>(data);
+    if (tileCacheSize) {
+        style->tileCache.setSize(tileCacheSize);
+    }
 
     const size_t pos = styleURL.rfind('/');
     std::string base = "";
@@ -135,6 +139,9 @@ void MapContext::setStyleJSON(const std::string& json, const std::string& base)
     styleJSON = json;
 
     style = std::make_unique<Style>(data);
+    if (tileCacheSize) {
+        style->tileCache.setSize(tileCacheSize);
+    }
 
     loadStyleJSON(json, base);
 }
@@ -185,6 +192,8 @@ void MapContext::update() {
     style->update(transformState, *texturePool);
 
     if (data.mode == MapMode::Continuous) {
+        style->prefetch(cameraPath, *texturePool);
+
         asyncInvalidate->send();
     } else if (callback && style->isLoaded()) {
         renderSync(transformState, frameData);
@@ -277,24 +286,21 @@ double MapContext::getTopOffsetPixelsForAnnotationSymbol(const std::string& symb
     }
 }
 
-void MapContext::setSourceTileCacheSize(size_t size) {
+void MapContext::setTileCacheSize(size_t size) {
     assert(util::ThreadContext::currentlyOn(util::ThreadType::Map));
-    if (size != sourceCacheSize) {
-        sourceCacheSize = size;
+    if (size != tileCacheSize) {
+        tileCacheSize = size;
         if (!style) return;
-        for (const auto &source : style->sources) {
-            source->setCacheSize(sourceCacheSize);
-        }
+        style->tileCache.setSize(tileCacheSize);
         asyncInvalidate->send();
     }
 }
 
 void MapContext::onLowMemory() {
     assert(util::ThreadContext::currentlyOn(util::ThreadType::Map));
+    util::ThreadContext::getFileSource()->onLowMemory();
     if (!style) return;
-    for (const auto &source : style->sources) {
-        source->onLowMemory();
-    }
+    style->tileCache.clear();
     asyncInvalidate->send();
 }
 
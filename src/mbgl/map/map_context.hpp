@@ -35,7 +35,7 @@ public:
 
     void pause();
 
-    void triggerUpdate(const TransformState&, Update = Update::Nothing);
+    void triggerUpdate(const TransformState&, Update = Update::Nothing, std::vector<TransformState> cameraPath = {});
     void renderStill(const TransformState&, const FrameData&, Map::StillImageCallback callback);
 
     // Triggers a synchronous render. Returns true if style has been fully loaded.
@@ -51,7 +51,7 @@ public:
     double getTopOffsetPixelsForAnnotationSymbol(const std::string& symbol);
     void updateAnnotations();
 
-    void setSourceTileCacheSize(size_t size);
+    void setTileCacheSize(size_t size);
     void onLowMemory();
 
     void cleanup();
@@ -90,8 +90,12 @@ private:
     std::unique_ptr<FileRequest> styleRequest;
 
     Map::StillImageCallback callback;
-    size_t sourceCacheSize;
+    // Bytes of tile data the style may keep in memory for tiles that are not visible. 0 uses
+    // the default size of the TileCache.
+    size_t tileCacheSize = 0;
     TransformState transformState;
+    // Samples of the remaining path of the camera transition, if any. The last one is its destination.
+    std::vector<TransformState> cameraPath;
     FrameData frameData;
 };
 
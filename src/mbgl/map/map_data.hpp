@@ -69,6 +69,20 @@ public:
         collisionDebug = value;
     }
 
+    inline CollisionIndex getCollisionIndex() const {
+        return collisionIndex;
+    }
+    inline void setCollisionIndex(CollisionIndex index) {
+        collisionIndex = index;
+    }
+
+    inline uint16_t getPrefetchTileBudget() const {
+        return prefetchTileBudget;
+    }
+    inline void setPrefetchTileBudget(uint16_t budget) {
+        prefetchTileBudget = budget;
+    }
+
     inline TimePoint getAnimationTime() const {
         // We're casting the TimePoint to and from a Duration because libstdc++
         // has a bug that doesn't allow TimePoints to be atomic.
@@ -138,6 +152,8 @@ private:
     std::vector<std::string> classes;
     std::atomic<uint8_t> debug { false };
     std::atomic<uint8_t> collisionDebug { false };
+    std::atomic<CollisionIndex> collisionIndex { CollisionIndex::RTree };
+    std::atomic<uint16_t> prefetchTileBudget { 32 };
     std::atomic<Duration> animationTime;
     std::atomic<Duration> defaultFadeDuration;
     std::atomic<Duration> defaultTransitionDuration;
@@ -55,7 +55,7 @@ void RasterTileData::request(float pixelRatio,
             state = State::loaded;
         }
 
-        workRequest = worker.parseRasterTile(std::make_unique<RasterBucket>(texturePool), res.data, [this, callback] (RasterTileParseResult result) {
+        workRequest = worker.parseRasterTile(getPriority(), std::make_unique<RasterBucket>(texturePool), res.data, [this, callback] (RasterTileParseResult result) {
             workRequest.reset();
             if (state != State::loaded) {
                 return;
@@ -80,6 +80,16 @@ Bucket* RasterTileData::getBucket(StyleLayer const&) {
     return bucket.get();
 }
 
+std::size_t RasterTileData::getMemoryUsage() const {
+    return bucket ? bucket->getMemoryUsage() : 0;
+}
+
+void RasterTileData::setRequestPriority(RequestPriority requestPriority) {
+    if (req) {
+        req->setPriority(requestPriority);
+    }
+}
+
 void RasterTileData::cancel() {
     if (state != State::obsolete) {
         state = State::obsolete;
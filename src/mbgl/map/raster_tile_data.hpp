@@ -23,8 +23,11 @@ public:
     void cancel() override;
 
     Bucket* getBucket(StyleLayer const &layer_desc) override;
+    std::size_t getMemoryUsage() const override;
 
 private:
+    void setRequestPriority(RequestPriority) override;
+
     TexturePool& texturePool;
     const SourceInfo& source;
     Worker& worker;
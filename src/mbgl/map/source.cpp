@@ -24,6 +24,7 @@
 #include <mbgl/map/vector_tile_data.hpp>
 #include <mbgl/map/raster_tile_data.hpp>
 #include <mbgl/style/style.hpp>
+#include <mbgl/text/edge_collision_index.hpp>
 #include <mbgl/gl/debugging.hpp>
 
 #include <rapidjson/error/en.h>
@@ -277,39 +278,48 @@ TileData::State Source::addTile(MapData& data,
     }
 
     if (!new_tile.data) {
-        new_tile.data = cache.get(normalized_id.to_uint64());
+        new_tile.data = style.tileCache.get(info.source_id, normalized_id.to_uint64());
     }
 
     if (!new_tile.data) {
-        auto callback = std::bind(&Source::tileLoadingCompleteCallback, this, normalized_id, transformState, data.getCollisionDebug());
-
         // If we don't find working tile data, we're just going to load it.
-        if (info.type == SourceType::Raster) {
-            auto tileData = std::make_shared<RasterTileData>(normalized_id, texturePool, info, style.workers);
-            tileData->request(data.pixelRatio, callback);
-            new_tile.data = tileData;
-        } else {
-            std::unique_ptr<GeometryTileMonitor> monitor;
+        new_tile.data = createTileData(data, transformState, style, texturePool, normalized_id);
+        tile_data.emplace(normalized_id, new_tile.data);
+    }
 
-            if (info.type == SourceType::Vector) {
-                monitor = std::make_unique<VectorTileMonitor>(info, normalized_id, data.pixelRatio);
-            } else if (info.type == SourceType::Annotations) {
-                monitor = std::make_unique<AnnotationTileMonitor>(normalized_id, data);
-            } else {
-                throw std::runtime_error("source type not implemented");
-            }
+    return new_tile.data->getState();
+}
 
-            new_tile.data = std::make_shared<VectorTileData>(normalized_id,
-                                                             std::move(monitor),
-                                                             info.source_id,
-                                                             style,
-                                                             callback);
-        }
+std::shared_ptr<TileData> Source::createTileData(MapData& data,
+                                                 const TransformState& transformState,
+                                                 Style& style,
+                                                 TexturePool& texturePool,
+                                                 const TileID& normalized_id) {
+    const PlacementConfig config { transformState.getAngle(), transformState.getPitch(), data.getCollisionDebug(), data.getCollisionIndex() };
+    auto callback = std::bind(&Source::tileLoadingCompleteCallback, this, normalized_id, config);
 
-        tile_data.emplace(new_tile.data->id, new_tile.data);
+    if (info.type == SourceType::Raster) {
+        auto tileData = std::make_shared<RasterTileData>(normalized_id, texturePool, info, style.workers);
+        tileData->request(data.pixelRatio, callback);
+        return tileData;
     }
 
-    return new_tile.data->getState();
+    std::unique_ptr<GeometryTileMonitor> monitor;
+
+    if (info.type == SourceType::Vector) {
+        monitor = std::make_unique<VectorTileMonitor>(info, normalized_id, data.pixelRatio);
+    } else if (info.type == SourceType::Annotations) {
+        monitor = std::make_unique<AnnotationTileMonitor>(normalized_id, data);
+    } else {
+        throw std::runtime_error("source type not implemented");
+    }
+
+    return std::make_shared<VectorTileData>(normalized_id,
+                                            std::move(monitor),
+                                            info.source_id,
+                                            style,
+                                            callback,
+                                            std::bind(&Source::tilePlacedCallback, this, normalized_id));
 }
 
 double Source::getZoom(const TransformState& state) const {
@@ -362,14 +372,14 @@ std::forward_list<TileID> Source::coveringTiles(const TransformState& state) con
  *
  * @return boolean Whether the children found completely cover the tile.
  */
-bool Source::findLoadedChildren(const TileID& id, int32_t maxCoveringZoom, std::forward_list<TileID>& retain) {
+bool Source::findLoadedChildren(const TileID& id, int32_t maxCoveringZoom, TileIDSet& retain) {
     bool complete = true;
     int32_t z = id.z;
     auto ids = id.children(info.max_zoom);
     for (const auto& child_id : ids) {
         const TileData::State state = hasTile(child_id);
         if (TileData::isReadyState(state)) {
-            retain.emplace_front(child_id);
+            retain.insert(child_id);
         }
         if (state != TileData::State::parsed) {
             complete = false;
@@ -391,12 +401,12 @@ bool Source::findLoadedChildren(const TileID& id, int32_t maxCoveringZoom, std::
  *
  * @return boolean Whether a parent was found.
  */
-void Source::findLoadedParent(const TileID& id, int32_t minCoveringZoom, std::forward_list<TileID>& retain) {
+void Source::findLoadedParent(const TileID& id, int32_t minCoveringZoom, TileIDSet& retain) {
     for (int32_t z = id.z - 1; z >= minCoveringZoom; --z) {
         const TileID parent_id = id.parent(z, info.max_zoom);
         const TileData::State state = hasTile(parent_id);
         if (TileData::isReadyState(state)) {
-            retain.emplace_front(parent_id);
+            retain.insert(parent_id);
             if (state == TileData::State::parsed) {
                 return;
             }
@@ -422,15 +432,36 @@ bool Source::update(MapData& data,
         zoom = std::floor(zoom);
     }
     std::forward_list<TileID> required = coveringTiles(transformState);
+    const PlacementConfig config { transformState.getAngle(), transformState.getPitch(), data.getCollisionDebug(), data.getCollisionIndex() };
+
+    // Placing all tiles again in every frame of a rotation keeps the workers saturated. While the
+    // camera moves, the previous placement is kept until the angle or pitch changed noticeably. The
+    // first update after the camera stopped places the symbols exactly.
+    const bool placementChanged = transformState.isChanging() ? !config.isCloseTo(placementConfig)
+                                                               : config != placementConfig;
+
+    // Most frames only move the camera within the same set of tiles. When all of them are loaded
+    // already and nothing else changed, there is nothing to reconcile.
+    if (!shouldReparsePartialTiles && !placementChanged && isCovered(required)) {
+        updated = data.getAnimationTime();
+        return allTilesUpdated;
+    }
 
     // Determine the overzooming/underzooming amounts.
     int32_t minCoveringZoom = util::clamp<int32_t>(zoom - 10, info.min_zoom, info.max_zoom);
     int32_t maxCoveringZoom = util::clamp<int32_t>(zoom + 1,  info.min_zoom, info.max_zoom);
 
-    // Retain is a list of tiles that we shouldn't delete, even if they are not
+    // Retain is a set of tiles that we shouldn't delete, even if they are not
     // the most ideal tile for the current viewport. This may include tiles like
     // parent or child tiles that are *already* loaded.
-    std::forward_list<TileID> retain(required);
+    TileIDSet retain(required.begin(), required.end());
+
+    // Tiles that weren't part of the previous update.
+    std::vector<TileID> added;
+
+    // Work for tiles closer to the center of the viewport is scheduled first.
+    const TileCoordinate center = transformState.pointToCoordinate({ transformState.getWidth() / 2.0f, transformState.getHeight() / 2.0f })
+        .zoomTo(std::min<int32_t>(coveringZoomLevel(transformState), info.max_zoom));
 
     // Add existing child/parent tiles if the actual tile is not yet loaded
     for (const auto& id : required) {
@@ -446,11 +477,18 @@ bool Source::update(MapData& data,
             break;
         case TileData::State::invalid:
             state = addTile(data, transformState, style, texturePool, id);
+            added.push_back(id);
             break;
         default:
             break;
         }
 
+        auto it = tiles.find(id);
+        if (it != tiles.end() && it->second->data) {
+            it->second->data->setPriority({ WorkPriority::Visible,
+                float(std::fabs(id.x - center.column) + std::fabs(id.y - center.row)) });
+        }
+
         if (!TileData::isReadyState(state)) {
             // The tile we require is not yet loaded. Try to find a parent or
             // child tile that we already have.
@@ -467,84 +505,206 @@ bool Source::update(MapData& data,
         }
     }
 
-    if (info.type != SourceType::Raster && cache.getSize() == 0) {
-        size_t conservativeCacheSize = ((float)transformState.getWidth()  / util::tileSize) *
-                                       ((float)transformState.getHeight() / util::tileSize) *
-                                       (transformState.getMaxZoom() - transformState.getMinZoom() + 1) *
-                                       0.5;
-        cache.setSize(conservativeCacheSize);
-    }
-
-    auto& tileCache = cache;
-    auto& type = info.type;
+    auto& tileCache = style.tileCache;
+    const auto& sourceID = info.source_id;
 
     // Remove tiles that we definitely don't need, i.e. tiles that are not on
     // the required list.
-    std::set<TileID> retain_data;
-    util::erase_if(tiles, [&retain, &retain_data, &tileCache, &type](std::pair<const TileID, std::unique_ptr<Tile>> &pair) {
+    std::size_t removed = 0;
+    std::unordered_set<TileID, TileID::Hash> retain_data;
+    std::vector<util::ptr<TileData>> hidden;
+    util::erase_if(tiles, [&](std::pair<const TileID, std::unique_ptr<Tile>> &pair) {
         Tile &tile = *pair.second;
-        bool obsolete = std::find(retain.begin(), retain.end(), tile.id) == retain.end();
+        bool obsolete = retain.find(tile.id) == retain.end();
         if (!obsolete) {
             retain_data.insert(tile.data->id);
-        } else if (type != SourceType::Raster && tile.data->getState() == TileData::State::parsed) {
-            // Partially parsed tiles are never added to the cache because otherwise
-            // they never get updated if the go out from the viewport and the pending
-            // resources arrive.
-            tileCache.add(tile.id.normalized().to_uint64(), tile.data);
+        } else {
+            removed++;
+            hidden.push_back(tile.data);
+            if (tile.data->getState() == TileData::State::parsed) {
+                // Partially parsed tiles are never added to the cache because otherwise
+                // they never get updated if the go out from the viewport and the pending
+                // resources arrive.
+                tileCache.add(sourceID, tile.id.normalized().to_uint64(), tile.data);
+            }
         }
         return obsolete;
     });
 
-    // Remove all the expired pointers from the set.
-    util::erase_if(tile_data, [&retain_data, &tileCache](std::pair<const TileID, std::weak_ptr<TileData>> &pair) {
-        const util::ptr<TileData> tile = pair.second.lock();
-        if (!tile) {
-            return true;
+    // Tile data is shared by the copies of a tile in the wrapped worlds; it stops being rendered
+    // once none of them is retained.
+    for (const auto& tileData : hidden) {
+        if (retain_data.find(tileData->id) == retain_data.end()) {
+            tileData->setRendered(false);
         }
+    }
+    hidden.clear();
 
-        bool obsolete = retain_data.find(tile->id) == retain_data.end();
-        if (obsolete) {
-            if (!tileCache.has(tile->id.normalized().to_uint64())) {
-                tile->cancel();
+    // Remove all the expired pointers from the set. TileData is only released along with a tile.
+    if (removed) {
+        util::erase_if(tile_data, [&](std::pair<const TileID, std::weak_ptr<TileData>> &pair) {
+            const util::ptr<TileData> tile = pair.second.lock();
+            if (!tile) {
+                return true;
             }
-            return true;
-        } else {
-            return false;
-        }
-    });
 
-    updateTilePtrs();
+            bool obsolete = retain_data.find(tile->id) == retain_data.end() &&
+                            prefetched.find(tile->id) == prefetched.end();
+            if (obsolete) {
+                if (!tileCache.has(sourceID, tile->id.normalized().to_uint64())) {
+                    tile->cancel();
+                }
+                return true;
+            } else {
+                return false;
+            }
+        });
+    }
 
-    for (auto& tilePtr : tilePtrs) {
-        tilePtr->data->redoPlacement(
-            { transformState.getAngle(), transformState.getPitch(), data.getCollisionDebug() });
+    if (removed || !added.empty()) {
+        updateTilePtrs();
     }
 
+    // Placement only has to be redone for all tiles when the configuration changed. Tiles that
+    // finish loading later are placed by tileLoadingCompleteCallback.
+    if (placementChanged) {
+        placementConfig = config;
+        for (auto& tilePtr : tilePtrs) {
+            tilePtr->data->redoPlacement(config);
+        }
+    } else {
+        for (const auto& id : added) {
+            auto it = tiles.find(id);
+            if (it != tiles.end()) {
+                it->second->data->redoPlacement(placementConfig);
+            }
+        }
+    }
+
+    for (const auto& id : added) {
+        auto it = tiles.find(id);
+        if (it != tiles.end() && it->second->data) {
+            it->second->data->setRendered(true);
+        }
+    }
+
+    requiredTiles.clear();
+    requiredTiles.insert(required.begin(), required.end());
+
     updated = data.getAnimationTime();
 
     return allTilesUpdated;
 }
 
-void Source::updateTilePtrs() {
-    tilePtrs.clear();
-    for (const auto& pair : tiles) {
-        tilePtrs.push_back(pair.second.get());
+bool Source::isCovered(const std::forward_list<TileID>& required) const {
+    std::size_t count = 0;
+    for (const auto& id : required) {
+        if (requiredTiles.find(id) == requiredTiles.end()) {
+            return false;
+        }
+        auto it = tiles.find(id);
+        if (it == tiles.end() || !it->second->data || it->second->data->getState() != TileData::State::parsed) {
+            return false;
+        }
+        count++;
     }
+
+    // Any additional parent or child tiles that are retained while loading have to be released.
+    return count == requiredTiles.size() && count == tiles.size();
 }
 
-void Source::setCacheSize(size_t size) {
-    cache.setSize(size);
+void Source::prefetch(MapData& data,
+                      const std::vector<TransformState>& path,
+                      Style& style,
+                      TexturePool& texturePool) {
+    if (!loaded || (info.type != SourceType::Vector && info.type != SourceType::Raster)) {
+        return;
+    }
+
+    auto& tileCache = style.tileCache;
+    const auto& sourceID = info.source_id;
+    const std::size_t budget = path.empty() ? 0 : data.getPrefetchTileBudget();
+
+    // The destination is the most important part of the path, followed by the rest of the path in
+    // the order in which the camera passes it.
+    std::vector<const TransformState*> samples;
+    if (!path.empty()) {
+        samples.push_back(&path.back());
+        for (std::size_t i = 0; i + 1 < path.size(); i++) {
+            samples.push_back(&path[i]);
+        }
+    }
+
+    TileIDSet wanted;
+    for (const auto sample : samples) {
+        if (coveringZoomLevel(*sample) < info.min_zoom) {
+            continue;
+        }
+
+        for (const auto& id : coveringTiles(*sample)) {
+            if (wanted.size() >= budget) {
+                break;
+            }
+
+            const TileID normalized_id = id.normalized();
+            if (wanted.find(normalized_id) != wanted.end() ||
+                tileCache.has(sourceID, normalized_id.to_uint64())) {
+                continue;
+            }
+
+            if (prefetched.find(normalized_id) == prefetched.end()) {
+                // Skip tiles that are loaded for the current viewport already.
+                auto it = tile_data.find(normalized_id);
+                if (it != tile_data.end()) {
+                    const util::ptr<TileData> existing = it->second.lock();
+                    if (existing && existing->getState() != TileData::State::obsolete) {
+                        continue;
+                    }
+                    tile_data.erase(it);
+                }
+
+                auto tileData = createTileData(data, *sample, style, texturePool, normalized_id);
+                tileData->setPriority({ WorkPriority::Prefetch, float(wanted.size()) });
+                tile_data.emplace(normalized_id, tileData);
+                prefetched.emplace(normalized_id, tileData);
+            }
+
+            wanted.insert(normalized_id);
+        }
+    }
+
+    // Release the tiles that the camera doesn't pass anymore.
+    util::erase_if(prefetched, [&](std::pair<const TileID, std::shared_ptr<TileData>>& pair) {
+        if (wanted.find(pair.first) != wanted.end()) {
+            return false;
+        }
+
+        // Tiles that became visible in the meantime are kept alive by the tiles that display them.
+        const auto& tileData = pair.second;
+        if (tileData.use_count() == 1) {
+            if (tileData->getState() == TileData::State::parsed) {
+                tileCache.add(sourceID, pair.first.to_uint64(), tileData);
+            } else {
+                tileData->cancel();
+            }
+            tile_data.erase(pair.first);
+        }
+        return true;
+    });
 }
 
-void Source::onLowMemory() {
-    cache.clear();
+void Source::updateTilePtrs() {
+    tilePtrs.clear();
+    for (const auto& pair : tiles) {
+        tilePtrs.push_back(pair.second.get());
+    }
 }
 
 void Source::setObserver(Observer* observer) {
     observer_ = observer;
 }
 
-void Source::tileLoadingCompleteCallback(const TileID& normalized_id, const TransformState& transformState, bool collisionDebug) {
+void Source::tileLoadingCompleteCallback(const TileID& normalized_id, const PlacementConfig& config) {
     auto it = tile_data.find(normalized_id);
     if (it == tile_data.end()) {
         return;
@@ -560,10 +720,26 @@ void Source::tileLoadingCompleteCallback(const TileID& normalized_id, const Tran
         return;
     }
 
-    data->redoPlacement({ transformState.getAngle(), transformState.getPitch(), collisionDebug });
+    data->redoPlacement(config);
     emitTileLoaded(true);
 }
 
+void Source::tilePlacedCallback(const TileID& normalized_id) {
+    // Neighbours that avoid the symbols of this tile may have been placed before it published
+    // them, e.g. when they finished loading first.
+    for (const auto& id : EdgeCollisionIndex::dependents(normalized_id)) {
+        auto it = tile_data.find(id);
+        if (it == tile_data.end()) {
+            continue;
+        }
+
+        util::ptr<TileData> data = it->second.lock();
+        if (data) {
+            data->redoStalePlacement();
+        }
+    }
+}
+
 void Source::emitSourceLoaded() {
     if (observer_) {
         observer_->onSourceLoaded();
@@ -597,6 +773,7 @@ void Source::emitTileLoadingFailed(const std::string& message) {
 void Source::dumpDebugLogs() const {
     Log::Info(Event::General, "Source::id: %s", info.source_id.c_str());
     Log::Info(Event::General, "Source::loaded: %d", loaded);
+    Log::Info(Event::General, "Source::prefetched: %zu", prefetched.size());
 
     for (const auto& tile : tiles) {
         tile.second->data->dumpDebugLogs();
@@ -3,8 +3,8 @@
 
 #include <mbgl/map/tile_id.hpp>
 #include <mbgl/map/tile_data.hpp>
-#include <mbgl/map/tile_cache.hpp>
 #include <mbgl/style/types.hpp>
+#include <mbgl/text/placement_config.hpp>
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/mat4.hpp>
@@ -78,6 +78,13 @@ public:
                 TexturePool&,
                 bool shouldReparsePartialTiles);
 
+    // Loads the tiles that cover the given camera path ahead of time, up to the prefetch budget
+    // of the map, and cancels previously prefetched tiles that aren't on the path anymore.
+    void prefetch(MapData&,
+                  const std::vector<TransformState>& path,
+                  Style&,
+                  TexturePool&);
+
     void updateMatrices(const mat4 &projMatrix, const TransformState &transform);
     void drawClippingMasks(Painter &painter);
     void finishRender(Painter &painter);
@@ -85,9 +92,6 @@ public:
     std::forward_list<Tile *> getLoadedTiles() const;
     const std::vector<Tile*>& getTiles() const;
 
-    void setCacheSize(size_t);
-    void onLowMemory();
-
     void setObserver(Observer* observer);
     void dumpDebugLogs() const;
 
@@ -95,7 +99,8 @@ public:
     bool enabled;
 
 private:
-    void tileLoadingCompleteCallback(const TileID& normalized_id, const TransformState& transformState, bool collisionDebug);
+    void tileLoadingCompleteCallback(const TileID& normalized_id, const PlacementConfig&);
+    void tilePlacedCallback(const TileID& normalized_id);
 
     void emitSourceLoaded();
     void emitSourceLoadingFailed(const std::string& message);
@@ -103,8 +108,10 @@ private:
     void emitTileLoadingFailed(const std::string& message);
 
     bool handlePartialTile(const TileID &id, Worker &worker);
-    bool findLoadedChildren(const TileID& id, int32_t maxCoveringZoom, std::forward_list<TileID>& retain);
-    void findLoadedParent(const TileID& id, int32_t minCoveringZoom, std::forward_list<TileID>& retain);
+    using TileIDSet = std::unordered_set<TileID, TileID::Hash>;
+
+    bool findLoadedChildren(const TileID& id, int32_t maxCoveringZoom, TileIDSet& retain);
+    void findLoadedParent(const TileID& id, int32_t minCoveringZoom, TileIDSet& retain);
     int32_t coveringZoomLevel(const TransformState&) const;
     std::forward_list<TileID> coveringTiles(const TransformState&) const;
 
@@ -114,9 +121,19 @@ private:
                             TexturePool&,
                             const TileID&);
 
+    std::shared_ptr<TileData> createTileData(MapData&,
+                                             const TransformState&,
+                                             Style&,
+                                             TexturePool&,
+                                             const TileID& normalized_id);
+
     TileData::State hasTile(const TileID& id);
     void updateTilePtrs();
 
+    // Whether all of the required tiles are loaded and are the only tiles of this source, and the
+    // covering set hasn't changed since the previous update.
+    bool isCovered(const std::forward_list<TileID>& required) const;
+
     double getZoom(const TransformState &state) const;
 
     bool loaded = false;
@@ -127,7 +144,13 @@ private:
     std::map<TileID, std::unique_ptr<Tile>> tiles;
     std::vector<Tile*> tilePtrs;
     std::map<TileID, std::weak_ptr<TileData>> tile_data;
-    TileCache cache;
+
+    // The covering tiles and placement configuration of the most recent update.
+    TileIDSet requiredTiles;
+    PlacementConfig placementConfig;
+
+    // Tiles that are loaded ahead of time for an animated camera transition, by normalized ID.
+    std::map<TileID, std::shared_ptr<TileData>> prefetched;
 
     std::unique_ptr<FileRequest> req;
     Observer* observer_ = nullptr;
@@ -1,64 +1,127 @@
 #include <mbgl/map/tile_cache.hpp>
+#include <mbgl/platform/log.hpp>
 
 #include <cassert>
+#include <cmath>
 
 namespace mbgl {
 
-void TileCache::setSize(size_t size_) {
+namespace {
+
+// Accounts for memory of a cached tile that isn't render data, like the TileData object itself
+// and its bookkeeping. Also makes sure that empty tiles don't accumulate without bounds.
+const std::size_t tileOverhead = 4096;
+
+} // namespace
+
+void TileCache::setSize(std::size_t size_) {
     size = size_;
 
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
-        orderedKeys.pop_front();
-        tiles.erase(key);
+    while (statistics.size > size) {
+        evict();
     }
+}
 
-    assert(orderedKeys.size() <= size);
-
-    tiles.reserve(size);
+void TileCache::setZoom(double zoom_) {
+    zoom = zoom_;
 }
 
-void TileCache::add(uint64_t key, std::shared_ptr<TileData> data) {
+void TileCache::add(const std::string& sourceID, uint64_t key, std::shared_ptr<TileData> data) {
+    assert(data->isReady());
 
-    // insert new or query existing data
-    if (tiles.emplace(key, data).second) {
-        // remove existing data key
-        orderedKeys.remove(key);
+    const Key entryKey { sourceID, key };
+    auto it = index.find(entryKey);
+    if (it != index.end()) {
+        erase(it->second);
     }
 
-    // (re-)insert data key as newest
-    orderedKeys.push_back(key);
-
-    // purge oldest key/data if necessary
-    if (orderedKeys.size() > size) {
-        get(orderedKeys.front());
+    const std::size_t bytes = tileOverhead + data->getMemoryUsage();
+    if (bytes > size) {
+        return;
     }
 
-    assert(orderedKeys.size() <= size);
-};
+    const std::size_t level = std::min<std::size_t>(std::max<int>(data->id.z, 0), levels.size() - 1);
+    Entries& entries = levels[level];
+    entries.push_back({ entryKey, std::move(data), bytes, sequence++, level });
+    index.emplace(entryKey, std::prev(entries.end()));
+    statistics.size += bytes;
+    statistics.tiles++;
 
-std::shared_ptr<TileData> TileCache::get(uint64_t key) {
+    // purge tiles if necessary
+    while (statistics.size > size) {
+        evict();
+    }
+}
 
+std::shared_ptr<TileData> TileCache::get(const std::string& sourceID, uint64_t key) {
     std::shared_ptr<TileData> data;
 
-    auto it = tiles.find(key);
-    if (it != tiles.end()) {
-        data = it->second;
-        tiles.erase(it);
-        orderedKeys.remove(key);
+    auto it = index.find({ sourceID, key });
+    if (it != index.end()) {
+        data = it->second->data;
+        erase(it->second);
         assert(data->isReady());
+        statistics.hits++;
+    } else {
+        statistics.misses++;
     }
 
     return data;
-};
+}
 
-bool TileCache::has(uint64_t key) {
-    return tiles.find(key) != tiles.end();
+bool TileCache::has(const std::string& sourceID, uint64_t key) const {
+    return index.find({ sourceID, key }) != index.end();
 }
 
 void TileCache::clear() {
-    orderedKeys.clear();
-    tiles.clear();
+    for (auto& entries : levels) {
+        entries.clear();
+    }
+    index.clear();
+    statistics.size = 0;
+    statistics.tiles = 0;
+}
+
+void TileCache::dumpDebugLogs() const {
+    Log::Info(Event::General, "TileCache::size: %zu/%zu bytes", statistics.size, size);
+    Log::Info(Event::General, "TileCache::tiles: %zu", statistics.tiles);
+    Log::Info(Event::General, "TileCache::hits: %zu", statistics.hits);
+    Log::Info(Event::General, "TileCache::misses: %zu", statistics.misses);
+    Log::Info(Event::General, "TileCache::evictions: %zu", statistics.evictions);
+    Log::Info(Event::General, "TileCache::evictedBytes: %zu", statistics.evictedBytes);
+}
+
+void TileCache::erase(Entries::iterator it) {
+    assert(statistics.size >= it->size);
+    statistics.size -= it->size;
+    statistics.tiles--;
+    index.erase(it->key);
+    levels[it->level].erase(it);
+}
+
+void TileCache::evict() {
+    // Picks the zoom level furthest from the current one; among levels that are equally far away,
+    // the one with the least recently used tile.
+    Entries* victim = nullptr;
+    double victimDistance = -1;
+    for (std::size_t level = 0; level < levels.size(); level++) {
+        Entries& entries = levels[level];
+        if (entries.empty()) {
+            continue;
+        }
+
+        const double distance = std::abs(double(level) - zoom);
+        if (distance > victimDistance ||
+            (distance == victimDistance && entries.front().sequence < victim->front().sequence)) {
+            victim = &entries;
+            victimDistance = distance;
+        }
+    }
+
+    assert(victim);
+    statistics.evictions++;
+    statistics.evictedBytes += victim->front().size;
+    erase(victim->begin());
 }
 
 };
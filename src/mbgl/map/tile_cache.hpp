@@ -3,26 +3,78 @@
 
 #include <mbgl/map/tile_data.hpp>
 
+#include <array>
 #include <list>
+#include <string>
 #include <unordered_map>
 
 namespace mbgl {
 
+// Keeps parsed tiles that are no longer visible, so that they don't have to be loaded and parsed
+// again when they come back into view. A single cache is shared by all sources of a style, and is
+// bounded by the number of bytes the tiles hold in CPU and GPU memory. When it is full, it evicts
+// the least recently used tile of the zoom level that is furthest from the current one.
 class TileCache {
 public:
-    TileCache(size_t size_ = 0) : size(size_) {}
+    struct Statistics {
+        // Bytes held by the cached tiles.
+        std::size_t size = 0;
+        std::size_t tiles = 0;
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t evictions = 0;
+        std::size_t evictedBytes = 0;
+    };
 
-    void setSize(size_t);
-    size_t getSize() const { return size; };
-    void add(uint64_t key, std::shared_ptr<TileData> data);
-    std::shared_ptr<TileData> get(uint64_t key);
-    bool has(uint64_t key);
+    TileCache(std::size_t size_ = 32 * 1024 * 1024) : size(size_) {}
+
+    void setSize(std::size_t);
+    std::size_t getSize() const { return size; };
+
+    // Tiles of zoom levels far from the current zoom level are evicted first.
+    void setZoom(double);
+
+    void add(const std::string& sourceID, uint64_t key, std::shared_ptr<TileData> data);
+
+    // Removes the tile from the cache and returns it, or returns nullptr if it isn't cached.
+    std::shared_ptr<TileData> get(const std::string& sourceID, uint64_t key);
+
+    bool has(const std::string& sourceID, uint64_t key) const;
     void clear();
+
+    Statistics getStatistics() const { return statistics; }
+    void dumpDebugLogs() const;
+
 private:
-    std::unordered_map<uint64_t, std::shared_ptr<TileData>> tiles;
-    std::list<uint64_t> orderedKeys;
+    using Key = std::pair<std::string, uint64_t>;
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const {
+            return std::hash<std::string>()(key.first) ^ (std::hash<uint64_t>()(key.second) << 1);
+        }
+    };
+
+    struct Entry {
+        Key key;
+        std::shared_ptr<TileData> data;
+        std::size_t size;
+        std::size_t sequence;
+        std::size_t level;
+    };
+
+    // Least recently used entries first.
+    using Entries = std::list<Entry>;
+
+    void erase(Entries::iterator);
+    void evict();
+
+    std::array<Entries, 32> levels;
+    std::unordered_map<Key, Entries::iterator, KeyHash> index;
 
-    size_t size;
+    std::size_t size;
+    double zoom = 0;
+    std::size_t sequence = 0;
+    Statistics statistics;
 };
 
 };
@@ -23,6 +23,16 @@ const char* TileData::StateToString(const State state) {
     }
 }
 
+void TileData::setPriority(WorkPriority priority_) {
+    const bool wasPrefetch = priority.type == WorkPriority::Prefetch;
+    priority = priority_;
+
+    const bool isPrefetch = priority.type == WorkPriority::Prefetch;
+    if (isPrefetch != wasPrefetch) {
+        setRequestPriority(isPrefetch ? RequestPriority::Prefetch : RequestPriority::Required);
+    }
+}
+
 void TileData::dumpDebugLogs() const {
     Log::Info(Event::General, "TileData::id: %s", std::string(id).c_str());
     Log::Info(Event::General, "TileData::state: %s", TileData::StateToString(state));
@@ -5,6 +5,8 @@
 #include <mbgl/map/tile_id.hpp>
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/text/placement_config.hpp>
+#include <mbgl/util/work_priority.hpp>
+#include <mbgl/storage/resource.hpp>
 
 #include <atomic>
 #include <string>
@@ -76,9 +78,20 @@ public:
 
     virtual Bucket* getBucket(const StyleLayer&) = 0;
 
+    // Returns the number of bytes of render data this tile holds in CPU or GPU memory.
+    virtual std::size_t getMemoryUsage() const { return 0; }
+
     virtual bool parsePending(std::function<void ()>) { return true; }
     virtual void redoPlacement(PlacementConfig) {}
 
+    // Called when the tile starts or stops being rendered. Cached and prefetched tiles aren't
+    // rendered, so neighbouring tiles don't have to avoid their symbols.
+    virtual void setRendered(bool) {}
+
+    // Places the symbols again if a neighbouring tile that takes precedence published symbols near
+    // the shared edge since this tile was placed.
+    virtual void redoStalePlacement() {}
+
     bool isReady() const {
         return isReadyState(state);
     }
@@ -91,16 +104,31 @@ public:
         return error;
     }
 
-    void dumpDebugLogs() const;
+    virtual void dumpDebugLogs() const;
 
     const TileID id;
 
+    // Priority of parsing this tile on the Worker. Updated by the Source whenever it determines
+    // the tiles that cover the viewport.
+    WorkPriority getPriority() const {
+        return priority;
+    }
+
+    // Updates the priority of parsing this tile, and of loading it if it is still being loaded.
+    void setPriority(WorkPriority);
+
     // Contains the tile ID string for painting debug information.
     std::unique_ptr<DebugBucket> debugBucket;
 
 protected:
+    // Called when the tile starts or stops covering the viewport.
+    virtual void setRequestPriority(RequestPriority) {}
+
     std::atomic<State> state;
     std::string error;
+
+private:
+    WorkPriority priority;
 };
 
 } // namespace mbgl
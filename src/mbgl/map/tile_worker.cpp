@@ -1,6 +1,8 @@
 #include <mbgl/text/collision_tile.hpp>
+#include <mbgl/text/edge_collision_index.hpp>
 #include <mbgl/map/tile_worker.hpp>
 #include <mbgl/map/geometry_tile.hpp>
+#include <mbgl/map/decoded_geometry_tile.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/style_layer.hpp>
 #include <mbgl/style/style_bucket_parameters.hpp>
@@ -20,11 +22,13 @@ TileWorker::TileWorker(TileID id_,
     : id(id_),
       sourceID(sourceID_),
       style(style_),
-      state(state_) {
+      state(state_),
+      checkpoint([this] { return state == TileData::State::obsolete; }) {
 }
 
 TileWorker::~TileWorker() {
     style.glyphAtlas->removeGlyphs(reinterpret_cast<uintptr_t>(this));
+    style.edgeCollisionIndex->remove(sourceID, id, reinterpret_cast<uintptr_t>(this));
 }
 
 TileParseResult TileWorker::parseAllLayers(std::vector<util::ptr<StyleLayer>> layers,
@@ -35,20 +39,29 @@ TileParseResult TileWorker::parseAllLayers(std::vector<util::ptr<StyleLayer>> la
     partialParse = false;
 
     // Reset the collision tile so we have a clean slate; we're placing all features anyway.
-    collisionTile = std::make_unique<CollisionTile>(config);
+    resetCollisionTile(config);
+
+    // Many style layers typically read from the same source layer. Decode every source layer
+    // only once and let all buckets read the decoded features.
+    const auto start = Clock::now();
+    DecodedGeometryTile decodedTile(geometryTile);
 
     // We're storing a set of bucket names we've parsed to avoid parsing a bucket twice that is
     // referenced from more than one layer
     std::set<std::string> parsed;
 
-    for (auto i = layers.rbegin(); i != layers.rend(); i++) {
+    for (auto i = layers.rbegin(); i != layers.rend() && !checkpoint.check(); i++) {
         const StyleLayer& layer = **i;
         if (parsed.find(layer.bucketName()) == parsed.end()) {
             parsed.emplace(layer.bucketName());
-            parseLayer(layer, geometryTile);
+            parseLayer(layer, decodedTile);
         }
     }
 
+    publishEdgeBoxes();
+
+    result.decodeTime = decodedTile.getDecodeTime();
+    result.bucketTime = (Clock::now() - start) - result.decodeTime;
     result.state = pending.empty() ? TileData::State::parsed : TileData::State::partial;
     return std::move(result);
 }
@@ -56,7 +69,8 @@ TileParseResult TileWorker::parseAllLayers(std::vector<util::ptr<StyleLayer>> la
 TileParseResult TileWorker::parsePendingLayers() {
     // Try parsing the remaining layers that we couldn't parse in the first step due to missing
     // dependencies.
-    for (auto it = pending.begin(); it != pending.end();) {
+    const auto start = Clock::now();
+    for (auto it = pending.begin(); it != pending.end() && !checkpoint.check();) {
         auto& layer = it->first;
         auto& bucket = it->second;
         assert(bucket);
@@ -65,7 +79,8 @@ TileParseResult TileWorker::parsePendingLayers() {
             auto symbolBucket = dynamic_cast<SymbolBucket*>(bucket.get());
             if (!symbolBucket->needsDependencies(*style.glyphStore, *style.spriteStore)) {
                 symbolBucket->addFeatures(reinterpret_cast<uintptr_t>(this), *style.spriteAtlas,
-                                          *style.glyphAtlas, *style.glyphStore, *collisionTile);
+                                          *style.glyphAtlas, *style.glyphStore, *collisionTile,
+                                          checkpoint);
                 insertBucket(layer.bucketName(), std::move(bucket));
                 pending.erase(it++);
                 continue;
@@ -76,6 +91,10 @@ TileParseResult TileWorker::parsePendingLayers() {
         ++it;
     }
 
+    publishEdgeBoxes();
+
+    result.decodeTime = Duration::zero();
+    result.bucketTime = Clock::now() - start;
     result.state = pending.empty() ? TileData::State::parsed : TileData::State::partial;
     return std::move(result);
 }
@@ -86,21 +105,51 @@ void TileWorker::redoPlacement(
     PlacementConfig config) {
 
     // Reset the collision tile so we have a clean slate; we're placing all features anyway.
-    collisionTile = std::make_unique<CollisionTile>(config);
+    resetCollisionTile(config);
 
-    for (auto i = layers.rbegin(); i != layers.rend(); i++) {
+    for (auto i = layers.rbegin(); i != layers.rend() && !checkpoint.check(); i++) {
         const auto it = buckets->find((*i)->id);
         if (it != buckets->end()) {
-            it->second->placeFeatures(*collisionTile);
+            it->second->placeFeatures(*collisionTile, checkpoint);
         }
     }
+
+    publishEdgeBoxes();
 }
 
-void TileWorker::parseLayer(const StyleLayer& layer, const GeometryTile& geometryTile) {
-    // Cancel early when parsing.
-    if (state == TileData::State::obsolete)
-        return;
+void TileWorker::resetCollisionTile(PlacementConfig config) {
+    collisionTile = std::make_unique<CollisionTile>(config);
 
+    // Symbols that neighbouring tiles already placed close to the shared edges take precedence.
+    seededVersion = style.edgeCollisionIndex->seed(sourceID, id, *collisionTile);
+}
+
+bool TileWorker::setRendered(bool rendered_) {
+    std::lock_guard<std::mutex> lock(renderedMutex);
+    if (rendered == rendered_) {
+        return false;
+    }
+    rendered = rendered_;
+    if (!rendered) {
+        style.edgeCollisionIndex->remove(sourceID, id, reinterpret_cast<uintptr_t>(this));
+    }
+    return true;
+}
+
+bool TileWorker::hasStaleEdges() {
+    std::lock_guard<std::mutex> lock(renderedMutex);
+    return rendered && style.edgeCollisionIndex->isStale(sourceID, id, seededVersion);
+}
+
+void TileWorker::publishEdgeBoxes() {
+    // A placement that stopped early is incomplete; neighbours keep the previous boxes.
+    std::lock_guard<std::mutex> lock(renderedMutex);
+    if (rendered && !checkpoint.isCancelled()) {
+        style.edgeCollisionIndex->publish(sourceID, id, reinterpret_cast<uintptr_t>(this), *collisionTile);
+    }
+}
+
+void TileWorker::parseLayer(const StyleLayer& layer, const GeometryTile& geometryTile) {
     // Background is a special case.
     if (layer.type == StyleLayerType::Background)
         return;
@@ -125,7 +174,7 @@ void TileWorker::parseLayer(const StyleLayer& layer, const GeometryTile& geometr
 
     StyleBucketParameters parameters(id,
                                      *geometryLayer,
-                                     state,
+                                     checkpoint,
                                      reinterpret_cast<uintptr_t>(this),
                                      partialParse,
                                      *style.spriteAtlas,
@@ -136,6 +185,10 @@ void TileWorker::parseLayer(const StyleLayer& layer, const GeometryTile& geometr
 
     std::unique_ptr<Bucket> bucket = layer.createBucket(parameters);
 
+    // Buckets that were abandoned halfway are incomplete.
+    if (checkpoint.isCancelled())
+        return;
+
     if (layer.type == StyleLayerType::Symbol && partialParse) {
         // We cannot parse this bucket yet. Instead, we're saving it for later.
         pending.emplace_back(layer, std::move(bucket));
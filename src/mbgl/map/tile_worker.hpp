@@ -6,6 +6,8 @@
 #include <mbgl/map/tile_data.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/ptr.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/cancellation_checkpoint.hpp>
 #include <mbgl/text/placement_config.hpp>
 
 #include <string>
@@ -28,6 +30,10 @@ class TileParseResultBuckets {
 public:
     TileData::State state = TileData::State::invalid;
     std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
+
+    // Time spent decoding source layers and building buckets from the decoded features.
+    Duration decodeTime = Duration::zero();
+    Duration bucketTime = Duration::zero();
 };
 
 using TileParseResult = mapbox::util::variant<TileParseResultBuckets, // success
@@ -51,20 +57,43 @@ public:
                        const std::unordered_map<std::string, std::unique_ptr<Bucket>>*,
                        PlacementConfig);
 
+    const std::atomic<TileData::State>& getState() const { return state; }
+
+    // Publishes the symbols near the edges of the tile for its neighbours while it is rendered,
+    // and withdraws them when it stops being rendered. Returns whether the value changed.
+    bool setRendered(bool);
+
+    // Whether the tile is rendered, and a neighbour that takes precedence published new symbols
+    // near the shared edge since the tile was last placed.
+    bool hasStaleEdges();
+
 private:
     void parseLayer(const StyleLayer&, const GeometryTile&);
     void insertBucket(const std::string& name, std::unique_ptr<Bucket>);
 
+    void resetCollisionTile(PlacementConfig);
+    void publishEdgeBoxes();
+
     const TileID id;
     const std::string sourceID;
 
     Style& style;
     const std::atomic<TileData::State>& state;
 
+    // Lets layer parsing and symbol placement stop early once the tile is obsolete.
+    util::CancellationCheckpoint checkpoint;
+
     bool partialParse = false;
 
     std::unique_ptr<CollisionTile> collisionTile;
 
+    // The version of the edge collision index that the collision tile was seeded with.
+    std::atomic<uint64_t> seededVersion { 0 };
+
+    // Guards publishing the edge boxes against withdrawing them at the same time.
+    std::mutex renderedMutex;
+    bool rendered = false;
+
     // Contains buckets that we couldn't parse so far due to missing resources.
     // They will be attempted on subsequent parses.
     std::list<std::pair<const StyleLayer&, std::unique_ptr<Bucket>>> pending;
@@ -275,20 +275,26 @@ void Transform::_easeTo(const CameraOptions& options, double new_scale, double n
         state.scaling = true;
         state.rotating = true;
 
+        auto easing = [=](double t) {
+            util::UnitBezier ease = easeOptions.easing ? *easeOptions.easing : util::UnitBezier(0, 0, 0.25, 1);
+            return ease.solve(t, 0.001);
+        };
+
+        auto interpolate = [=](TransformState& s, double t) {
+            s.scale = util::interpolate(startS, scale, t);
+            s.x = util::interpolate(startX, x, t);
+            s.y = util::interpolate(startY, y, t);
+            const double size = s.scale * util::tileSize;
+            s.Bc = size / 360;
+            s.Cc = size / util::M2PI;
+            s.angle = util::wrap(util::interpolate(startA, angle, t), -M_PI, M_PI);
+            s.pitch = util::interpolate(startP, pitch, t);
+        };
+
         startTransition(
+            easing,
             [=](double t) {
-                util::UnitBezier ease = easeOptions.easing ? *easeOptions.easing : util::UnitBezier(0, 0, 0.25, 1);
-                return ease.solve(t, 0.001);
-            },
-            [=](double t) {
-                state.scale = util::interpolate(startS, scale, t);
-                state.x = util::interpolate(startX, x, t);
-                state.y = util::interpolate(startY, y, t);
-                const double s = state.scale * util::tileSize;
-                state.Bc = s / 360;
-                state.Cc = s / util::M2PI;
-                state.angle = util::wrap(util::interpolate(startA, angle, t), -M_PI, M_PI);
-                state.pitch = util::interpolate(startP, pitch, t);
+                interpolate(state, t);
                 // At t = 1.0, a DidChangeAnimated notification should be sent from finish().
                 if (t < 1.0) {
                     view.notifyMapChange(MapChangeRegionIsChanging);
@@ -301,6 +307,10 @@ void Transform::_easeTo(const CameraOptions& options, double new_scale, double n
                 state.rotating = false;
                 view.notifyMapChange(MapChangeRegionDidChangeAnimated);
             }, *easeOptions.duration);
+
+        transitionPathFn = [easing, interpolate](TransformState& s, double t) {
+            interpolate(s, easing(t));
+        };
     }
 }
 
@@ -399,6 +409,7 @@ void Transform::startTransition(std::function<double(double)> easing,
     }
 
     transitionStart = Clock::now();
+    transitionTime = transitionStart;
     transitionDuration = duration;
 
     transitionFrameFn = [easing, frame, this](const TimePoint now) {
@@ -408,6 +419,7 @@ void Transform::startTransition(std::function<double(double)> easing,
             transitionFinishFn();
             transitionFrameFn = nullptr;
             transitionFinishFn = nullptr;
+            transitionPathFn = nullptr;
             return result;
         } else {
             return frame(easing(t));
@@ -422,9 +434,26 @@ bool Transform::inTransition() const {
 }
 
 Update Transform::updateTransitions(const TimePoint& now) {
+    transitionTime = now;
     return transitionFrameFn ? transitionFrameFn(now) : Update::Nothing;
 }
 
+std::vector<TransformState> Transform::getTransitionPath(std::size_t count) const {
+    std::vector<TransformState> path;
+    if (!transitionPathFn) {
+        return path;
+    }
+
+    const float progress = util::clamp(std::chrono::duration<float>(transitionTime - transitionStart) / transitionDuration, 0.0f, 1.0f);
+    for (std::size_t i = 1; i <= count; i++) {
+        TransformState sample = state;
+        transitionPathFn(sample, progress + (1 - progress) * i / count);
+        path.push_back(sample);
+    }
+
+    return path;
+}
+
 void Transform::cancelTransitions() {
     if (transitionFinishFn) {
         transitionFinishFn();
@@ -432,6 +461,7 @@ void Transform::cancelTransitions() {
 
     transitionFrameFn = nullptr;
     transitionFinishFn = nullptr;
+    transitionPathFn = nullptr;
 }
 
 void Transform::setGestureInProgress(bool inProgress) {
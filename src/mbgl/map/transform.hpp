@@ -12,6 +12,7 @@
 #include <cstdint>
 #include <cmath>
 #include <functional>
+#include <vector>
 
 namespace mbgl {
 
@@ -56,6 +57,11 @@ public:
     Update updateTransitions(const TimePoint& now);
     void cancelTransitions();
 
+    // Samples the remainder of the current transition, as of the last updateTransitions() call,
+    // at `count` evenly spaced points in time.
+    // The last state is the destination. Returns an empty path when there is no transition.
+    std::vector<TransformState> getTransitionPath(std::size_t count) const;
+
     // Gesture
     void setGestureInProgress(bool);
     bool isGestureInProgress() const { return state.isGestureInProgress(); }
@@ -83,9 +89,12 @@ private:
                          const Duration& duration);
 
     TimePoint transitionStart;
+    // The time of the last frame, which the transition path is sampled from.
+    TimePoint transitionTime;
     Duration transitionDuration;
     std::function<Update(const TimePoint)> transitionFrameFn;
     std::function<void()> transitionFinishFn;
+    std::function<void(TransformState&, double)> transitionPathFn;
 };
 
 }
@@ -5,10 +5,19 @@
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/util/thread_context.hpp>
 
+#include <algorithm>
 #include <sstream>
 
 namespace mbgl {
 
+namespace {
+
+bool compareKeys(const std::pair<uint32_t, uint32_t>& a, const std::pair<uint32_t, uint32_t>& b) {
+    return a.first < b.first;
+}
+
+} // namespace
+
 Value parseValue(pbf data) {
     while (data.next())
     {
@@ -38,6 +47,20 @@ Value parseValue(pbf data) {
 
 VectorTileFeature::VectorTileFeature(pbf feature_pbf, const VectorTileLayer& layer_)
     : layer(layer_) {
+    load(feature_pbf);
+}
+
+VectorTileFeature::VectorTileFeature(const VectorTileLayer& layer_)
+    : layer(layer_) {
+}
+
+void VectorTileFeature::load(pbf feature_pbf) {
+    id = 0;
+    type = FeatureType::Unknown;
+    tags_pbf = pbf();
+    geometry_pbf = pbf();
+    tagsDecoded = false;
+
     while (feature_pbf.next()) {
         if (feature_pbf.tag == 1) { // id
             id = feature_pbf.varint<uint64_t>();
@@ -59,42 +82,91 @@ mapbox::util::optional<Value> VectorTileFeature::getValue(const std::string& key
         return mapbox::util::optional<Value>();
     }
 
-    pbf tags = tags_pbf;
-    while (tags) {
-        uint32_t tag_key = tags.varint();
+    const Value* value = getInternedValue(keyIter->second);
+    if (!value) {
+        return mapbox::util::optional<Value>();
+    }
+
+    return *value;
+}
+
+const VectorTileFeature::Tags& VectorTileFeature::getTags() const {
+    if (tagsDecoded) {
+        return tags;
+    }
+
+    tags.clear();
+    pbf data = tags_pbf;
+    while (data) {
+        uint32_t tag_key = data.varint();
 
         if (layer.keys.size() <= tag_key) {
             throw std::runtime_error("feature referenced out of range key");
         }
 
-        if (!tags) {
+        if (!data) {
             throw std::runtime_error("uneven number of feature tag ids");
         }
 
-        uint32_t tag_val = tags.varint();
+        uint32_t tag_val = data.varint();
         if (layer.values.size() <= tag_val) {
             throw std::runtime_error("feature referenced out of range value");
         }
 
-        if (tag_key == keyIter->second) {
-            return layer.values[tag_val];
-        }
+        // Features have few tags, so insertion is cheap. Tags with the same key stay in their
+        // original order, so that the first one takes precedence like before.
+        const auto tag = std::make_pair(tag_key, tag_val);
+        tags.insert(std::upper_bound(tags.begin(), tags.end(), tag, compareKeys), tag);
     }
 
-    return mapbox::util::optional<Value>();
+    tagsDecoded = true;
+    return tags;
+}
+
+const Value* VectorTileFeature::getInternedValue(uint32_t keyID) const {
+    const Tags& sorted = getTags();
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), std::make_pair(keyID, 0u), compareKeys);
+    if (it == sorted.end() || it->first != keyID) {
+        return nullptr;
+    }
+    return &layer.values[it->second];
+}
+
+void VectorTileFeature::eachInternedValue(const std::function<void (uint32_t, const Value&)>& function) const {
+    for (const auto& tag : getTags()) {
+        function(tag.first, layer.values[tag.second]);
+    }
 }
 
 GeometryCollection VectorTileFeature::getGeometries() const {
+    GeometryCollection lines;
+    readGeometries(lines);
+    return lines;
+}
+
+const GeometryCollection& VectorTileFeature::readGeometries(GeometryCollection& lines) const {
     pbf data(geometry_pbf);
     uint8_t cmd = 1;
     uint32_t length = 0;
     int32_t x = 0;
     int32_t y = 0;
 
-    GeometryCollection lines;
+    // Reuse the lines already present in the buffer, along with their allocated storage.
+    std::size_t count = 0;
+    auto nextLine = [this, &lines, &count] {
+        if (count == lines.size()) {
+            lines.emplace_back();
+            if (!spareLines.empty()) {
+                lines.back().swap(spareLines.back());
+                spareLines.pop_back();
+            }
+        }
+        std::vector<Coordinate>* next = &lines[count++];
+        next->clear();
+        return next;
+    };
 
-    lines.emplace_back();
-    std::vector<Coordinate>* line = &lines.back();
+    std::vector<Coordinate>* line = nextLine();
 
     while (data.data < data.end) {
         if (length == 0) {
@@ -110,8 +182,7 @@ GeometryCollection VectorTileFeature::getGeometries() const {
             y += data.svarint();
 
             if (cmd == 1 && !line->empty()) { // moveTo
-                lines.emplace_back();
-                line = &lines.back();
+                line = nextLine();
             }
 
             line->emplace_back(x, y);
@@ -126,6 +197,10 @@ GeometryCollection VectorTileFeature::getGeometries() const {
         }
     }
 
+    for (std::size_t i = count; i < lines.size(); i++) {
+        spareLines.push_back(std::move(lines[i]));
+    }
+    lines.resize(count);
     return lines;
 }
 
@@ -177,6 +252,25 @@ util::ptr<const GeometryTileFeature> VectorTileLayer::getFeature(std::size_t i)
     return std::make_shared<VectorTileFeature>(features.at(i), *this);
 }
 
+bool VectorTileLayer::everyFeature(const std::function<bool (const GeometryTileFeature&)>& function) const {
+    VectorTileFeature feature(*this);
+    for (const auto& feature_pbf : features) {
+        feature.load(feature_pbf);
+        if (!function(feature)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+mapbox::util::optional<uint32_t> VectorTileLayer::getKeyID(const std::string& key) const {
+    auto it = keys.find(key);
+    if (it == keys.end()) {
+        return {};
+    }
+    return it->second;
+}
+
 VectorTileMonitor::VectorTileMonitor(const SourceInfo& source, const TileID& id, float pixelRatio)
     : url(source.tileURL(id, pixelRatio)) {
 }
@@ -5,6 +5,8 @@
 #include <mbgl/util/pbf.hpp>
 
 #include <map>
+#include <unordered_map>
+#include <utility>
 
 namespace mbgl {
 
@@ -17,13 +19,35 @@ public:
     FeatureType getType() const override { return type; }
     mapbox::util::optional<Value> getValue(const std::string&) const override;
     GeometryCollection getGeometries() const override;
+    const GeometryCollection& readGeometries(GeometryCollection&) const override;
+    const Value* getInternedValue(uint32_t) const override;
+    void eachInternedValue(const std::function<void (uint32_t, const Value&)>&) const override;
 
 private:
+    friend class VectorTileLayer;
+
+    // Creates an empty feature that is repeatedly loaded while iterating over a layer.
+    VectorTileFeature(const VectorTileLayer&);
+    void load(pbf);
+
+    // The key and value IDs of the tags, ordered by key ID.
+    using Tags = std::vector<std::pair<uint32_t, uint32_t>>;
+    const Tags& getTags() const;
+
     const VectorTileLayer& layer;
     uint64_t id = 0;
     FeatureType type = FeatureType::Unknown;
     pbf tags_pbf;
     pbf geometry_pbf;
+
+    // Decoded from the tags message on first use, so that lookups don't have to scan it. The
+    // storage is reused while iterating over a layer.
+    mutable Tags tags;
+    mutable bool tagsDecoded = false;
+
+    // Lines that geometry buffers had no use for, along with their allocated storage, for
+    // features with more lines.
+    mutable GeometryCollection spareLines;
 };
 
 class VectorTileLayer : public GeometryTileLayer {
@@ -32,6 +56,10 @@ public:
 
     std::size_t featureCount() const override { return features.size(); }
     util::ptr<const GeometryTileFeature> getFeature(std::size_t) const override;
+    bool everyFeature(const std::function<bool (const GeometryTileFeature&)>&) const override;
+
+    bool hasKeyIDs() const override { return true; }
+    mapbox::util::optional<uint32_t> getKeyID(const std::string&) const override;
 
 private:
     friend class VectorTile;
@@ -39,7 +67,7 @@ private:
 
     std::string name;
     uint32_t extent = 4096;
-    std::map<std::string, uint32_t> keys;
+    std::unordered_map<std::string, uint32_t> keys;
     std::vector<Value> values;
     std::vector<pbf> features;
 };
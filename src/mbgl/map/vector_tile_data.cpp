@@ -5,6 +5,7 @@
 #include <mbgl/util/work_request.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/platform/log.hpp>
 
 #include <sstream>
 
@@ -14,7 +15,8 @@ VectorTileData::VectorTileData(const TileID& id_,
                                std::unique_ptr<GeometryTileMonitor> monitor_,
                                std::string sourceID,
                                Style& style_,
-                               const std::function<void()>& callback)
+                               const std::function<void()>& callback,
+                               const std::function<void()>& placedCallback_)
     : TileData(id_),
       style(style_),
       worker(style_.workers),
@@ -22,7 +24,8 @@ VectorTileData::VectorTileData(const TileID& id_,
                  sourceID,
                  style_,
                  state),
-      monitor(std::move(monitor_))
+      monitor(std::move(monitor_)),
+      placedCallback(placedCallback_)
 {
     state = State::loading;
     tileRequest = monitor->monitorTile([callback, this](std::exception_ptr err, std::unique_ptr<GeometryTile> tile) {
@@ -54,7 +57,7 @@ VectorTileData::VectorTileData(const TileID& id_,
         // when tile data changed. Replacing the workdRequest will cancel a pending work
         // request in case there is one.
         workRequest.reset();
-        workRequest = worker.parseGeometryTile(tileWorker, style.layers, std::move(tile), targetConfig, [callback, this, config = targetConfig] (TileParseResult result) {
+        workRequest = worker.parseGeometryTile(getPriority(), tileWorker, style.layers, std::move(tile), targetConfig, [callback, this, config = targetConfig] (TileParseResult result) {
             workRequest.reset();
             if (state == State::obsolete) {
                 return;
@@ -72,11 +75,10 @@ VectorTileData::VectorTileData(const TileID& id_,
                 // existing buckets in case we got a refresh parse.
                 buckets = std::move(resultBuckets.buckets);
 
-                // The target configuration could have changed since we started placement. In this case,
-                // we're starting another placement run.
-                if (placedConfig != targetConfig) {
-                    redoPlacement();
-                }
+                decodeTime = resultBuckets.decodeTime;
+                bucketTime = resultBuckets.bucketTime;
+
+                placementComplete();
             } else {
                 std::stringstream message;
                 message << "Failed to parse [" << std::string(id) << "]: " << result.get<std::string>();
@@ -100,7 +102,7 @@ bool VectorTileData::parsePending(std::function<void()> callback) {
     }
 
     workRequest.reset();
-    workRequest = worker.parsePendingGeometryTileLayers(tileWorker, [this, callback] (TileParseResult result) {
+    workRequest = worker.parsePendingGeometryTileLayers(getPriority(), tileWorker, [this, callback] (TileParseResult result) {
         workRequest.reset();
         if (state == State::obsolete) {
             return;
@@ -116,11 +118,10 @@ bool VectorTileData::parsePending(std::function<void()> callback) {
                 buckets[bucket.first] = std::move(bucket.second);
             }
 
-            // The target configuration could have changed since we started placement. In this case,
-            // we're starting another placement run.
-            if (placedConfig != targetConfig) {
-                redoPlacement();
-            }
+            decodeTime += resultBuckets.decodeTime;
+            bucketTime += resultBuckets.bucketTime;
+
+            placementComplete();
         } else {
             std::stringstream message;
             message << "Failed to parse [" << std::string(id) << "]: " << result.get<std::string>();
@@ -144,6 +145,14 @@ Bucket* VectorTileData::getBucket(const StyleLayer& layer) {
     return it->second.get();
 }
 
+std::size_t VectorTileData::getMemoryUsage() const {
+    std::size_t bytes = 0;
+    for (const auto& bucket : buckets) {
+        bytes += bucket.second->getMemoryUsage();
+    }
+    return bytes;
+}
+
 void VectorTileData::redoPlacement(const PlacementConfig newConfig) {
     if (newConfig != placedConfig) {
         targetConfig = newConfig;
@@ -158,7 +167,7 @@ void VectorTileData::redoPlacement(const PlacementConfig newConfig) {
 
 void VectorTileData::redoPlacement() {
     workRequest.reset();
-    workRequest = worker.redoPlacement(tileWorker, style.layers, buckets, targetConfig, [this, config = targetConfig] {
+    workRequest = worker.redoPlacement({ WorkPriority::Placement, getPriority().distance }, tileWorker, style.layers, buckets, targetConfig, [this, config = targetConfig] {
         workRequest.reset();
 
         // Persist the configuration we just placed so that we can later check whether we need to
@@ -169,18 +178,53 @@ void VectorTileData::redoPlacement() {
             bucket.second->swapRenderData();
         }
 
-        // The target configuration could have changed since we started placement. In this case,
-        // we're starting another placement run.
-        if (placedConfig != targetConfig) {
-            redoPlacement();
-        }
+        placementComplete();
     });
 }
 
+void VectorTileData::placementComplete() {
+    // The target configuration could have changed since we started placement, or a neighbour that
+    // takes precedence published new symbols near the edge. In this case, we're starting another
+    // placement run.
+    if (placedConfig != targetConfig || tileWorker.hasStaleEdges()) {
+        redoPlacement();
+    }
+
+    placedCallback();
+}
+
+void VectorTileData::setRendered(bool rendered) {
+    // A tile that is rendered again publishes its symbols for its neighbours once it was placed.
+    if (tileWorker.setRendered(rendered) && rendered && isReady() && !workRequest) {
+        redoPlacement();
+    }
+}
+
+void VectorTileData::redoStalePlacement() {
+    // Tiles that are being placed check once they are done.
+    if (isReady() && !workRequest && tileWorker.hasStaleEdges()) {
+        redoPlacement();
+    }
+}
+
+void VectorTileData::setRequestPriority(RequestPriority requestPriority) {
+    if (tileRequest) {
+        tileRequest->setPriority(requestPriority);
+    }
+}
+
 void VectorTileData::cancel() {
     state = State::obsolete;
     tileRequest.reset();
     workRequest.reset();
 }
 
+void VectorTileData::dumpDebugLogs() const {
+    TileData::dumpDebugLogs();
+
+    using Milliseconds = std::chrono::duration<float, std::chrono::milliseconds::period>;
+    Log::Info(Event::General, "VectorTileData::decodeTime: %fms", Milliseconds(decodeTime).count());
+    Log::Info(Event::General, "VectorTileData::bucketTime: %fms", Milliseconds(bucketTime).count());
+}
+
 }
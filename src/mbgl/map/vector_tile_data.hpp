@@ -22,20 +22,33 @@ public:
                    std::unique_ptr<GeometryTileMonitor> monitor,
                    std::string sourceID,
                    Style&,
-                   const std::function<void()>& callback);
+                   const std::function<void()>& callback,
+                   const std::function<void()>& placedCallback);
 
     ~VectorTileData();
 
     Bucket* getBucket(const StyleLayer&) override;
+    std::size_t getMemoryUsage() const override;
 
     bool parsePending(std::function<void()> callback) override;
 
     void redoPlacement(PlacementConfig config) override;
     void redoPlacement();
 
+    void setRendered(bool) override;
+    void redoStalePlacement() override;
+
     void cancel() override;
 
+    void dumpDebugLogs() const override;
+
 private:
+    void setRequestPriority(RequestPriority) override;
+
+    // Places the symbols again if the placement that just completed is already outdated, and lets
+    // the neighbours that avoid the symbols of this tile know.
+    void placementComplete();
+
     Style& style;
     Worker& worker;
     TileWorker tileWorker;
@@ -44,6 +57,9 @@ private:
     std::unique_ptr<FileRequest> tileRequest;
     std::unique_ptr<WorkRequest> workRequest;
 
+    // Called on the map thread once the symbols of this tile were placed.
+    std::function<void()> placedCallback;
+
     // Contains all the Bucket objects for the tile. Buckets are render
     // objects and they get added by tile parsing operations.
     std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
@@ -54,6 +70,11 @@ private:
     // Stores the placement configuration of how the text should be placed. This isn't necessarily
     // the one that is being displayed.
     PlacementConfig targetConfig;
+
+    // Time the worker spent on the most recent full parse of this tile, including any
+    // subsequent parses of pending layers.
+    Duration decodeTime = Duration::zero();
+    Duration bucketTime = Duration::zero();
 };
 
 } // namespace mbgl
@@ -5,6 +5,7 @@
 #include <mbgl/renderer/render_pass.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/mat4.hpp>
+#include <mbgl/util/cancellation_checkpoint.hpp>
 
 #include <atomic>
 
@@ -34,11 +35,17 @@ public:
 
     virtual bool hasData() const = 0;
 
+    // Returns the number of bytes of vertex, element and texture data this bucket holds in CPU
+    // or GPU memory.
+    virtual std::size_t getMemoryUsage() const { return 0; }
+
     inline bool needsUpload() const {
         return !uploaded;
     }
 
-    virtual void placeFeatures(CollisionTile&) {}
+    // Placement may stop early when the checkpoint reports that the tile is obsolete. The partial
+    // result must not be used in that case.
+    virtual void placeFeatures(CollisionTile&, util::CancellationCheckpoint&) {}
     virtual void swapRenderData() {}
 
 protected:
@@ -30,6 +30,10 @@ bool CircleBucket::hasData() const {
     return !triangleGroups_.empty();
 }
 
+std::size_t CircleBucket::getMemoryUsage() const {
+    return vertexBuffer_.bytes() + elementsBuffer_.bytes();
+}
+
 void CircleBucket::addGeometry(const GeometryCollection& geometryCollection) {
     const int extent = 4096;
     for (auto& circle : geometryCollection) {
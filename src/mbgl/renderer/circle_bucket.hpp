@@ -24,6 +24,7 @@ public:
     void render(Painter&, const StyleLayer&, const TileID&, const mat4&) override;
 
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
     void addGeometry(const GeometryCollection&);
 
     void drawCircles(CircleShader& shader);
@@ -8,6 +8,7 @@
 #include <mbgl/shader/outline_shader.hpp>
 #include <mbgl/platform/gl.hpp>
 #include <mbgl/platform/log.hpp>
+#include <mbgl/util/polygon.hpp>
 
 #include <cassert>
 
@@ -27,8 +28,9 @@ void FillBucket::free(void *, void *ptr) {
     ::free(ptr);
 }
 
-FillBucket::FillBucket()
-    : allocator(new TESSalloc{
+FillBucket::FillBucket(float tolerance_)
+    : tolerance(tolerance_),
+      allocator(new TESSalloc{
           &alloc,
           &realloc,
           &free,
@@ -53,22 +55,88 @@ FillBucket::~FillBucket() {
     }
 }
 
-void FillBucket::addGeometry(const GeometryCollection& geometryCollection) {
-    for (auto& line_ : geometryCollection) {
-        for (auto& v : line_) {
-            line.emplace_back(v.x, v.y);
+void FillBucket::addGeometry(const GeometryCollection& geometryCollection,
+                             util::CancellationCheckpoint& checkpoint) {
+    std::size_t ringCount = 0;
+    for (auto& ring : geometryCollection) {
+        util::simplifyRing(ring, tolerance, simplifiedRing);
+        if (simplifiedRing.size() < 3) {
+            // The ring encloses no area.
+            continue;
         }
-        if (!line.empty()) {
-            clipper.AddPath(line, ClipperLib::ptSubject, true);
-            line.clear();
-            hasVertices = true;
+
+        // Features with a single ring, like most building footprints, may not need the clipper
+        // and the tessellator at all.
+        if (++ringCount == 1) {
+            std::swap(firstRing, simplifiedRing);
+            continue;
+        } else if (ringCount == 2) {
+            addRing(firstRing);
+        }
+        addRing(simplifiedRing);
+    }
+
+    if (ringCount == 1) {
+        ringTriangles.clear();
+        if (util::triangulateSimpleRing(firstRing, ringTriangles)) {
+            addTriangulatedRing(firstRing, ringTriangles);
+            return;
         }
+        addRing(firstRing);
     }
 
-    tessellate();
+    tessellate(checkpoint);
+}
+
+void FillBucket::addRing(const std::vector<Coordinate>& ring) {
+    line.clear();
+    for (auto& v : ring) {
+        line.emplace_back(v.x, v.y);
+    }
+    clipper.AddPath(line, ClipperLib::ptSubject, true);
+    hasVertices = true;
 }
 
-void FillBucket::tessellate() {
+void FillBucket::addTriangulatedRing(const std::vector<Coordinate>& ring, const std::vector<uint16_t>& indices) {
+    const GLsizei vertex_count = static_cast<GLsizei>(ring.size());
+
+    if (lineGroups.empty() || (lineGroups.back()->vertex_length + vertex_count > 65535)) {
+        // Move to a new group because the old one can't hold the geometry.
+        lineGroups.emplace_back(std::make_unique<LineGroup>());
+    }
+
+    assert(lineGroups.back());
+    LineGroup& lineGroup = *lineGroups.back();
+    const GLsizei lineIndex = lineGroup.vertex_length;
+
+    for (GLsizei i = 0; i < vertex_count; i++) {
+        vertexBuffer.add(ring[i].x, ring[i].y);
+        const GLsizei prev_i = (i == 0 ? vertex_count : i) - 1;
+        lineElementsBuffer.add(lineIndex + prev_i, lineIndex + i);
+    }
+
+    lineGroup.vertex_length += vertex_count;
+    lineGroup.elements_length += vertex_count;
+
+    if (triangleGroups.empty() || (triangleGroups.back()->vertex_length + vertex_count > 65535)) {
+        triangleGroups.emplace_back(std::make_unique<TriangleGroup>());
+    }
+
+    assert(triangleGroups.back());
+    TriangleGroup& triangleGroup = *triangleGroups.back();
+    const GLsizei triangleIndex = triangleGroup.vertex_length;
+
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+        triangleElementsBuffer.add(triangleIndex + indices[i],
+                                   triangleIndex + indices[i + 1],
+                                   triangleIndex + indices[i + 2]);
+    }
+
+    triangleGroup.vertex_length += vertex_count;
+    triangleGroup.elements_length += static_cast<GLsizei>(indices.size() / 3);
+}
+
+void FillBucket::tessellate(util::CancellationCheckpoint& checkpoint) {
     if (!hasVertices) {
         return;
     }
@@ -78,7 +146,9 @@ void FillBucket::tessellate() {
     clipper.Execute(ClipperLib::ctUnion, polygons, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd);
     clipper.Clear();
 
-    if (polygons.empty()) {
+    // Clipping and tessellating large polygons is expensive, so we check in between whether the
+    // tile is still needed.
+    if (polygons.empty() || checkpoint.check()) {
         return;
     }
 
@@ -104,7 +174,7 @@ void FillBucket::tessellate() {
         const GLsizei group_count = static_cast<GLsizei>(polygon.size());
         assert(group_count >= 3);
 
-        std::vector<TESSreal> clipped_line;
+        clipped_line.clear();
         for (const auto& pt : polygon) {
             clipped_line.push_back(pt.X);
             clipped_line.push_back(pt.Y);
@@ -206,6 +276,10 @@ bool FillBucket::hasData() const {
     return !triangleGroups.empty() || !lineGroups.empty();
 }
 
+std::size_t FillBucket::getMemoryUsage() const {
+    return vertexBuffer.bytes() + triangleElementsBuffer.bytes() + lineElementsBuffer.bytes();
+}
+
 void FillBucket::drawElements(PlainShader& shader) {
     GLbyte* vertex_index = BUFFER_OFFSET(0);
     GLbyte* elements_index = BUFFER_OFFSET(0);
@@ -5,6 +5,7 @@
 #include <mbgl/map/geometry_tile.hpp>
 #include <mbgl/geometry/elements_buffer.hpp>
 #include <mbgl/geometry/fill_buffer.hpp>
+#include <mbgl/util/cancellation_checkpoint.hpp>
 
 #include <clipper/clipper.hpp>
 #include <libtess2/tesselator.h>
@@ -29,21 +30,28 @@ class FillBucket : public Bucket {
     typedef ElementGroup<1> LineGroup;
 
 public:
-    FillBucket();
+    // Vertices that are closer than the tolerance, in tile units, to the outline formed by their
+    // neighbours are dropped.
+    explicit FillBucket(float tolerance = 0);
     ~FillBucket() override;
 
     void upload() override;
     void render(Painter&, const StyleLayer&, const TileID&, const mat4&) override;
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
 
-    void addGeometry(const GeometryCollection&);
-    void tessellate();
+    void addGeometry(const GeometryCollection&, util::CancellationCheckpoint&);
+    void tessellate(util::CancellationCheckpoint&);
 
     void drawElements(PlainShader& shader);
     void drawElements(PatternShader& shader);
     void drawVertices(OutlineShader& shader);
 
 private:
+    void addRing(const std::vector<Coordinate>& ring);
+    void addTriangulatedRing(const std::vector<Coordinate>& ring, const std::vector<uint16_t>& indices);
+
+    const float tolerance;
     TESSalloc *allocator;
     TESStesselator *tesselator;
     ClipperLib::Clipper clipper;
@@ -56,6 +64,10 @@ private:
     std::vector<std::unique_ptr<LineGroup>> lineGroups;
 
     std::vector<ClipperLib::IntPoint> line;
+    std::vector<Coordinate> simplifiedRing;
+    std::vector<Coordinate> firstRing;
+    std::vector<uint16_t> ringTriangles;
+    std::vector<TESSreal> clipped_line;
     bool hasVertices = false;
 
     static const int vertexSize = 2;
@@ -70,7 +70,9 @@ void LineBucket::addGeometry(const std::vector<Coordinate>& vertices) {
     }
 
     const GLint startVertex = vertexBuffer.index();
-    std::vector<TriangleElement> triangleStore;
+    // Reuse the storage of the previous line's triangles.
+    std::vector<TriangleElement>& triangleStore = triangleBuffer;
+    triangleStore.clear();
 
     for (GLsizei i = 0; i < len; ++i) {
         if (closed && i == len - 1) {
@@ -396,6 +398,10 @@ bool LineBucket::hasData() const {
     return !triangleGroups.empty();
 }
 
+std::size_t LineBucket::getMemoryUsage() const {
+    return vertexBuffer.bytes() + triangleElementsBuffer.bytes();
+}
+
 void LineBucket::drawLines(LineShader& shader) {
     GLbyte* vertex_index = BUFFER_OFFSET(0);
     GLbyte* elements_index = BUFFER_OFFSET(0);
@@ -30,6 +30,7 @@ public:
     void upload() override;
     void render(Painter&, const StyleLayer&, const TileID&, const mat4&) override;
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
 
     void addGeometry(const GeometryCollection&);
     void addGeometry(const std::vector<Coordinate>& line);
@@ -61,6 +62,9 @@ private:
     GLint e2;
     GLint e3;
 
+    // Scratch storage for the triangles of the line currently being added.
+    std::vector<TriangleElement> triangleBuffer;
+
     std::vector<std::unique_ptr<TriangleGroup>> triangleGroups;
 };
 
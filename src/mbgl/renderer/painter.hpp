@@ -147,16 +147,15 @@ private:
 
     void prepareTile(const Tile& tile);
 
-    template <typename BucketProperties, typename StyleProperties>
-    void renderSDF(SymbolBucket &bucket,
-                   const TileID &id,
+    template <typename BucketProperties, typename StyleProperties, typename DrawSDF>
+    void renderSDF(const TileID &id,
                    const mat4 &matrixSymbol,
                    const BucketProperties& bucketProperties,
                    const StyleProperties& styleProperties,
                    float scaleDivisor,
                    std::array<float, 2> texsize,
                    SDFShader& sdfShader,
-                   void (SymbolBucket::*drawSDF)(SDFShader&));
+                   DrawSDF drawSDF);
 
     void setDepthSublayer(int n);
 
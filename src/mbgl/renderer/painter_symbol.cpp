@@ -14,16 +14,15 @@
 
 using namespace mbgl;
 
-template <typename BucketProperties, typename StyleProperties>
-void Painter::renderSDF(SymbolBucket &bucket,
-                        const TileID &id,
+template <typename BucketProperties, typename StyleProperties, typename DrawSDF>
+void Painter::renderSDF(const TileID &id,
                         const mat4 &matrix,
                         const BucketProperties& bucketProperties,
                         const StyleProperties& styleProperties,
                         float sdfFontSize,
                         std::array<float, 2> texsize,
                         SDFShader& sdfShader,
-                        void (SymbolBucket::*drawSDF)(SDFShader&))
+                        DrawSDF drawSDF)
 {
     mat4 vtxMatrix = translatedMatrix(matrix, styleProperties.translate, id, styleProperties.translateAnchor);
 
@@ -106,7 +105,7 @@ void Painter::renderSDF(SymbolBucket &bucket,
         sdfShader.u_buffer = (haloOffset - styleProperties.haloWidth / fontScale) / sdfPx;
 
         setDepthSublayer(0);
-        (bucket.*drawSDF)(sdfShader);
+        drawSDF(sdfShader);
     }
 
     // Then, we draw the text/icon over the halo
@@ -127,7 +126,7 @@ void Painter::renderSDF(SymbolBucket &bucket,
         sdfShader.u_buffer = (256.0f - 64.0f) / 256.0f;
 
         setDepthSublayer(1);
-        (bucket.*drawSDF)(sdfShader);
+        drawSDF(sdfShader);
     }
 }
 
@@ -196,15 +195,14 @@ void Painter::renderSymbol(SymbolBucket& bucket, const SymbolLayer& layer, const
                 || angleOffset != 0 || fontScale != 1 || sdf || state.getPitch() != 0);
 
         if (sdf) {
-            renderSDF(bucket,
-                      id,
+            renderSDF(id,
                       matrix,
                       layout.icon,
                       properties.icon,
                       1.0f,
                       {{ float(spriteAtlas->getWidth()) / 4.0f, float(spriteAtlas->getHeight()) / 4.0f }},
                       *sdfIconShader,
-                      &SymbolBucket::drawIcons);
+                      [&] (SDFShader& shader) { bucket.drawIcons(shader); });
         } else {
             mat4 vtxMatrix = translatedMatrix(matrix, properties.icon.translate, id, properties.icon.translateAnchor);
 
@@ -259,17 +257,15 @@ void Painter::renderSymbol(SymbolBucket& bucket, const SymbolLayer& layer, const
             config.depthTest = GL_FALSE;
         }
 
-        glyphAtlas->bind();
-
-        renderSDF(bucket,
-                  id,
+        // Every group of glyphs binds the atlas page it was laid out on.
+        renderSDF(id,
                   matrix,
                   layout.text,
                   properties.text,
                   24.0f,
                   {{ float(glyphAtlas->width) / 4, float(glyphAtlas->height) / 4 }},
                   *sdfGlyphShader,
-                  &SymbolBucket::drawGlyphs);
+                  [&] (SDFShader& shader) { bucket.drawGlyphs(shader, *glyphAtlas); });
     }
 
 }
@@ -37,3 +37,8 @@ void RasterBucket::drawRaster(RasterShader& shader, StaticVertexBuffer &vertices
 bool RasterBucket::hasData() const {
     return raster.isLoaded();
 }
+
+std::size_t RasterBucket::getMemoryUsage() const {
+    // RGBA pixels, either in CPU memory or in a texture.
+    return hasData() ? std::size_t(raster.width) * raster.height * 4 : 0;
+}
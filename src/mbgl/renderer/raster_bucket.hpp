@@ -17,6 +17,7 @@ public:
     void upload() override;
     void render(Painter&, const StyleLayer&, const TileID&, const mat4&) override;
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
 
     bool setImage(std::unique_ptr<util::Image> image);
 
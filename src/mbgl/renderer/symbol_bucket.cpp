@@ -12,6 +12,7 @@
 #include <mbgl/renderer/painter.hpp>
 #include <mbgl/text/glyph_store.hpp>
 #include <mbgl/text/font_stack.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/platform/log.hpp>
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/shader/sdf_shader.hpp>
@@ -83,6 +84,16 @@ void SymbolBucket::render(Painter& painter,
 
 bool SymbolBucket::hasData() const { return hasTextData() || hasIconData() || !symbolInstances.empty(); }
 
+std::size_t SymbolBucket::getMemoryUsage() const {
+    // Data that is still being placed on a worker thread is not counted.
+    if (!renderData) {
+        return 0;
+    }
+    return renderData->text.vertices.bytes() + renderData->text.triangles.bytes() +
+           renderData->icon.vertices.bytes() + renderData->icon.triangles.bytes() +
+           renderData->collisionBox.vertices.bytes();
+}
+
 bool SymbolBucket::hasTextData() const { return renderData && !renderData->text.groups.empty(); }
 
 bool SymbolBucket::hasIconData() const { return renderData && !renderData->icon.groups.empty(); }
@@ -90,7 +101,8 @@ bool SymbolBucket::hasIconData() const { return renderData && !renderData->icon.
 bool SymbolBucket::hasCollisionBoxData() const { return renderData && !renderData->collisionBox.groups.empty(); }
 
 void SymbolBucket::parseFeatures(const GeometryTileLayer& layer,
-                                 const FilterExpression& filter) {
+                                 const CompiledFilter& filter,
+                                 util::CancellationCheckpoint& checkpoint) {
     const bool has_text = !layout.text.field.value.empty() && !layout.text.font.value.empty();
     const bool has_icon = !layout.icon.image.value.empty();
 
@@ -98,19 +110,23 @@ void SymbolBucket::parseFeatures(const GeometryTileLayer& layer,
         return;
     }
 
+    // Scratch buffer that is reused for decoding the geometries of all features.
+    GeometryCollection geometryBuffer;
+
+    GeometryTileLayerFilter layerFilter(layer, filter);
+
     // Determine and load glyph ranges
-    const GLsizei featureCount = static_cast<GLsizei>(layer.featureCount());
-    for (GLsizei i = 0; i < featureCount; i++) {
-        auto feature = layer.getFeature(i);
+    layer.everyFeature([&] (const GeometryTileFeature& feature) {
+        if (checkpoint.poll())
+            return false;
 
-        GeometryTileFeatureExtractor extractor(*feature);
-        if (!evaluate(filter, extractor))
-            continue;
+        if (!layerFilter(feature))
+            return true;
 
         SymbolFeature ft;
 
         auto getValue = [&feature](const std::string& key) -> std::string {
-            auto value = feature->getValue(key);
+            auto value = feature.getValue(key);
             return value ? toString(*value) : std::string();
         };
 
@@ -138,22 +154,15 @@ void SymbolBucket::parseFeatures(const GeometryTileLayer& layer,
         }
 
         if (ft.label.length() || ft.sprite.length()) {
-
-            auto &multiline = ft.geometry;
-
-            GeometryCollection geometryCollection = feature->getGeometries();
-            for (auto& line : geometryCollection) {
-                multiline.emplace_back();
-                for (auto& point : line) {
-                    multiline.back().emplace_back(point.x, point.y);
-                }
-            }
-
+            // Only features that end up in the bucket need their own copy of the geometries.
+            ft.geometry = feature.readGeometries(geometryBuffer);
             features.push_back(std::move(ft));
         }
-    }
 
-    if (layout.placement == PlacementType::Line) {
+        return true;
+    });
+
+    if (layout.placement == PlacementType::Line && !checkpoint.isCancelled()) {
         util::mergeLines(features);
     }
 }
@@ -174,7 +183,8 @@ void SymbolBucket::addFeatures(uintptr_t tileUID,
                                SpriteAtlas& spriteAtlas,
                                GlyphAtlas& glyphAtlas,
                                GlyphStore& glyphStore,
-                               CollisionTile& collisionTile) {
+                               CollisionTile& collisionTile,
+                               util::CancellationCheckpoint& checkpoint) {
     float horizontalAlign = 0.5;
     float verticalAlign = 0.5;
 
@@ -217,29 +227,40 @@ void SymbolBucket::addFeatures(uintptr_t tileUID,
         0.5;
 
     auto fontStack = glyphStore.getFontStack(layout.text.font);
+    auto& shapingCache = glyphStore.getShapingCache();
+
+    ShapingCache::Key shapingKey {
+        /* fontStack */ layout.text.font,
+        /* text */ {},
+        /* maxWidth: ems */ layout.placement != PlacementType::Line ? layout.text.maxWidth * 24 : 0,
+        /* lineHeight: ems */ layout.text.lineHeight * 24,
+        /* horizontalAlign */ horizontalAlign,
+        /* verticalAlign */ verticalAlign,
+        /* justify */ justify,
+        /* spacing: ems */ layout.text.letterSpacing * 24,
+        /* translate */ vec2<float>(layout.text.offset.value[0], layout.text.offset.value[1])
+    };
+    const Shaping noShaping;
 
     for (const auto& feature : features) {
+        if (checkpoint.poll()) {
+            // Shaping and placing the remaining features is wasted work.
+            return;
+        }
+
         if (feature.geometry.empty()) continue;
 
-        Shaping shapedText;
+        std::shared_ptr<const Shaping> shaping;
         PositionedIcon shapedIcon;
         GlyphPositions face;
 
         // if feature has text, shape the text
         if (feature.label.length()) {
-            shapedText = fontStack->getShaping(
-                /* string */ feature.label,
-                /* maxWidth: ems */ layout.placement != PlacementType::Line ?
-                    layout.text.maxWidth * 24 : 0,
-                /* lineHeight: ems */ layout.text.lineHeight * 24,
-                /* horizontalAlign */ horizontalAlign,
-                /* verticalAlign */ verticalAlign,
-                /* justify */ justify,
-                /* spacing: ems */ layout.text.letterSpacing * 24,
-                /* translate */ vec2<float>(layout.text.offset.value[0], layout.text.offset.value[1]));
+            shapingKey.text = feature.label;
+            shaping = shapingCache.get(shapingKey, **fontStack);
 
             // Add the glyphs we need for this label to the glyph atlas.
-            if (shapedText) {
+            if (*shaping) {
                 glyphAtlas.addGlyphs(tileUID, feature.label, layout.text.font, **fontStack, face);
             }
         }
@@ -256,6 +277,8 @@ void SymbolBucket::addFeatures(uintptr_t tileUID,
             }
         }
 
+        const Shaping& shapedText = shaping ? *shaping : noShaping;
+
         // if either shapedText or icon position is present, add the feature
         if (shapedText || shapedIcon) {
             addFeature(feature.geometry, shapedText, shapedIcon, face);
@@ -264,7 +287,7 @@ void SymbolBucket::addFeatures(uintptr_t tileUID,
 
     features.clear();
 
-    placeFeatures(collisionTile, true);
+    placeFeatures(collisionTile, checkpoint, true);
 }
 
 
@@ -354,11 +377,13 @@ bool SymbolBucket::anchorIsTooClose(const std::u32string &text, const float repe
     return false;
 }
 
-void SymbolBucket::placeFeatures(CollisionTile& collisionTile) {
-    placeFeatures(collisionTile, false);
+void SymbolBucket::placeFeatures(CollisionTile& collisionTile, util::CancellationCheckpoint& checkpoint) {
+    placeFeatures(collisionTile, checkpoint, false);
 }
 
-void SymbolBucket::placeFeatures(CollisionTile& collisionTile, bool swapImmediately) {
+void SymbolBucket::placeFeatures(CollisionTile& collisionTile,
+                                 util::CancellationCheckpoint& checkpoint,
+                                 bool swapImmediately) {
 
     renderDataInProgress = std::make_unique<SymbolRenderData>();
 
@@ -391,6 +416,9 @@ void SymbolBucket::placeFeatures(CollisionTile& collisionTile, bool swapImmediat
     }
 
     for (SymbolInstance &symbolInstance : symbolInstances) {
+        if (checkpoint.poll()) {
+            return;
+        }
 
         const bool hasText = symbolInstance.hasText;
         const bool hasIcon = symbolInstance.hasIcon;
@@ -482,9 +510,13 @@ void SymbolBucket::addSymbols(Buffer &buffer, const SymbolQuads &symbols, float
 
         const int glyph_vertex_length = 4;
 
-        if (buffer.groups.empty() || (buffer.groups.back()->vertex_length + glyph_vertex_length > 65535)) {
-            // Move to a new group because the old one can't hold the geometry.
+        if (buffer.groups.empty() || (buffer.groups.back()->vertex_length + glyph_vertex_length > 65535) ||
+            buffer.groups.back()->page != symbol.page) {
+            // Move to a new group because the old one can't hold the geometry, or is drawn with
+            // another glyph atlas page. Groups stay in placement order, so that labels are drawn
+            // in the same order regardless of the pages their glyphs are on.
             buffer.groups.emplace_back(std::make_unique<GroupType>());
+            buffer.groups.back()->page = symbol.page;
         }
 
         // We're generating triangle fans, so we always start with the first
@@ -569,12 +601,17 @@ void SymbolBucket::swapRenderData() {
     }
 }
 
-void SymbolBucket::drawGlyphs(SDFShader &shader) {
+void SymbolBucket::drawGlyphs(SDFShader &shader, GlyphAtlas &glyphAtlas) {
     GLbyte *vertex_index = BUFFER_OFFSET_0;
     GLbyte *elements_index = BUFFER_OFFSET_0;
     auto& text = renderData->text;
+    int boundPage = -1;
     for (auto &group : text.groups) {
         assert(group);
+        if (group->page != boundPage) {
+            glyphAtlas.bind(group->page);
+            boundPage = group->page;
+        }
         group->array[0].bind(shader, text.vertices, text.triangles, vertex_index);
         MBGL_CHECK_ERROR(glDrawElements(GL_TRIANGLES, group->elements_length * 3, GL_UNSIGNED_SHORT, elements_index));
         vertex_index += group->vertex_length * text.vertices.itemSize;
@@ -12,7 +12,7 @@
 #include <mbgl/text/collision_feature.hpp>
 #include <mbgl/text/shaping.hpp>
 #include <mbgl/text/quads.hpp>
-#include <mbgl/style/filter_expression.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/layer/symbol_layer.hpp>
 
 #include <memory>
@@ -60,8 +60,14 @@ class SymbolInstance {
 };
 
 class SymbolBucket : public Bucket {
-    typedef ElementGroup<1> TextElementGroup;
-    typedef ElementGroup<2> IconElementGroup;
+    // Groups of glyphs refer to a single glyph atlas page.
+    template <GLsizei count>
+    struct SymbolElementGroup : public ElementGroup<count> {
+        uint8_t page = 0;
+    };
+
+    typedef SymbolElementGroup<1> TextElementGroup;
+    typedef SymbolElementGroup<2> IconElementGroup;
     typedef ElementGroup<1> CollisionBoxElementGroup;
 
 public:
@@ -71,6 +77,7 @@ public:
     void upload() override;
     void render(Painter&, const StyleLayer&, const TileID&, const mat4&) override;
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
     bool hasTextData() const;
     bool hasIconData() const;
     bool hasCollisionBoxData() const;
@@ -79,17 +86,19 @@ public:
                      SpriteAtlas&,
                      GlyphAtlas&,
                      GlyphStore&,
-                     CollisionTile&);
+                     CollisionTile&,
+                     util::CancellationCheckpoint&);
 
-    void drawGlyphs(SDFShader& shader);
+    void drawGlyphs(SDFShader& shader, GlyphAtlas&);
     void drawIcons(SDFShader& shader);
     void drawIcons(IconShader& shader);
     void drawCollisionBoxes(CollisionBoxShader& shader);
 
     void parseFeatures(const GeometryTileLayer&,
-                       const FilterExpression&);
+                       const CompiledFilter&,
+                       util::CancellationCheckpoint&);
     bool needsDependencies(GlyphStore&, SpriteStore&);
-    void placeFeatures(CollisionTile&) override;
+    void placeFeatures(CollisionTile&, util::CancellationCheckpoint&) override;
 
 private:
     void addFeature(const std::vector<std::vector<Coordinate>> &lines,
@@ -100,7 +109,7 @@ private:
     
     void addToDebugBuffers(CollisionTile &collisionTile);
 
-    void placeFeatures(CollisionTile& collisionTile, bool swapImmediately);
+    void placeFeatures(CollisionTile& collisionTile, util::CancellationCheckpoint&, bool swapImmediately);
     void swapRenderData() override;
 
     // Adds placed items to the buffer.
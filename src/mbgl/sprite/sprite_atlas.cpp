@@ -25,6 +25,7 @@ SpriteAtlas::SpriteAtlas(dimension width_, dimension height_, float pixelRatio_,
       store(store_),
       bin(width_, height_),
       data(std::make_unique<uint32_t[]>(pixelWidth * pixelHeight)),
+      dirtyRegions(pixelWidth, pixelHeight, sizeof(uint32_t)),
       dirty(true) {
     std::fill(data.get(), data.get() + pixelWidth * pixelHeight, 0);
 }
@@ -151,15 +152,32 @@ void SpriteAtlas::copy(const Holder& holder, const bool wrap) {
             { dstPos.x - borderX, dstPos.y + dstPos.h, dstPos.w + border + borderX, border });
     }
 
+    // The image and its borders.
+    const uint32_t dirtyX = dstPos.x > 0 ? dstPos.x - 1 : 0;
+    const uint32_t dirtyY = dstPos.y > 0 ? dstPos.y - 1 : 0;
+    dirtyRegions.add({ dirtyX, dirtyY, dstPos.x + dstPos.w + 1 - dirtyX, dstPos.y + dstPos.h + 1 - dirtyY });
     dirty = true;
 }
 
 void SpriteAtlas::upload() {
+    dirtyRegions.startFrame();
+
     if (dirty) {
         bind();
     }
 }
 
+DirtyRegions::Statistics SpriteAtlas::getUploadStatistics() const {
+    return dirtyRegions.getStatistics();
+}
+
+void SpriteAtlas::dumpDebugLogs() const {
+    const auto statistics = dirtyRegions.getStatistics();
+    Log::Info(Event::General, "SpriteAtlas::frameUploadBytes: %zu", statistics.frameBytes);
+    Log::Info(Event::General, "SpriteAtlas::totalUploadBytes: %zu", statistics.totalBytes);
+    Log::Info(Event::General, "SpriteAtlas::uploadedRegions: %zu", statistics.regions);
+}
+
 void SpriteAtlas::updateDirty() {
     auto dirtySprites = store.getDirty();
     if (dirtySprites.empty()) {
@@ -212,36 +230,17 @@ void SpriteAtlas::bind(bool linear) {
     }
 
     if (dirty) {
-        std::lock_guard<std::recursive_mutex> lock(mtx);
-
-        if (fullUploadRequired) {
-            MBGL_CHECK_ERROR(glTexImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                GL_RGBA, // GLint internalformat
-                pixelWidth, // GLsizei width
-                pixelHeight, // GLsizei height
-                0, // GLint border
-                GL_RGBA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid * data
-            ));
-            fullUploadRequired = false;
-        } else {
-            MBGL_CHECK_ERROR(glTexSubImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                0, // GLint xoffset
-                0, // GLint yoffset
-                pixelWidth, // GLsizei width
-                pixelHeight, // GLsizei height
-                GL_RGBA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid *pixels
-            ));
+        {
+            std::lock_guard<std::recursive_mutex> lock(mtx);
+            if (fullUploadRequired) {
+                dirtyRegions.addAll();
+            }
+            dirtyRegions.stage(data.get());
+            dirty = false;
         }
 
-        dirty = false;
+        dirtyRegions.upload(GL_RGBA, fullUploadRequired);
+        fullUploadRequired = false;
 
 #ifndef GL_ES_VERSION_2_0
         // platform::showColorDebugImage("Sprite Atlas", reinterpret_cast<const char*>(data.get()),
@@ -2,6 +2,7 @@
 #define MBGL_SPRITE_ATLAS
 
 #include <mbgl/geometry/binpack.hpp>
+#include <mbgl/geometry/dirty_regions.hpp>
 #include <mbgl/platform/gl.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/ptr.hpp>
@@ -58,9 +59,13 @@ public:
     void updateDirty();
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // the texture is only bound when the data is out of date (=dirty). Only the regions that
+    // changed are uploaded. Called once per frame.
     void upload();
 
+    DirtyRegions::Statistics getUploadStatistics() const;
+    void dumpDebugLogs() const;
+
     inline dimension getWidth() const { return width; }
     inline dimension getHeight() const { return height; }
     inline dimension getTextureWidth() const { return pixelWidth; }
@@ -91,6 +96,7 @@ private:
     std::map<Key, Holder> images;
     std::set<std::string> uninitialized;
     const std::unique_ptr<uint32_t[]> data;
+    DirtyRegions dirtyRegions;
     std::atomic<bool> dirty;
     bool fullUploadRequired = true;
     GLuint texture = 0;
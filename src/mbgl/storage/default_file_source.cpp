@@ -1,6 +1,7 @@
 #include <mbgl/storage/default_file_source_impl.hpp>
 #include <mbgl/storage/asset_context_base.hpp>
 #include <mbgl/storage/http_context_base.hpp>
+#include <mbgl/storage/mbtiles_context_base.hpp>
 #include <mbgl/storage/network_status.hpp>
 
 #include <mbgl/storage/response.hpp>
@@ -27,6 +28,16 @@ namespace algo = boost::algorithm;
 
 namespace mbgl {
 
+namespace {
+
+// Tile archives are local databases already; storing their contents in the cache again would only
+// slow them down.
+bool isCacheable(const Resource& resource) {
+    return !algo::starts_with(resource.url, "mbtiles://");
+}
+
+} // namespace
+
 DefaultFileSource::DefaultFileSource(FileCache* cache, const std::string& root)
     : thread(std::make_unique<util::Thread<Impl>>(
           util::ThreadContext{ "FileSource", util::ThreadType::Unknown, util::ThreadPriority::Low },
@@ -37,6 +48,10 @@ DefaultFileSource::DefaultFileSource(FileCache* cache, const std::string& root)
 DefaultFileSource::~DefaultFileSource() = default;
 
 std::unique_ptr<FileRequest> DefaultFileSource::request(const Resource& resource, Callback callback) {
+    return request(resource, resource.defaultPriority(), callback);
+}
+
+std::unique_ptr<FileRequest> DefaultFileSource::request(const Resource& resource, RequestPriority priority, Callback callback) {
     if (!callback) {
         throw util::MisuseException("FileSource callback can't be empty");
     }
@@ -67,7 +82,7 @@ std::unique_ptr<FileRequest> DefaultFileSource::request(const Resource& resource
 
     Resource res { resource.kind, url };
     auto req = std::make_unique<DefaultFileRequest>(res, *this);
-    req->workRequest = thread->invokeWithCallback(&Impl::add, callback, res, req.get());
+    req->workRequest = thread->invokeWithCallback(&Impl::add, callback, res, req.get(), priority);
     return std::move(req);
 }
 
@@ -75,6 +90,22 @@ void DefaultFileSource::cancel(const Resource& res, FileRequest* req) {
     thread->invoke(&Impl::cancel, res, req);
 }
 
+void DefaultFileSource::setPriority(const Resource& res, FileRequest* req, RequestPriority priority) {
+    thread->invoke(&Impl::setPriority, res, req, priority);
+}
+
+void DefaultFileSource::onLowMemory() {
+    thread->invoke(&Impl::clearMemoryCache);
+}
+
+void DefaultFileSource::setMemoryCacheSize(uint64_t size) {
+    thread->invoke(&Impl::setMemoryCacheSize, size);
+}
+
+DefaultFileSource::MemoryCacheStatistics DefaultFileSource::getMemoryCacheStatistics() const {
+    return thread->invokeSync<MemoryCacheStatistics>(&Impl::getMemoryCacheStatistics);
+}
+
 // ----- Impl -----
 
 DefaultFileSource::Impl::Impl(FileCache* cache_, const std::string& root)
@@ -83,6 +114,7 @@ DefaultFileSource::Impl::Impl(FileCache* cache_, const std::string& root)
       assetRoot(root.empty() ? platform::assetRoot() : root),
       assetContext(AssetContextBase::createContext(loop)),
       httpContext(HTTPContextBase::createContext(loop)),
+      mbtilesContext(MBTilesContextBase::createContext(loop)),
       reachability(std::make_unique<uv::async>(loop, std::bind(&Impl::networkIsReachableAgain, this))) {
     // Subscribe to network status changes, but make sure that this async handle doesn't keep the
     // loop alive; otherwise our app wouldn't terminate. After all, we only need status change
@@ -107,16 +139,32 @@ void DefaultFileSource::Impl::networkIsReachableAgain() {
     }
 }
 
-void DefaultFileSource::Impl::add(Resource resource, FileRequest* req, Callback callback) {
-    auto& request = *pending.emplace(resource,
-        std::make_unique<DefaultFileRequestImpl>(resource)).first->second;
+void DefaultFileSource::Impl::add(Resource resource, FileRequest* req, RequestPriority priority, Callback callback) {
+    auto it = pending.emplace(resource, std::make_unique<DefaultFileRequestImpl>(resource));
+    auto& request = *it.first->second;
+
+    if (it.second && cache) {
+        // Recently cancelled requests leave their response in memory. If it is still fresh, we
+        // don't have to go to the cache at all.
+        if (auto response = memoryCache.get(resource)) {
+            request.setResponse(response);
+            // Revalidate the response once it expires, like responses that come from the cache.
+            reschedule(request);
+        }
+    }
 
     // Trigger a potentially required refresh of this Request
     update(request);
 
     // Add this request as an observer so that it'll get notified when something about this
     // request changes.
-    request.addObserver(req, callback);
+    request.addObserver(req, priority, callback);
+
+    // A request that was just started hasn't been sent yet, so it still goes out with the
+    // priority of the new observer.
+    if (request.realRequest) {
+        request.realRequest->setPriority(request.getPriority());
+    }
 }
 
 void DefaultFileSource::Impl::update(DefaultFileRequestImpl& request) {
@@ -141,7 +189,7 @@ void DefaultFileSource::Impl::update(DefaultFileRequestImpl& request) {
     } else if (!request.cacheRequest && !request.realRequest) {
         // There is no request in progress, and we don't have a response yet. This means we'll have
         // to start the request ourselves.
-        if (cache) {
+        if (cache && isCacheable(request.resource)) {
             startCacheRequest(request);
         } else {
             startRealRequest(request);
@@ -185,7 +233,7 @@ void DefaultFileSource::Impl::startRealRequest(DefaultFileRequestImpl& request)
     auto callback = [this, &request](std::shared_ptr<const Response> response) {
         request.realRequest = nullptr;
 
-        if (cache) {
+        if (cache && isCacheable(request.resource)) {
             // Store response in database. Make sure we only refresh the expires column if the data
             // didn't change.
             FileCache::Hint hint = FileCache::Hint::Full;
@@ -203,9 +251,12 @@ void DefaultFileSource::Impl::startRealRequest(DefaultFileRequestImpl& request)
     if (algo::starts_with(request.resource.url, "asset://")) {
         request.realRequest =
             assetContext->createRequest(request.resource, callback, loop, assetRoot);
+    } else if (algo::starts_with(request.resource.url, "mbtiles://")) {
+        request.realRequest = mbtilesContext->createRequest(request.resource, callback, loop);
     } else {
         request.realRequest =
             httpContext->createRequest(request.resource, callback, loop, request.getResponse());
+        request.realRequest->setPriority(request.getPriority());
     }
 }
 
@@ -217,6 +268,9 @@ void DefaultFileSource::Impl::cancel(Resource resource, FileRequest* req) {
         auto& request = *it->second;
         request.removeObserver(req);
         if (!request.hasObservers()) {
+            if (cache) {
+                memoryCache.add(resource, request.getResponse());
+            }
             pending.erase(it);
         }
     } else {
@@ -225,6 +279,33 @@ void DefaultFileSource::Impl::cancel(Resource resource, FileRequest* req) {
     }
 }
 
+void DefaultFileSource::Impl::setPriority(Resource resource, FileRequest* req, RequestPriority priority) {
+    auto it = pending.find(resource);
+    if (it == pending.end()) {
+        // The request completed or was cancelled in the meantime.
+        return;
+    }
+
+    auto& request = *it->second;
+    const RequestPriority previous = request.getPriority();
+    request.setPriority(req, priority);
+    if (request.realRequest && request.getPriority() != previous) {
+        request.realRequest->setPriority(request.getPriority());
+    }
+}
+
+void DefaultFileSource::Impl::setMemoryCacheSize(uint64_t size) {
+    memoryCache.setSize(size);
+}
+
+void DefaultFileSource::Impl::clearMemoryCache() {
+    memoryCache.clear();
+}
+
+DefaultFileSource::MemoryCacheStatistics DefaultFileSource::Impl::getMemoryCacheStatistics() const {
+    return memoryCache.getStatistics();
+}
+
 void DefaultFileSource::Impl::reschedule(DefaultFileRequestImpl& request) {
     if (request.realRequest) {
         // There's already a request in progress; don't start another one.
@@ -258,8 +339,9 @@ DefaultFileRequestImpl::~DefaultFileRequestImpl() {
     // timerRequest and cacheRequest are automatically canceld upon destruction.
 }
 
-void DefaultFileRequestImpl::addObserver(FileRequest* req, Callback callback) {
+void DefaultFileRequestImpl::addObserver(FileRequest* req, RequestPriority priority, Callback callback) {
     observers.emplace(req, callback);
+    priorities.emplace(req, priority);
 
     if (response) {
         // We've got a response, so send the (potentially stale) response to the requester.
@@ -269,6 +351,25 @@ void DefaultFileRequestImpl::addObserver(FileRequest* req, Callback callback) {
 
 void DefaultFileRequestImpl::removeObserver(FileRequest* req) {
     observers.erase(req);
+    priorities.erase(req);
+}
+
+void DefaultFileRequestImpl::setPriority(FileRequest* req, RequestPriority priority) {
+    auto it = priorities.find(req);
+    if (it != priorities.end()) {
+        it->second = priority;
+    }
+}
+
+RequestPriority DefaultFileRequestImpl::getPriority() const {
+    RequestPriority result = resource.defaultPriority();
+    if (!priorities.empty()) {
+        result = RequestPriority::Prefetch;
+        for (const auto& priority : priorities) {
+            result = std::min(result, priority.second);
+        }
+    }
+    return result;
 }
 
 bool DefaultFileRequestImpl::hasObservers() const {
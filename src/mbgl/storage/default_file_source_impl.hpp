@@ -4,6 +4,8 @@
 #include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/storage/asset_context_base.hpp>
 #include <mbgl/storage/http_context_base.hpp>
+#include <mbgl/storage/mbtiles_context_base.hpp>
+#include <mbgl/storage/response_cache.hpp>
 #include <mbgl/util/noncopyable.hpp>
 
 #include <set>
@@ -25,6 +27,10 @@ public:
         fileSource.cancel(resource, this);
     }
 
+    void setPriority(RequestPriority priority) override {
+        fileSource.setPriority(resource, this, priority);
+    }
+
     Resource resource;
     DefaultFileSource& fileSource;
 
@@ -46,10 +52,14 @@ public:
     ~DefaultFileRequestImpl();
 
     // Observer accessors.
-    void addObserver(FileRequest*, Callback);
+    void addObserver(FileRequest*, RequestPriority, Callback);
     void removeObserver(FileRequest*);
     bool hasObservers() const;
 
+    // The highest priority of all observers.
+    void setPriority(FileRequest*, RequestPriority);
+    RequestPriority getPriority() const;
+
     // Updates/gets the response of this request object.
     void setResponse(const std::shared_ptr<const Response>&);
     const std::shared_ptr<const Response>& getResponse() const;
@@ -70,6 +80,7 @@ public:
 private:
     // Stores a set of all observing Request objects.
     std::unordered_map<FileRequest*, Callback> observers;
+    std::unordered_map<FileRequest*, RequestPriority> priorities;
 
     // The current response data. We're storing it because we can satisfy requests for the same
     // resource directly by returning this response object. We also need it to create conditional
@@ -90,8 +101,13 @@ public:
 
     void networkIsReachableAgain();
 
-    void add(Resource, FileRequest*, Callback);
+    void add(Resource, FileRequest*, RequestPriority, Callback);
     void cancel(Resource, FileRequest*);
+    void setPriority(Resource, FileRequest*, RequestPriority);
+
+    void setMemoryCacheSize(uint64_t size);
+    void clearMemoryCache();
+    MemoryCacheStatistics getMemoryCacheStatistics() const;
 
 private:
     void update(DefaultFileRequestImpl&);
@@ -100,11 +116,13 @@ private:
     void reschedule(DefaultFileRequestImpl&);
 
     std::unordered_map<Resource, std::unique_ptr<DefaultFileRequestImpl>, Resource::Hash> pending;
+    ResponseCache memoryCache { 8 * 1024 * 1024 };
     uv_loop_t* const loop;
     FileCache* const cache;
     const std::string assetRoot;
     const std::unique_ptr<AssetContextBase> assetContext;
     const std::unique_ptr<HTTPContextBase> httpContext;
+    const std::unique_ptr<MBTilesContextBase> mbtilesContext;
     const std::unique_ptr<uv::async> reachability;
 };
 
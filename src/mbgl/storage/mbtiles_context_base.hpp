@@ -0,0 +1,23 @@
+#ifndef MBGL_STORAGE_MBTILES_CONTEXT_BASE
+#define MBGL_STORAGE_MBTILES_CONTEXT_BASE
+
+#include <mbgl/storage/request_base.hpp>
+
+typedef struct uv_loop_s uv_loop_t;
+
+namespace mbgl {
+
+// Serves mbtiles:// URLs from local MBTiles archives. `mbtiles:///path/to/file.mbtiles` returns
+// TileJSON built from the archive's metadata, and the tile URLs in it have the form
+// `mbtiles:///path/to/file.mbtiles/{z}/{x}/{y}`.
+class MBTilesContextBase {
+public:
+    static std::unique_ptr<MBTilesContextBase> createContext(uv_loop_t*);
+
+    virtual ~MBTilesContextBase() = default;
+    virtual RequestBase* createRequest(const Resource&, RequestBase::Callback, uv_loop_t*) = 0;
+};
+
+} // namespace mbgl
+
+#endif // MBGL_STORAGE_MBTILES_CONTEXT_BASE
@@ -0,0 +1,371 @@
+#include <mbgl/storage/offline_download.hpp>
+#include <mbgl/storage/file_source.hpp>
+
+#include <mbgl/layer/symbol_layer.hpp>
+#include <mbgl/map/source.hpp>
+#include <mbgl/style/style_calculation_parameters.hpp>
+#include <mbgl/style/style_parser.hpp>
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/util/box.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/tile_cover.hpp>
+#include <mbgl/util/token.hpp>
+#include <mbgl/util/url.hpp>
+
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+
+namespace mbgl {
+
+namespace {
+
+// The number of resources of every group that are loaded while resolving to estimate the size of
+// the whole group.
+const std::size_t samplesPerGroup = 4;
+
+// Glyphs are requested in ranges of 256 code points. Any of them may be needed offline.
+const uint32_t glyphRangeSize = 256;
+const uint32_t glyphRangeCount = 256;
+
+std::string parseError(const rapidjson::Document& document) {
+    std::stringstream message;
+    message << document.GetErrorOffset() << " - " << rapidjson::GetParseError_En(document.GetParseError());
+    return message.str();
+}
+
+} // namespace
+
+OfflineDownload::OfflineDownload(FileSource& fileSource_,
+                                 OfflineRegionDefinition definition_,
+                                 Observer& observer_)
+    : fileSource(fileSource_),
+      definition(std::move(definition_)),
+      observer(observer_) {
+    // The style and the TileJSON documents of its sources.
+    addResource({ Resource::Kind::Style, definition.styleURL }, addGroup());
+}
+
+OfflineDownload::~OfflineDownload() = default;
+
+void OfflineDownload::resolve() {
+    if (!resolveRequested) {
+        resolveRequested = true;
+        resolveQueue.push_back(0);
+        pendingResolves++;
+    }
+    dispatch();
+}
+
+void OfflineDownload::start() {
+    downloading = true;
+    resolve();
+}
+
+void OfflineDownload::stop() {
+    downloading = false;
+    cancelDownloads();
+}
+
+void OfflineDownload::cancelDownloads() {
+    // Requests that are needed to resolve the region keep going; everything else is requested
+    // again, in the same order, once the download continues.
+    std::vector<std::pair<uint64_t, std::size_t>> cancelled;
+    for (const auto& fetch : fetches) {
+        if (!fetch.second.resolving) {
+            cancelled.emplace_back(fetch.first, fetch.second.entry);
+        }
+    }
+    std::sort(cancelled.begin(), cancelled.end());
+    for (auto it = cancelled.rbegin(); it != cancelled.rend(); ++it) {
+        fetches.erase(it->first);
+        downloadQueue.push_front(it->second);
+    }
+}
+
+void OfflineDownload::setMaximumConcurrentRequests(std::size_t count) {
+    maximumConcurrentRequests = std::max<std::size_t>(count, 1);
+    dispatch();
+}
+
+void OfflineDownload::setMaximumCacheSize(uint64_t size) {
+    maximumCacheSize = size;
+    updateEstimate();
+    if (status.exceedsCacheSize) {
+        cancelDownloads();
+    }
+    dispatch();
+}
+
+std::size_t OfflineDownload::addGroup() {
+    groups.emplace_back();
+    return groups.size() - 1;
+}
+
+std::size_t OfflineDownload::addResource(Resource resource, std::size_t group) {
+    if (!urls.insert(resource.url).second) {
+        // Sources may share tiles, and zoom levels beyond the maximum zoom of a source reuse
+        // its tiles.
+        return entries.size();
+    }
+
+    entries.push_back({ std::move(resource), group });
+    groups[group].count++;
+    status.requiredResourceCount++;
+    return entries.size() - 1;
+}
+
+void OfflineDownload::dispatch() {
+    // Responses that arrive synchronously call this from within fetch(). The loop below picks up
+    // the freed slots instead, so that the stack doesn't grow with every resource.
+    if (dispatching) {
+        return;
+    }
+
+    dispatching = true;
+    while (fetches.size() < maximumConcurrentRequests) {
+        if (!resolveQueue.empty()) {
+            const std::size_t entry = resolveQueue.front();
+            resolveQueue.pop_front();
+            fetch(entry, true);
+        } else if (downloading && status.resolved && !status.exceedsCacheSize && !downloadQueue.empty()) {
+            const std::size_t entry = downloadQueue.front();
+            downloadQueue.pop_front();
+            fetch(entry, false);
+        } else {
+            break;
+        }
+    }
+    dispatching = false;
+}
+
+void OfflineDownload::fetch(std::size_t entry, bool resolving) {
+    const uint64_t id = nextFetch++;
+
+    // Tracked before the request is made, since file sources may respond synchronously.
+    fetches.emplace(id, Fetch { entry, resolving, nullptr });
+    auto request = fileSource.request(entries[entry].resource, [this, id, entry, resolving] (Response res) {
+        if (res.stale) {
+            // A fresh response follows.
+            return;
+        }
+
+        fetches.erase(id);
+        finish(entry, resolving, res);
+        dispatch();
+    });
+
+    // The fetch is gone if it already finished, or if it was cancelled in the meantime.
+    auto it = fetches.find(id);
+    if (it != fetches.end()) {
+        it->second.request = std::move(request);
+    }
+}
+
+void OfflineDownload::finish(std::size_t index, bool resolving, const Response& res) {
+    const Entry& entry = entries[index];
+
+    if (res.error) {
+        status.failedResourceCount++;
+        observer.onResourceError(entry.resource, *res.error);
+    } else {
+        Group& group = groups[entry.group];
+        group.completedCount++;
+        group.completedSize += res.data->size();
+        status.completedResourceCount++;
+        status.completedResourceSize += res.data->size();
+
+        if (entry.resource.kind == Resource::Kind::Style) {
+            loadStyle(*res.data);
+        } else if (entry.resource.kind == Resource::Kind::Source) {
+            auto it = sourceEntries.find(index);
+            if (it != sourceEntries.end()) {
+                loadSource(*it->second, *res.data);
+            }
+        }
+    }
+
+    updateEstimate();
+
+    if (status.exceedsCacheSize) {
+        // Resources of the region that were stored already would be evicted.
+        cancelDownloads();
+    }
+
+    if (resolving) {
+        assert(pendingResolves > 0);
+        pendingResolves--;
+
+        if (pendingResolves == 0 && !enumerated) {
+            // The style and all TileJSON documents are loaded; load the samples next.
+            enumerate();
+        }
+
+        if (pendingResolves == 0 && !status.resolved) {
+            status.resolved = true;
+            observer.onResolved(status);
+        }
+    }
+
+    observer.onStatusChanged(status);
+}
+
+void OfflineDownload::loadStyle(const std::string& json) {
+    rapidjson::Document document;
+    document.Parse<0>(json.c_str());
+    if (document.HasParseError()) {
+        observer.onResourceError(entries[0].resource,
+            Response::Error(Response::Error::Reason::Other, "Failed to parse style: " + parseError(document)));
+        return;
+    }
+
+    StyleParser parser;
+    parser.parse(document);
+    glyphURL = parser.getGlyphURL();
+    spriteURL = parser.getSpriteURL();
+
+    for (const auto& layer : parser.getLayers()) {
+        if (layer->type != StyleLayerType::Symbol) {
+            continue;
+        }
+
+        // Font stacks and labels may be functions of the zoom level.
+        auto& text = static_cast<SymbolLayer&>(*layer).layout.text;
+        for (double z = std::floor(definition.minZoom); z <= std::ceil(definition.maxZoom); z++) {
+            const StyleCalculationParameters parameters(z);
+            text.field.calculate(parameters);
+            text.font.calculate(parameters);
+            if (!text.field.value.empty() && !text.font.value.empty()) {
+                fontStacks.insert(text.font.value);
+            }
+        }
+    }
+
+    sources = parser.getSources();
+    for (const auto& source : sources) {
+        if (!source->info.url.empty()) {
+            const std::size_t entry = addResource({ Resource::Kind::Source, source->info.url }, entries[0].group);
+            if (entry < entries.size()) {
+                sourceEntries.emplace(entry, source.get());
+                resolveQueue.push_back(entry);
+                pendingResolves++;
+            }
+        }
+    }
+}
+
+void OfflineDownload::loadSource(Source& source, const std::string& json) {
+    rapidjson::Document document;
+    document.Parse<0>(json.c_str());
+    if (document.HasParseError()) {
+        observer.onResourceError({ Resource::Kind::Source, source.info.url },
+            Response::Error(Response::Error::Reason::Other, "Failed to parse TileJSON: " + parseError(document)));
+        source.info.tiles.clear();
+        return;
+    }
+
+    source.info.parseTileJSONProperties(document);
+}
+
+void OfflineDownload::enumerate() {
+    enumerated = true;
+
+    std::vector<std::size_t> groupStarts;
+    auto beginGroup = [&] {
+        groupStarts.push_back(entries.size());
+        return addGroup();
+    };
+
+    if (!spriteURL.empty()) {
+        const std::size_t group = beginGroup();
+        const std::string base = spriteURL + (definition.pixelRatio > 1 ? "@2x" : "");
+        addResource({ Resource::Kind::SpriteJSON, base + ".json" }, group);
+        addResource({ Resource::Kind::SpriteImage, base + ".png" }, group);
+    }
+
+    if (!glyphURL.empty() && !fontStacks.empty()) {
+        const std::size_t group = beginGroup();
+        for (const auto& fontStack : fontStacks) {
+            for (uint32_t i = 0; i < glyphRangeCount; i++) {
+                const GlyphRange range { i * glyphRangeSize, (i + 1) * glyphRangeSize - 1 };
+                const std::string url = util::replaceTokens(glyphURL, [&](const std::string& name) -> std::string {
+                    if (name == "fontstack") return util::percentEncode(fontStack);
+                    if (name == "range") return util::toString(range.first) + "-" + util::toString(range.second);
+                    return "";
+                });
+                addResource({ Resource::Kind::Glyphs, url }, group);
+            }
+        }
+    }
+
+    const PrecisionPoint nw = LatLng(definition.bounds.ne.latitude, definition.bounds.sw.longitude).project();
+    const PrecisionPoint se = LatLng(definition.bounds.sw.latitude, definition.bounds.ne.longitude).project();
+
+    for (const auto& source : sources) {
+        const SourceInfo& info = source->info;
+        if ((info.type != SourceType::Vector && info.type != SourceType::Raster) || info.tiles.empty()) {
+            continue;
+        }
+
+        // Matches the zoom levels Source::coveringZoomLevel() picks for the map's zoom levels.
+        const double offset = std::log(util::tileSize / info.tile_size) / std::log(2);
+        auto coveringZoom = [&](double zoom) {
+            return int32_t(info.type == SourceType::Raster ? std::round(zoom + offset) : std::floor(zoom + offset));
+        };
+
+        const std::size_t group = beginGroup();
+        const int32_t minZ = std::max<int32_t>(coveringZoom(definition.minZoom), info.min_zoom);
+        const int32_t maxZ = std::min<int32_t>(coveringZoom(definition.maxZoom), info.max_zoom);
+        for (int32_t z = minZ; z <= maxZ; z++) {
+            const double scale = std::pow(2.0, z);
+            const box bounds(TileCoordinate(nw.x * scale, nw.y * scale, z),
+                             TileCoordinate(se.x * scale, nw.y * scale, z),
+                             TileCoordinate(se.x * scale, se.y * scale, z),
+                             TileCoordinate(nw.x * scale, se.y * scale, z));
+            for (const auto& id : tileCover(z, bounds, z)) {
+                addResource({ Resource::Kind::Tile, info.tileURL(id, definition.pixelRatio) }, group);
+            }
+        }
+    }
+
+    // Sample resources spread evenly across every group, so that the sample isn't biased
+    // towards low zoom levels.
+    groupStarts.push_back(entries.size());
+    for (std::size_t i = 0; i + 1 < groupStarts.size(); i++) {
+        const std::size_t begin = groupStarts[i];
+        const std::size_t count = groupStarts[i + 1] - begin;
+        const std::size_t samples = std::min(count, samplesPerGroup);
+
+        std::size_t nextSample = 0;
+        for (std::size_t j = 0; j < count; j++) {
+            if (nextSample < samples && j == nextSample * count / samples) {
+                resolveQueue.push_back(begin + j);
+                pendingResolves++;
+                nextSample++;
+            } else {
+                downloadQueue.push_back(begin + j);
+            }
+        }
+    }
+}
+
+void OfflineDownload::updateEstimate() {
+    // Assumes that the remaining resources of every group have the average size of the completed
+    // ones.
+    uint64_t estimate = 0;
+    for (const auto& group : groups) {
+        estimate += group.completedSize;
+        if (group.completedCount > 0 && group.count > group.completedCount) {
+            estimate += (group.count - group.completedCount) * group.completedSize / group.completedCount;
+        }
+    }
+    status.estimatedResourceSize = estimate;
+    status.exceedsCacheSize = maximumCacheSize && estimate > maximumCacheSize;
+}
+
+} // namespace mbgl
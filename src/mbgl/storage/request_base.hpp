@@ -24,6 +24,10 @@ public:
     virtual ~RequestBase() = default;
     virtual void cancel() = 0;
 
+    // Implementations that limit the number of concurrent requests start requests with a higher
+    // priority first.
+    virtual void setPriority(RequestPriority) {}
+
 protected:
     Resource resource;
     Callback notify;
@@ -0,0 +1,97 @@
+#include <mbgl/storage/response_cache.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+void ResponseCache::setSize(uint64_t size) {
+    maximumSize = size;
+
+    while (statistics.size > maximumSize) {
+        erase(std::prev(entries.end()));
+    }
+}
+
+void ResponseCache::add(const Resource& resource, std::shared_ptr<const Response> response) {
+    auto it = index.find(resource);
+    if (it != index.end()) {
+        erase(it->second);
+    }
+
+    // Errors are retried, and expired responses have to be revalidated, so neither is worth
+    // keeping.
+    if (!response || response->error || response->isExpired()) {
+        return;
+    }
+
+    const uint64_t size = resource.url.size() + (response->data ? response->data->size() : 0);
+    if (size > maximumSize) {
+        return;
+    }
+
+    entries.push_front({ resource, std::move(response), size });
+    index.emplace(resource, entries.begin());
+    statistics.size += size;
+
+    // Purge the least recently used responses if necessary.
+    while (statistics.size > maximumSize) {
+        erase(std::prev(entries.end()));
+    }
+}
+
+std::shared_ptr<const Response> ResponseCache::get(const Resource& resource) {
+    std::shared_ptr<const Response> response;
+
+    auto it = index.find(resource);
+    if (it != index.end()) {
+        response = it->second->response;
+        erase(it->second);
+    }
+
+    if (response && response->isExpired()) {
+        // The response expired while it was cached. Let the FileCache return it as a stale
+        // response so that it gets revalidated.
+        response = nullptr;
+    }
+
+    if (response) {
+        rate(resource.kind).hits++;
+    } else {
+        rate(resource.kind).misses++;
+    }
+
+    return response;
+}
+
+void ResponseCache::clear() {
+    entries.clear();
+    index.clear();
+    statistics.size = 0;
+}
+
+ResponseCache::Statistics ResponseCache::getStatistics() const {
+    return statistics;
+}
+
+void ResponseCache::erase(std::list<Entry>::iterator it) {
+    assert(statistics.size >= it->size);
+    statistics.size -= it->size;
+    index.erase(it->resource);
+    entries.erase(it);
+}
+
+ResponseCache::Statistics::Rate& ResponseCache::rate(Resource::Kind kind) {
+    switch (kind) {
+    case Resource::Kind::Tile:
+        return statistics.tiles;
+    case Resource::Kind::Glyphs:
+        return statistics.glyphs;
+    case Resource::Kind::SpriteImage:
+    case Resource::Kind::SpriteJSON:
+        return statistics.sprites;
+    default:
+        return statistics.other;
+    }
+}
+
+} // namespace mbgl
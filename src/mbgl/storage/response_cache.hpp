@@ -0,0 +1,56 @@
+#ifndef MBGL_STORAGE_RESPONSE_CACHE
+#define MBGL_STORAGE_RESPONSE_CACHE
+
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace mbgl {
+
+// Keeps the most recently used responses in memory after all requests for them were cancelled,
+// so that requesting them again doesn't have to go through the FileCache. Bounded by the number
+// of bytes of response data. Only fresh, successful responses are kept.
+class ResponseCache {
+public:
+    using Statistics = DefaultFileSource::MemoryCacheStatistics;
+
+    ResponseCache(uint64_t maximumSize_ = 0) : maximumSize(maximumSize_) {}
+
+    void setSize(uint64_t);
+    uint64_t getSize() const { return maximumSize; }
+
+    void add(const Resource&, std::shared_ptr<const Response>);
+
+    // Removes the response from the cache and returns it, or returns nullptr if there is no fresh
+    // response for the resource. Counts a hit or a miss.
+    std::shared_ptr<const Response> get(const Resource&);
+
+    void clear();
+
+    Statistics getStatistics() const;
+
+private:
+    struct Entry {
+        Resource resource;
+        std::shared_ptr<const Response> response;
+        uint64_t size;
+    };
+
+    void erase(std::list<Entry>::iterator);
+    Statistics::Rate& rate(Resource::Kind);
+
+    // Most recently used entries first.
+    std::list<Entry> entries;
+    std::unordered_map<Resource, std::list<Entry>::iterator, Resource::Hash> index;
+
+    uint64_t maximumSize;
+    Statistics statistics;
+};
+
+} // namespace mbgl
+
+#endif
@@ -0,0 +1,271 @@
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/filter_expression_private.hpp>
+#include <mbgl/map/geometry_tile.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace mbgl {
+
+namespace {
+
+const uint8_t allTypes = 0xF;
+
+// Reports a fixed feature type for $type and no value for any other key.
+class FeatureTypeExtractor {
+public:
+    FeatureTypeExtractor(FeatureType type_) : type(type_) {}
+
+    mapbox::util::optional<Value> getValue(const std::string& key) const {
+        if (key == "$type") {
+            return Value(uint64_t(type));
+        }
+        return {};
+    }
+
+private:
+    FeatureType type;
+};
+
+} // namespace
+
+// Translates a filter expression into an intermediate tree, simplifies it, and emits the
+// tree in prefix order.
+class FilterCompiler : public mapbox::util::static_visitor<void> {
+public:
+    using Op = CompiledFilter::Op;
+
+    struct Node {
+        Op op = Op::Type;
+        uint8_t typeMask = 0;
+        uint32_t key = 0;
+        uint32_t operand = 0;
+        std::vector<Node> children;
+    };
+
+    FilterCompiler(CompiledFilter& filter_) : filter(filter_) {}
+
+    void compile(const FilterExpression& expression) {
+        emit(simplify(translate(expression)));
+    }
+
+    void operator()(const NullExpression&) { node = typeNode(allTypes); }
+    void operator()(const EqualsExpression& e) { node = leaf(Op::Equals, e); }
+    void operator()(const NotEqualsExpression& e) { node = leaf(Op::NotEquals, e); }
+    void operator()(const LessThanExpression& e) { node = leaf(Op::LessThan, e); }
+    void operator()(const LessThanEqualsExpression& e) { node = leaf(Op::LessThanEquals, e); }
+    void operator()(const GreaterThanExpression& e) { node = leaf(Op::GreaterThan, e); }
+    void operator()(const GreaterThanEqualsExpression& e) { node = leaf(Op::GreaterThanEquals, e); }
+    void operator()(const InExpression& e) { node = setLeaf(Op::In, e); }
+    void operator()(const NotInExpression& e) { node = setLeaf(Op::NotIn, e); }
+    void operator()(const AnyExpression& e) { node = compound(Op::Any, e); }
+    void operator()(const AllExpression& e) { node = compound(Op::All, e); }
+    void operator()(const NoneExpression& e) { node = compound(Op::None, e); }
+
+private:
+    static Node typeNode(uint8_t mask) {
+        Node result;
+        result.op = Op::Type;
+        result.typeMask = mask;
+        return result;
+    }
+
+    Node translate(const FilterExpression& expression) {
+        mapbox::util::apply_visitor(*this, expression);
+        return std::move(node);
+    }
+
+    // Comparisons against $type only depend on the feature type, so we evaluate them for every
+    // possible type up front.
+    template <class E>
+    static Node typeTest(const E& expression) {
+        uint8_t mask = 0;
+        for (uint8_t type = 0; type < 4; type++) {
+            if (expression.evaluate(FeatureTypeExtractor(FeatureType(type)))) {
+                mask |= 1u << type;
+            }
+        }
+        return typeNode(mask);
+    }
+
+    template <class E>
+    Node leaf(Op op, const E& expression) {
+        if (expression.key == "$type") {
+            return typeTest(expression);
+        }
+
+        Node result;
+        result.op = op;
+        result.key = keyIndex(expression.key);
+        result.operand = uint32_t(filter.values.size());
+        filter.values.push_back(expression.value);
+        return result;
+    }
+
+    template <class E>
+    Node setLeaf(Op op, const E& expression) {
+        if (expression.key == "$type") {
+            return typeTest(expression);
+        }
+
+        CompiledFilter::ValueSet set;
+        for (const auto& value : expression.values) {
+            if (value.template is<std::string>()) {
+                set.strings.push_back(value.template get<std::string>());
+            } else {
+                set.others.push_back(value);
+            }
+        }
+        std::sort(set.strings.begin(), set.strings.end());
+        set.strings.erase(std::unique(set.strings.begin(), set.strings.end()), set.strings.end());
+
+        Node result;
+        result.op = op;
+        result.key = keyIndex(expression.key);
+        result.operand = uint32_t(filter.sets.size());
+        filter.sets.push_back(std::move(set));
+        return result;
+    }
+
+    template <class E>
+    Node compound(Op op, const E& expression) {
+        Node result;
+        result.op = op;
+        for (const auto& child : expression.expressions) {
+            result.children.push_back(translate(child));
+        }
+        return result;
+    }
+
+    uint32_t keyIndex(const std::string& key) {
+        auto it = std::find(filter.keys.begin(), filter.keys.end(), key);
+        if (it != filter.keys.end()) {
+            return uint32_t(it - filter.keys.begin());
+        }
+        filter.keys.push_back(key);
+        return uint32_t(filter.keys.size() - 1);
+    }
+
+    // Rough number of property lookups needed to evaluate a node.
+    static std::size_t cost(const Node& n) {
+        switch (n.op) {
+        case Op::Type:
+            return 0;
+        case Op::In:
+        case Op::NotIn:
+            return 2;
+        case Op::Any:
+        case Op::All:
+        case Op::None: {
+            std::size_t sum = 2;
+            for (const auto& child : n.children) {
+                sum += cost(child);
+            }
+            return sum;
+        }
+        default:
+            return 1;
+        }
+    }
+
+    static Node simplify(Node n) {
+        if (n.op != Op::Any && n.op != Op::All && n.op != Op::None) {
+            return n;
+        }
+
+        // none(a, b, ...) is the negation of any(a, b, ...).
+        const Op op = n.op == Op::All ? Op::All : Op::Any;
+
+        // Start out with the identity element of the operation.
+        uint8_t mask = op == Op::All ? allTypes : 0;
+        std::vector<Node> children;
+
+        for (auto& child : n.children) {
+            Node simplified = simplify(std::move(child));
+            if (simplified.op == Op::Type) {
+                if (op == Op::All) {
+                    mask &= simplified.typeMask;
+                } else {
+                    mask |= simplified.typeMask;
+                }
+            } else if (simplified.op == op) {
+                // all(a, all(b, c)) is all(a, b, c); the same goes for any.
+                std::move(simplified.children.begin(), simplified.children.end(), std::back_inserter(children));
+            } else {
+                children.push_back(std::move(simplified));
+            }
+        }
+
+        Node result;
+        if (children.empty() || (op == Op::All && mask == 0) || (op == Op::Any && mask == allTypes)) {
+            // The result only depends on the feature type.
+            result = typeNode(mask);
+        } else {
+            if ((op == Op::All && mask != allTypes) || (op == Op::Any && mask != 0)) {
+                children.push_back(typeNode(mask));
+            }
+
+            std::stable_sort(children.begin(), children.end(), [] (const Node& a, const Node& b) {
+                return cost(a) < cost(b);
+            });
+
+            if (children.size() == 1) {
+                result = std::move(children.front());
+            } else {
+                result.op = op;
+                result.children = std::move(children);
+            }
+        }
+
+        if (n.op == Op::None) {
+            if (result.op == Op::Type) {
+                result.typeMask = ~result.typeMask & allTypes;
+            } else if (result.op == Op::Any) {
+                result.op = Op::None;
+            } else {
+                Node negation;
+                negation.op = Op::None;
+                negation.children.push_back(std::move(result));
+                result = std::move(negation);
+            }
+        }
+
+        return result;
+    }
+
+    void emit(const Node& n) {
+        const std::size_t start = filter.code.size();
+        filter.code.push_back({ n.op, n.typeMask, n.key, n.operand, 1 });
+        for (const auto& child : n.children) {
+            emit(child);
+        }
+        filter.code[start].size = uint32_t(filter.code.size() - start);
+    }
+
+    CompiledFilter& filter;
+    Node node;
+};
+
+CompiledFilter::CompiledFilter()
+    : CompiledFilter(NullExpression()) {
+}
+
+CompiledFilter::CompiledFilter(const FilterExpression& expression) {
+    FilterCompiler(*this).compile(expression);
+}
+
+bool CompiledFilter::ValueSet::contains(const Value& value) const {
+    if (value.is<std::string>()) {
+        return std::binary_search(strings.begin(), strings.end(), value.get<std::string>());
+    }
+
+    for (const auto& other : others) {
+        if (util::relaxed_equal(value, other)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}
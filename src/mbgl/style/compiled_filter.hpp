@@ -0,0 +1,98 @@
+#ifndef MBGL_STYLE_COMPILED_FILTER
+#define MBGL_STYLE_COMPILED_FILTER
+
+#include <mbgl/style/filter_expression.hpp>
+#include <mbgl/style/value.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+enum class FeatureType : uint8_t;
+
+// A filter expression compiled into a flat program. Compilation happens once when the style is
+// parsed and does the following:
+//
+// - Comparisons against $type are folded into a mask of accepted feature types, and adjacent
+//   masks within all/any/none are merged, so that these tests never look up a property.
+// - Keys are replaced by indices into a table of distinct keys, which callers can resolve once
+//   per source layer (e.g. to the key IDs of a vector tile layer).
+// - String values of in/!in sets are sorted for binary search.
+// - Nested all/any expressions are flattened, constant subexpressions are folded, and the
+//   operands of all/any/none are ordered so that cheap tests run first.
+//
+// Evaluating the program only executes the instructions needed to decide the result.
+class CompiledFilter {
+public:
+    // Compiles a filter that matches all features.
+    CompiledFilter();
+    explicit CompiledFilter(const FilterExpression&);
+
+    // The distinct keys the filter reads, indexed by the key IDs passed to the accessor.
+    const std::vector<std::string>& getKeys() const { return keys; }
+
+    // Number of instructions in the compiled program.
+    std::size_t size() const { return code.size(); }
+
+    // Evaluates the filter for a feature of the given type. The accessor is called with a key
+    // index and must return a pointer-like object (e.g. `const Value*` or `optional<Value>`)
+    // that is empty if the feature has no value for that key. The definition is in
+    // compiled_filter_private.hpp.
+    template <class Accessor>
+    bool evaluate(FeatureType, const Accessor&) const;
+
+private:
+    enum class Op : uint8_t {
+        Type,
+        Equals,
+        NotEquals,
+        LessThan,
+        LessThanEquals,
+        GreaterThan,
+        GreaterThanEquals,
+        In,
+        NotIn,
+        Any,
+        All,
+        None
+    };
+
+    struct Instruction {
+        Op op;
+
+        // Op::Type: bit n is set if features of FeatureType n match.
+        uint8_t typeMask;
+
+        // Index into the key table.
+        uint32_t key;
+
+        // Comparisons: index into the value table. In/NotIn: index into the set table.
+        uint32_t operand;
+
+        // Number of instructions in the subtree starting with this one.
+        uint32_t size;
+    };
+
+    struct ValueSet {
+        std::vector<std::string> strings; // sorted
+        std::vector<Value> others;
+
+        bool contains(const Value&) const;
+    };
+
+    template <class Accessor>
+    bool run(std::size_t pc, FeatureType, const Accessor&) const;
+
+    std::vector<Instruction> code;
+    std::vector<std::string> keys;
+    std::vector<Value> values;
+    std::vector<ValueSet> sets;
+
+    friend class FilterCompiler;
+};
+
+}
+
+#endif
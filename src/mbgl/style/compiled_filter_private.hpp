@@ -0,0 +1,88 @@
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/value_comparison.hpp>
+
+namespace mbgl {
+
+template <class Accessor>
+bool CompiledFilter::evaluate(FeatureType type, const Accessor& accessor) const {
+    return run(0, type, accessor);
+}
+
+template <class Accessor>
+bool CompiledFilter::run(std::size_t pc, FeatureType type, const Accessor& accessor) const {
+    const Instruction& instruction = code[pc];
+    const std::size_t end = pc + instruction.size;
+
+    switch (instruction.op) {
+    case Op::Type:
+        return instruction.typeMask & (1u << uint8_t(type));
+
+    case Op::Equals: {
+        auto actual = accessor(instruction.key);
+        return actual && util::relaxed_equal(*actual, values[instruction.operand]);
+    }
+
+    case Op::NotEquals: {
+        auto actual = accessor(instruction.key);
+        return !actual || util::relaxed_not_equal(*actual, values[instruction.operand]);
+    }
+
+    case Op::LessThan: {
+        auto actual = accessor(instruction.key);
+        return actual && util::relaxed_less(*actual, values[instruction.operand]);
+    }
+
+    case Op::LessThanEquals: {
+        auto actual = accessor(instruction.key);
+        return actual && util::relaxed_less_equal(*actual, values[instruction.operand]);
+    }
+
+    case Op::GreaterThan: {
+        auto actual = accessor(instruction.key);
+        return actual && util::relaxed_greater(*actual, values[instruction.operand]);
+    }
+
+    case Op::GreaterThanEquals: {
+        auto actual = accessor(instruction.key);
+        return actual && util::relaxed_greater_equal(*actual, values[instruction.operand]);
+    }
+
+    case Op::In: {
+        auto actual = accessor(instruction.key);
+        return actual && sets[instruction.operand].contains(*actual);
+    }
+
+    case Op::NotIn: {
+        auto actual = accessor(instruction.key);
+        return !actual || !sets[instruction.operand].contains(*actual);
+    }
+
+    case Op::Any:
+        for (std::size_t child = pc + 1; child < end; child += code[child].size) {
+            if (run(child, type, accessor)) {
+                return true;
+            }
+        }
+        return false;
+
+    case Op::All:
+        for (std::size_t child = pc + 1; child < end; child += code[child].size) {
+            if (!run(child, type, accessor)) {
+                return false;
+            }
+        }
+        return true;
+
+    case Op::None:
+        for (std::size_t child = pc + 1; child < end; child += code[child].size) {
+            if (run(child, type, accessor)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    return false;
+}
+
+}
@@ -12,6 +12,7 @@
 #include <mbgl/style/style_calculation_parameters.hpp>
 #include <mbgl/geometry/glyph_atlas.hpp>
 #include <mbgl/geometry/line_atlas.hpp>
+#include <mbgl/text/edge_collision_index.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/platform/log.hpp>
 #include <csscolorparser/csscolorparser.hpp>
@@ -30,6 +31,7 @@ Style::Style(MapData& data_)
       spriteStore(std::make_unique<SpriteStore>(data.pixelRatio)),
       spriteAtlas(std::make_unique<SpriteAtlas>(512, 512, data.pixelRatio, *spriteStore)),
       lineAtlas(std::make_unique<LineAtlas>(512, 512)),
+      edgeCollisionIndex(std::make_unique<EdgeCollisionIndex>()),
       mtx(std::make_unique<uv::rwlock>()),
       workers(4) {
     glyphStore->setObserver(this);
@@ -105,6 +107,7 @@ void Style::removeLayer(const std::string& id) {
 void Style::update(const TransformState& transform,
                    TexturePool& texturePool) {
     bool allTilesUpdated = true;
+    tileCache.setZoom(transform.getZoom());
     for (const auto& source : sources) {
         if (!source->update(data, transform, *this, texturePool, shouldReparsePartialTiles)) {
             allTilesUpdated = false;
@@ -118,6 +121,12 @@ void Style::update(const TransformState& transform,
     }
 }
 
+void Style::prefetch(const std::vector<TransformState>& path, TexturePool& texturePool) {
+    for (const auto& source : sources) {
+        source->prefetch(data, path, *this, texturePool);
+    }
+}
+
 void Style::cascade() {
     std::vector<ClassID> classes;
 
@@ -271,6 +280,11 @@ void Style::dumpDebugLogs() const {
     }
 
     spriteStore->dumpDebugLogs();
+    spriteAtlas->dumpDebugLogs();
+    glyphAtlas->dumpDebugLogs();
+    glyphStore->dumpDebugLogs();
+    tileCache.dumpDebugLogs();
+    workers.dumpDebugLogs();
 }
 
 }
@@ -5,6 +5,7 @@
 #include <mbgl/style/zoom_history.hpp>
 
 #include <mbgl/map/source.hpp>
+#include <mbgl/map/tile_cache.hpp>
 #include <mbgl/text/glyph_store.hpp>
 #include <mbgl/sprite/sprite_store.hpp>
 
@@ -23,6 +24,7 @@ class GlyphStore;
 class SpriteStore;
 class SpriteAtlas;
 class LineAtlas;
+class EdgeCollisionIndex;
 class StyleLayer;
 
 class Style : public GlyphStore::Observer,
@@ -51,6 +53,10 @@ public:
     // a tile is ready so observers can render the tile.
     void update(const TransformState&, TexturePool&);
 
+    // Load the tiles needed along the given camera path ahead of time, and cancel prefetched
+    // tiles that are no longer on it. An empty path cancels all prefetching.
+    void prefetch(const std::vector<TransformState>& path, TexturePool&);
+
     void cascade();
     void recalculate(float z);
 
@@ -76,10 +82,15 @@ public:
     std::unique_ptr<SpriteStore> spriteStore;
     std::unique_ptr<SpriteAtlas> spriteAtlas;
     std::unique_ptr<LineAtlas> lineAtlas;
+    std::unique_ptr<EdgeCollisionIndex> edgeCollisionIndex;
 
     std::vector<std::unique_ptr<Source>> sources;
     std::vector<util::ptr<StyleLayer>> layers;
 
+    // Shared by all sources, so that they are subject to a single memory budget. Destroyed before
+    // the sources, since cached tiles may refer to them.
+    TileCache tileCache;
+
 private:
     std::vector<util::ptr<StyleLayer>>::const_iterator findLayer(const std::string& layerID) const;
 
@@ -3,17 +3,19 @@
 
 namespace mbgl {
 
-void StyleBucketParameters::eachFilteredFeature(const FilterExpression& filter,
-                                                std::function<void (const GeometryTileFeature&)> function) {
-    for (std::size_t i = 0; !cancelled() && i < layer.featureCount(); i++) {
-        auto feature = layer.getFeature(i);
+void StyleBucketParameters::eachFilteredFeature(const CompiledFilter& filter,
+                                                std::function<void (const GeometryTileFeature&, const GeometryCollection&)> function) {
+    GeometryTileLayerFilter layerFilter(layer, filter);
 
-        GeometryTileFeatureExtractor extractor(*feature);
-        if (!evaluate(filter, extractor))
-            continue;
+    layer.everyFeature([&] (const GeometryTileFeature& feature) {
+        if (checkpoint.poll())
+            return false;
 
-        function(*feature);
-    }
+        if (layerFilter(feature))
+            function(feature, feature.readGeometries(geometryBuffer));
+
+        return true;
+    });
 }
 
 }
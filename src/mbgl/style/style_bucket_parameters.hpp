@@ -1,16 +1,15 @@
 #ifndef STYLE_BUCKET_PARAMETERS
 #define STYLE_BUCKET_PARAMETERS
 
-#include <mbgl/style/filter_expression.hpp>
-#include <mbgl/map/tile_data.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/map/geometry_tile.hpp>
+#include <mbgl/util/cancellation_checkpoint.hpp>
 
 #include <functional>
 
 namespace mbgl {
 
 class TileID;
-class GeometryTileLayer;
-class GeometryTileFeature;
 class SpriteAtlas;
 class SpriteStore;
 class GlyphAtlas;
@@ -21,7 +20,7 @@ class StyleBucketParameters {
 public:
     StyleBucketParameters(const TileID& tileID_,
                           const GeometryTileLayer& layer_,
-                          const std::atomic<TileData::State>& state_,
+                          util::CancellationCheckpoint& checkpoint_,
                           uintptr_t tileUID_,
                           bool& partialParse_,
                           SpriteAtlas& spriteAtlas_,
@@ -31,7 +30,7 @@ public:
                           CollisionTile& collisionTile_)
         : tileID(tileID_),
           layer(layer_),
-          state(state_),
+          checkpoint(checkpoint_),
           tileUID(tileUID_),
           partialParse(partialParse_),
           spriteAtlas(spriteAtlas_),
@@ -40,15 +39,15 @@ public:
           glyphStore(glyphStore_),
           collisionTile(collisionTile_) {}
 
-    bool cancelled() const {
-        return state == TileData::State::obsolete;
-    }
-
-    void eachFilteredFeature(const FilterExpression&, std::function<void (const GeometryTileFeature&)>);
+    // Calls the function with every feature that passes the filter, along with its geometries.
+    // Both references are only valid for the duration of the call. Stops calling the function
+    // once the checkpoint reports that the tile is obsolete.
+    void eachFilteredFeature(const CompiledFilter&,
+                             std::function<void (const GeometryTileFeature&, const GeometryCollection&)>);
 
     const TileID& tileID;
     const GeometryTileLayer& layer;
-    const std::atomic<TileData::State>& state;
+    util::CancellationCheckpoint& checkpoint;
     uintptr_t tileUID;
     bool& partialParse;
     SpriteAtlas& spriteAtlas;
@@ -56,6 +55,10 @@ public:
     GlyphAtlas& glyphAtlas;
     GlyphStore& glyphStore;
     CollisionTile& collisionTile;
+
+private:
+    // Scratch buffer that is reused for decoding the geometries of all features.
+    GeometryCollection geometryBuffer;
 };
 
 }
@@ -242,7 +242,7 @@ void StyleParser::parseLayer(const std::string& id, const JSVal& value, util::pt
         }
 
         if (value.HasMember("filter")) {
-            layer->filter = parseFilterExpression(value["filter"]);
+            layer->filter = CompiledFilter(parseFilterExpression(value["filter"]));
         }
 
         if (value.HasMember("minzoom")) {
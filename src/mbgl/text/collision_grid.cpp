@@ -0,0 +1,29 @@
+#include <mbgl/text/collision_grid.hpp>
+
+namespace mbgl {
+
+constexpr float CollisionGrid::origin;
+constexpr float CollisionGrid::cellSize;
+constexpr uint32_t CollisionGrid::cellCount;
+
+CollisionGrid::CollisionGrid() : cells(cellCount * cellCount) {
+}
+
+void CollisionGrid::insert(float x1, float y1, float x2, float y2, const CollisionBox& box) {
+    const auto index = uint32_t(boxes.size());
+    minX.push_back(x1);
+    minY.push_back(y1);
+    maxX.push_back(x2);
+    maxY.push_back(y2);
+    boxes.push_back(box);
+    seen.push_back(0);
+
+    const uint32_t cx1 = cell(x1), cy1 = cell(y1), cx2 = cell(x2), cy2 = cell(y2);
+    for (uint32_t cy = cy1; cy <= cy2; cy++) {
+        for (uint32_t cx = cx1; cx <= cx2; cx++) {
+            cells[cy * cellCount + cx].push_back(index);
+        }
+    }
+}
+
+} // namespace mbgl
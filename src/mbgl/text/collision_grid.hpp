@@ -0,0 +1,84 @@
+#ifndef MBGL_TEXT_COLLISION_GRID
+#define MBGL_TEXT_COLLISION_GRID
+
+#include <mbgl/text/collision_feature.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+// A uniform grid over the rotated coordinate space of a collision tile. The bounds of all boxes
+// are stored in flat arrays, and every cell lists the boxes that overlap it. Unlike an R-tree,
+// inserting a box never rebalances anything, and a query only touches the cells it overlaps.
+//
+// Coordinates outside of the grid are clamped to the outermost cells, so every box can be
+// inserted; only lookups of boxes far outside of the tile get slower.
+class CollisionGrid : private util::noncopyable {
+public:
+    CollisionGrid();
+
+    // Bounds are given as x1, y1, x2, y2, with x1 <= x2 and y1 <= y2.
+    void insert(float x1, float y1, float x2, float y2, const CollisionBox&);
+
+    // Calls the function with every box whose bounds intersect the given bounds, including boxes
+    // that only touch them. Every box is reported once.
+    template <typename Fn>
+    void query(float x1, float y1, float x2, float y2, Fn&& fn) {
+        if (boxes.empty()) {
+            return;
+        }
+
+        // Marks the boxes that were already reported by a previous cell.
+        if (++stamp == 0) {
+            std::fill(seen.begin(), seen.end(), 0);
+            stamp = 1;
+        }
+
+        const uint32_t cx1 = cell(x1), cy1 = cell(y1), cx2 = cell(x2), cy2 = cell(y2);
+        for (uint32_t cy = cy1; cy <= cy2; cy++) {
+            for (uint32_t cx = cx1; cx <= cx2; cx++) {
+                for (const uint32_t i : cells[cy * cellCount + cx]) {
+                    if (seen[i] == stamp) {
+                        continue;
+                    }
+                    seen[i] = stamp;
+                    if (minX[i] <= x2 && maxX[i] >= x1 && minY[i] <= y2 && maxY[i] >= y1) {
+                        fn(boxes[i]);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    uint32_t cell(float coordinate) const {
+        const float index = (coordinate - origin) / cellSize;
+        if (!(index > 0)) {
+            return 0;
+        }
+        return index < cellCount ? uint32_t(index) : cellCount - 1;
+    }
+
+    // Covers anchors of a tile and its neighbours, rotated by any angle.
+    static constexpr float origin = -12288;
+    static constexpr float cellSize = 512;
+    static constexpr uint32_t cellCount = 48;
+
+    std::vector<std::vector<uint32_t>> cells;
+
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+    std::vector<CollisionBox> boxes;
+
+    std::vector<uint32_t> seen;
+    uint32_t stamp = 0;
+};
+
+} // namespace mbgl
+
+#endif
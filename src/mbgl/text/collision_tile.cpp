@@ -1,4 +1,6 @@
 #include <mbgl/text/collision_tile.hpp>
+
+#include <algorithm>
 #include <cmath>
 
 namespace mbgl {
@@ -6,6 +8,10 @@ namespace mbgl {
 CollisionTile::CollisionTile(PlacementConfig config_) : config(config_) {
     tree.clear();
 
+    if (config.index == CollisionIndex::Grid) {
+        grid = std::make_unique<CollisionGrid>();
+    }
+
     // Compute the transformation matrix.
     const float angle_sin = std::sin(config.angle);
     const float angle_cos = std::cos(config.angle);
@@ -19,6 +25,20 @@ CollisionTile::CollisionTile(PlacementConfig config_) : config(config_) {
     yStretch = std::pow(_yStretch, 1.3);
 }
 
+template <typename Fn>
+void CollisionTile::queryIntersecting(const Box& box, Fn&& fn) {
+    if (grid) {
+        grid->query(box.min_corner().get<0>(), box.min_corner().get<1>(),
+                    box.max_corner().get<0>(), box.max_corner().get<1>(), fn);
+    } else {
+        std::vector<CollisionTreeBox> blockingBoxes;
+        tree.query(bgi::intersects(box), std::back_inserter(blockingBoxes));
+        for (auto& blockingTreeBox : blockingBoxes) {
+            fn(std::get<1>(blockingTreeBox));
+        }
+    }
+}
+
 float CollisionTile::placeFeature(const CollisionFeature &feature) {
 
     float minPlacementScale = minScale;
@@ -26,11 +46,12 @@ float CollisionTile::placeFeature(const CollisionFeature &feature) {
     for (auto& box : feature.boxes) {
         const auto anchor = box.anchor.matMul(rotationMatrix);
 
-        std::vector<CollisionTreeBox> blockingBoxes;
-        tree.query(bgi::intersects(getTreeBox(anchor, box)), std::back_inserter(blockingBoxes));
+        queryIntersecting(getTreeBox(anchor, box), [&](const CollisionBox& blocking) {
+            if (minPlacementScale >= maxScale) {
+                // The feature can't be placed anyway.
+                return;
+            }
 
-        for (auto& blockingTreeBox : blockingBoxes) {
-            const auto& blocking = std::get<1>(blockingTreeBox);
             auto blockingAnchor = blocking.anchor.matMul(rotationMatrix);
 
             // Find the lowest scale at which the two boxes can fit side by side without overlapping.
@@ -65,9 +86,9 @@ float CollisionTile::placeFeature(const CollisionFeature &feature) {
                 // this this is the lowest scale at which the label won't collide with anything
                 minPlacementScale = collisionFreeScale;
             }
+        });
 
-            if (minPlacementScale >= maxScale) return minPlacementScale;
-        }
+        if (minPlacementScale >= maxScale) return minPlacementScale;
     }
 
     return minPlacementScale;
@@ -82,10 +103,46 @@ void CollisionTile::insertFeature(CollisionFeature &feature, const float minPlac
         std::vector<CollisionTreeBox> treeBoxes;
         for (auto& box : feature.boxes) {
             treeBoxes.emplace_back(getTreeBox(box.anchor.matMul(rotationMatrix), box), box);
+            if (isNearEdge(box)) {
+                edgeBoxes.push_back(box);
+            }
         }
+        insertTreeBoxes(treeBoxes);
+    }
+
+}
+
+void CollisionTile::insertNeighbourBoxes(const std::vector<CollisionBox>& boxes, const vec2<float>& offset) {
+    std::vector<CollisionTreeBox> treeBoxes;
+    treeBoxes.reserve(boxes.size());
+    for (auto box : boxes) {
+        box.anchor = box.anchor + offset;
+        treeBoxes.emplace_back(getTreeBox(box.anchor.matMul(rotationMatrix), box), box);
+    }
+    insertTreeBoxes(treeBoxes);
+}
+
+void CollisionTile::insertTreeBoxes(const std::vector<CollisionTreeBox>& treeBoxes) {
+    if (grid) {
+        for (const auto& treeBox : treeBoxes) {
+            const Box& box = std::get<0>(treeBox);
+            grid->insert(box.min_corner().get<0>(), box.min_corner().get<1>(),
+                         box.max_corner().get<0>(), box.max_corner().get<1>(), std::get<1>(treeBox));
+        }
+    } else {
         tree.insert(treeBoxes.begin(), treeBoxes.end());
     }
+}
 
+bool CollisionTile::isNearEdge(const CollisionBox& box) const {
+    // Only symbols with their anchor within the tile are drawn by this tile. At the minimum scale,
+    // anchors are closer together, so boxes reach further relative to them. Rotation may stretch
+    // the reach by up to √2.
+    const float extent = 4096;
+    const float reach = std::max({ -box.x1, box.x2, -box.y1 * yStretch, box.y2 * yStretch }) * float(M_SQRT2) / minScale;
+    const auto& anchor = box.anchor;
+    return anchor.x >= 0 && anchor.x <= extent && anchor.y >= 0 && anchor.y <= extent &&
+           (anchor.x < reach || anchor.x > extent - reach || anchor.y < reach || anchor.y > extent - reach);
 }
 
 Box CollisionTile::getTreeBox(const vec2<float> &anchor, const CollisionBox &box) {
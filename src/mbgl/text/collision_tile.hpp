@@ -2,6 +2,7 @@
 #define MBGL_TEXT_COLLISION_TILE
 
 #include <mbgl/text/collision_feature.hpp>
+#include <mbgl/text/collision_grid.hpp>
 #include <mbgl/text/placement_config.hpp>
 
 #pragma GCC diagnostic push
@@ -23,6 +24,8 @@
 #include <boost/geometry/index/rtree.hpp>
 #pragma GCC diagnostic pop
 
+#include <memory>
+
 namespace mbgl {
 
 namespace bg = boost::geometry;
@@ -40,6 +43,14 @@ public:
     float placeFeature(const CollisionFeature& feature);
     void insertFeature(CollisionFeature& feature, const float minPlacementScale);
 
+    // Inserts boxes that a neighbouring tile placed, so that symbols of this tile avoid them.
+    // The offset moves their anchors into the coordinate space of this tile.
+    void insertNeighbourBoxes(const std::vector<CollisionBox>& boxes, const vec2<float>& offset);
+
+    // Boxes of placed features that are close enough to the tile edge to collide with symbols
+    // of neighbouring tiles.
+    const std::vector<CollisionBox>& getEdgeBoxes() const { return edgeBoxes; }
+
     const PlacementConfig config;
 
     const float minScale = 0.5f;
@@ -48,6 +59,19 @@ public:
 
 private:
     Box getTreeBox(const vec2<float>& anchor, const CollisionBox& box);
+    bool isNearEdge(const CollisionBox& box) const;
+
+    // Inserts the boxes into the index selected by the placement configuration.
+    void insertTreeBoxes(const std::vector<CollisionTreeBox>& treeBoxes);
+
+    // Calls the function with every box in the index that intersects the given box.
+    template <typename Fn>
+    void queryIntersecting(const Box& box, Fn&& fn);
+
+    std::vector<CollisionBox> edgeBoxes;
+
+    // Only one of them is used, depending on the placement configuration.
+    std::unique_ptr<CollisionGrid> grid;
 
     Tree tree;
     std::array<float, 4> rotationMatrix;
@@ -0,0 +1,111 @@
+#include <mbgl/text/edge_collision_index.hpp>
+#include <mbgl/text/collision_tile.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+namespace {
+
+const float extent = 4096;
+
+// Of two labels that overlap across the edge between two tiles, the one of the tile that comes
+// first in row-major order is kept. The other tile avoids it, regardless of which of the tiles is
+// placed first, so that the tiles don't alternately show and hide the labels whenever they
+// are placed again.
+bool outranks(int32_t x, int32_t y, int32_t otherX, int32_t otherY) {
+    return y < otherY || (y == otherY && x < otherX);
+}
+
+} // namespace
+
+template <typename Fn>
+void EdgeCollisionIndex::forEachPrecedingNeighbour(const TileID& id, Fn&& fn) {
+    const int32_t tiles = 1 << id.z;
+    for (int32_t dy = -1; dy <= 1; dy++) {
+        const int32_t y = id.y + dy;
+        if (y < 0 || y >= tiles) {
+            continue;
+        }
+        for (int32_t dx = -1; dx <= 1; dx++) {
+            // Tiles on the other side of the antimeridian are neighbours, too.
+            const int32_t x = (id.x + dx + tiles) % tiles;
+            if (outranks(x, y, id.x, id.y)) {
+                fn(x, y, dx, dy);
+            }
+        }
+    }
+}
+
+uint64_t EdgeCollisionIndex::seed(const std::string& sourceID, const TileID& id, CollisionTile& collisionTile) const {
+    std::vector<std::pair<vec2<float>, std::shared_ptr<const std::vector<CollisionBox>>>> neighbours;
+    uint64_t seeded;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        forEachPrecedingNeighbour(id, [&](int32_t x, int32_t y, int32_t dx, int32_t dy) {
+            auto it = entries.find(Key { sourceID, id.z, x, y });
+            if (it != entries.end()) {
+                neighbours.emplace_back(vec2<float>(dx * extent, dy * extent), it->second.boxes);
+            }
+        });
+        seeded = version;
+    }
+
+    // Insert outside of the lock; the boxes are immutable once published.
+    for (const auto& neighbour : neighbours) {
+        collisionTile.insertNeighbourBoxes(*neighbour.second, neighbour.first);
+    }
+
+    return seeded;
+}
+
+void EdgeCollisionIndex::publish(const std::string& sourceID, const TileID& id, uintptr_t tileUID,
+                                 const CollisionTile& collisionTile) {
+    auto boxes = std::make_shared<const std::vector<CollisionBox>>(collisionTile.getEdgeBoxes());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[Key { sourceID, id.z, id.x, id.y }] = Entry { tileUID, ++version, std::move(boxes) };
+}
+
+bool EdgeCollisionIndex::isStale(const std::string& sourceID, const TileID& id, uint64_t seeded) const {
+    bool stale = false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    forEachPrecedingNeighbour(id, [&](int32_t x, int32_t y, int32_t, int32_t) {
+        auto it = entries.find(Key { sourceID, id.z, x, y });
+        if (it != entries.end() && it->second.version > seeded) {
+            stale = true;
+        }
+    });
+    return stale;
+}
+
+std::vector<TileID> EdgeCollisionIndex::dependents(const TileID& id) {
+    std::vector<TileID> result;
+    const int32_t tiles = 1 << id.z;
+    for (int32_t dy = 0; dy <= 1; dy++) {
+        const int32_t y = id.y + dy;
+        if (y >= tiles) {
+            continue;
+        }
+        for (int32_t dx = -1; dx <= 1; dx++) {
+            const TileID neighbour(id.z, (id.x + dx + tiles) % tiles, y, id.sourceZ);
+            if (outranks(id.x, id.y, neighbour.x, neighbour.y) &&
+                std::find(result.begin(), result.end(), neighbour) == result.end()) {
+                result.push_back(neighbour);
+            }
+        }
+    }
+    return result;
+}
+
+void EdgeCollisionIndex::remove(const std::string& sourceID, const TileID& id, uintptr_t tileUID) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(Key { sourceID, id.z, id.x, id.y });
+    if (it != entries.end() && it->second.tileUID == tileUID) {
+        entries.erase(it);
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,69 @@
+#ifndef MBGL_TEXT_EDGE_COLLISION_INDEX
+#define MBGL_TEXT_EDGE_COLLISION_INDEX
+
+#include <mbgl/map/tile_id.hpp>
+#include <mbgl/text/collision_feature.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace mbgl {
+
+class CollisionTile;
+
+// Shares the collision boxes that tiles placed near their edges with the neighbouring tiles of
+// the same source and zoom level. Each tile is placed separately on a worker thread, so without
+// it, labels close to a tile boundary only avoid each other within one tile, and symbols of
+// neighbouring tiles overlap at the edge.
+//
+// Tiles avoid the symbols that the neighbours above them and to their left placed, so that exactly
+// one of two overlapping labels is kept. A tile that was placed before such a neighbour published
+// its boxes has to be placed again; see isStale(). Only rendered tiles publish their boxes. All
+// methods may be called from any thread.
+class EdgeCollisionIndex : private util::noncopyable {
+public:
+    // Inserts the edge boxes that the neighbours of the tile published, and that take precedence
+    // over its own symbols, into the collision tile. Tile IDs must be normalized. Returns the
+    // version of the index that the tile was seeded with.
+    uint64_t seed(const std::string& sourceID, const TileID&, CollisionTile&) const;
+
+    // Replaces the edge boxes of the tile with the ones that were placed in the collision tile.
+    void publish(const std::string& sourceID, const TileID&, uintptr_t tileUID, const CollisionTile&);
+
+    // Whether a neighbour that takes precedence over the tile published new boxes since the tile
+    // was seeded with the given version.
+    bool isStale(const std::string& sourceID, const TileID&, uint64_t version) const;
+
+    // The neighbours that avoid the symbols of the tile: the one to its right and the three below
+    // it, except across the antimeridian.
+    static std::vector<TileID> dependents(const TileID&);
+
+    // Removes the edge boxes of the tile, unless they were published by another tile object since.
+    void remove(const std::string& sourceID, const TileID&, uintptr_t tileUID);
+
+private:
+    using Key = std::tuple<std::string, int8_t, int32_t, int32_t>;
+
+    struct Entry {
+        uintptr_t tileUID;
+        uint64_t version;
+        std::shared_ptr<const std::vector<CollisionBox>> boxes;
+    };
+
+    // Calls fn(x, y, dx, dy) for every neighbour that takes precedence over the tile.
+    template <typename Fn>
+    static void forEachPrecedingNeighbour(const TileID&, Fn&&);
+
+    mutable std::mutex mutex;
+    std::map<Key, Entry> entries;
+    uint64_t version = 0;
+};
+
+} // namespace mbgl
+
+#endif
@@ -18,10 +18,10 @@ const std::map<uint32_t, SDFGlyph> &FontStack::getSDFs() const {
     return sdfs;
 }
 
-const Shaping FontStack::getShaping(const std::u32string &string, const float maxWidth,
-                                    const float lineHeight, const float horizontalAlign,
-                                    const float verticalAlign, const float justify,
-                                    const float spacing, const vec2<float> &translate) const {
+Shaping FontStack::getShaping(const std::u32string &string, const float maxWidth,
+                              const float lineHeight, const float horizontalAlign,
+                              const float verticalAlign, const float justify,
+                              const float spacing, const vec2<float> &translate) const {
     Shaping shaping(translate.x * 24, translate.y * 24, string);
 
     // the y offset *should* be part of the font metadata
@@ -7,6 +7,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <utility>
 
 namespace mbgl {
 
@@ -30,10 +31,11 @@ struct GlyphMetrics {
 };
 
 struct Glyph {
-    inline explicit Glyph() : rect(0, 0, 0, 0), metrics() {}
+    inline explicit Glyph() : rect(0, 0, 0, 0), metrics(), page(0) {}
     inline explicit Glyph(const Rect<uint16_t> &rect_,
-                          const GlyphMetrics &metrics_)
-        : rect(rect_), metrics(metrics_) {}
+                          const GlyphMetrics &metrics_,
+                          uint8_t page_ = 0)
+        : rect(rect_), metrics(metrics_), page(page_) {}
 
     operator bool() const {
         return metrics || rect.hasArea();
@@ -41,6 +43,9 @@ struct Glyph {
 
     const Rect<uint16_t> rect;
     const GlyphMetrics metrics;
+
+    // The glyph atlas page that holds the bitmap.
+    const uint8_t page;
 };
 
 typedef std::map<uint32_t, Glyph> GlyphPositions;
@@ -59,7 +64,7 @@ class Shaping {
     public:
     inline explicit Shaping() : top(0), bottom(0), left(0), right(0) {}
     inline explicit Shaping(float x, float y, std::u32string text_)
-        : text(text_), top(y), bottom(y), left(x), right(x) {}
+        : text(std::move(text_)), top(y), bottom(y), left(x), right(x) {}
     std::vector<PositionedGlyph> positionedGlyphs;
     std::u32string text;
     int32_t top;
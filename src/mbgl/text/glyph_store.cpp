@@ -65,12 +65,17 @@ util::exclusive<FontStack> GlyphStore::getFontStack(const std::string& fontStack
 }
 
 void GlyphStore::onGlyphPBFLoaded() {
+    shapingCache.clear();
+
     if (observer) {
         observer->onGlyphRangeLoaded();
     }
 }
 
 void GlyphStore::onGlyphPBFLoadingFailed(std::exception_ptr error) {
+    // Parsing may have failed after adding some of the glyphs.
+    shapingCache.clear();
+
     if (observer) {
         observer->onGlyphRangeLoadingFailed(error);
     }
@@ -80,4 +85,8 @@ void GlyphStore::setObserver(Observer* observer_) {
     observer = observer_;
 }
 
+void GlyphStore::dumpDebugLogs() const {
+    shapingCache.dumpDebugLogs();
+}
+
 }
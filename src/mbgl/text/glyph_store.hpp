@@ -4,6 +4,7 @@
 #include <mbgl/text/font_stack.hpp>
 #include <mbgl/text/glyph.hpp>
 #include <mbgl/text/glyph_pbf.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/util/exclusive.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/work_queue.hpp>
@@ -33,6 +34,11 @@ public:
 
     util::exclusive<FontStack> getFontStack(const std::string& fontStack);
 
+    // Shapings of labels of all font stacks. It is cleared whenever glyphs are added.
+    ShapingCache& getShapingCache() {
+        return shapingCache;
+    }
+
     // Returns true if the set of GlyphRanges are available and parsed or false
     // if they are not. For the missing ranges, a request on the FileSource is
     // made and when the glyph if finally parsed, it gets added to the respective
@@ -54,6 +60,8 @@ public:
 
     void setObserver(Observer* observer);
 
+    void dumpDebugLogs() const;
+
 private:
     void requestGlyphRange(const std::string& fontStackName, const GlyphRange& range);
 
@@ -65,6 +73,8 @@ private:
     std::unordered_map<std::string, std::unique_ptr<FontStack>> stacks;
     std::mutex stacksMutex;
 
+    ShapingCache shapingCache;
+
     util::WorkQueue workQueue;
 
     Observer* observer = nullptr;
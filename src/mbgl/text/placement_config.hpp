@@ -1,26 +1,45 @@
 #ifndef MBGL_TEXT_PLACEMENT_CONFIG
 #define MBGL_TEXT_PLACEMENT_CONFIG
 
+#include <mbgl/map/mode.hpp>
+
+#include <cmath>
+
 namespace mbgl {
 
 class PlacementConfig {
 public:
-    inline PlacementConfig(float angle_ = 0, float pitch_ = 0, bool debug_ = false)
-        : angle(angle_), pitch(pitch_), debug(debug_) {
+    inline PlacementConfig(float angle_ = 0, float pitch_ = 0, bool debug_ = false,
+                           CollisionIndex index_ = CollisionIndex::RTree)
+        : angle(angle_), pitch(pitch_), debug(debug_), index(index_) {
     }
 
     inline bool operator==(const PlacementConfig& rhs) const {
-        return angle == rhs.angle && pitch == rhs.pitch && debug == rhs.debug;
+        return angle == rhs.angle && pitch == rhs.pitch && debug == rhs.debug && index == rhs.index;
     }
 
     inline bool operator!=(const PlacementConfig& rhs) const {
         return !operator==(rhs);
     }
 
+    // Collision boxes only drift slightly when the angle or pitch change a little. While the camera
+    // is moving, symbols placed for this configuration can be shown for the other one as well.
+    inline bool isCloseTo(const PlacementConfig& rhs) const {
+        const float angleDelta = std::remainder(angle - rhs.angle, float(2 * M_PI));
+        return debug == rhs.debug && index == rhs.index &&
+               std::fabs(angleDelta) < maxAngleDelta &&
+               std::fabs(pitch - rhs.pitch) < maxPitchDelta;
+    }
+
 public:
     float angle;
     float pitch;
     bool debug;
+    CollisionIndex index;
+
+    // About two degrees, in radians.
+    static constexpr float maxAngleDelta = 0.035f;
+    static constexpr float maxPitchDelta = 0.035f;
 };
 
 } // namespace mbgl
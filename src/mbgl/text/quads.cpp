@@ -200,7 +200,7 @@ SymbolQuads getGlyphQuads(Anchor& anchor, const Shaping& shapedText,
             const float glyphMinScale = std::max(instance.minScale, anchor.scale);
 
             const float glyphAngle = std::fmod((anchor.angle + textRotate + instance.offset + 2 * M_PI), (2 * M_PI));
-            quads.emplace_back(tl, tr, bl, br, rect, glyphAngle, instance.anchorPoint, glyphMinScale, instance.maxScale);
+            quads.emplace_back(tl, tr, bl, br, rect, glyphAngle, instance.anchorPoint, glyphMinScale, instance.maxScale, glyph.page);
 
         }
 
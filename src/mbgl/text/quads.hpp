@@ -12,7 +12,7 @@ namespace mbgl {
         explicit SymbolQuad(const vec2<float> &tl_, const vec2<float> &tr_,
                 const vec2<float> &bl_, const vec2<float> &br_,
                 const Rect<uint16_t> &tex_, float angle_, const vec2<float> &anchorPoint_,
-                float minScale_, float maxScale_)
+                float minScale_, float maxScale_, uint8_t page_ = 0)
             : tl(tl_),
             tr(tr_),
             bl(bl_),
@@ -21,13 +21,16 @@ namespace mbgl {
             angle(angle_),
             anchorPoint(anchorPoint_),
             minScale(minScale_),
-            maxScale(maxScale_) {}
+            maxScale(maxScale_),
+            page(page_) {}
 
         vec2<float> tl, tr, bl, br;
         Rect<uint16_t> tex;
         float angle;
         vec2<float> anchorPoint;
         float minScale, maxScale;
+        // The glyph atlas page of glyph quads.
+        uint8_t page;
     };
 
     typedef std::vector<SymbolQuad> SymbolQuads;
@@ -0,0 +1,128 @@
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/text/font_stack.hpp>
+#include <mbgl/platform/log.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+bool ShapingCache::equalLayout(const Key& a, const Key& b) {
+    return a.maxWidth == b.maxWidth &&
+           a.lineHeight == b.lineHeight &&
+           a.horizontalAlign == b.horizontalAlign &&
+           a.verticalAlign == b.verticalAlign &&
+           a.justify == b.justify &&
+           a.spacing == b.spacing &&
+           a.translate.x == b.translate.x &&
+           a.translate.y == b.translate.y;
+}
+
+std::size_t ShapingCache::hash(const Key& key) {
+    // The standard string hashes are much faster than combining the hashes of all characters.
+    std::size_t seed = std::hash<std::u32string>()(key.text);
+    boost::hash_combine(seed, std::hash<std::string>()(key.fontStack));
+    boost::hash_combine(seed, key.maxWidth);
+    boost::hash_combine(seed, key.lineHeight);
+    boost::hash_combine(seed, key.horizontalAlign);
+    boost::hash_combine(seed, key.verticalAlign);
+    boost::hash_combine(seed, key.justify);
+    boost::hash_combine(seed, key.spacing);
+    boost::hash_combine(seed, key.translate.x);
+    boost::hash_combine(seed, key.translate.y);
+    return seed;
+}
+
+ShapingCache::ShapingCache(std::size_t maxEntries_)
+    : maxEntries(std::max<std::size_t>(maxEntries_, 1)) {
+    index.reserve(maxEntries + 1);
+}
+
+std::shared_ptr<const Shaping> ShapingCache::get(const Key& key, const FontStack& fontStack) {
+    const std::size_t keyHash = hash(key);
+
+    uint64_t shapedGeneration;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find({ &key.fontStack, &key.text, &key, keyHash });
+        if (it != index.end()) {
+            statistics.hits++;
+            Entry& entry = *it->second;
+            unlink(entry);
+            link(entry);
+            return { it->second, &entry.shaping };
+        }
+        statistics.misses++;
+        shapedGeneration = generation;
+    }
+
+    // Shaping and creating the entry don't need the cache, so other workers may use it in the
+    // meantime.
+    auto entry = std::make_shared<Entry>(key, keyHash, fontStack.getShaping(
+        key.text, key.maxWidth, key.lineHeight, key.horizontalAlign, key.verticalAlign,
+        key.justify, key.spacing, key.translate));
+    std::shared_ptr<const Shaping> shaping(entry, &entry->shaping);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (generation != shapedGeneration) {
+        // The cache was cleared while shaping.
+        return shaping;
+    }
+
+    entry->fontStack = &*fontStacks.insert(key.fontStack).first;
+    auto inserted = index.emplace(entry->indexKey(), entry);
+    if (!inserted.second) {
+        // Another worker shaped the same text in the meantime.
+        return shaping;
+    }
+    link(*entry);
+
+    if (index.size() > maxEntries) {
+        // Erasing the index entry destroys the evicted entry, which its key refers to.
+        auto it = index.find(oldest->indexKey());
+        unlink(*it->second);
+        index.erase(it);
+        statistics.evictions++;
+    }
+    statistics.entries = index.size();
+
+    return shaping;
+}
+
+void ShapingCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    index.clear();
+    oldest = nullptr;
+    newest = nullptr;
+    fontStacks.clear();
+    generation++;
+    statistics.entries = 0;
+}
+
+void ShapingCache::link(Entry& entry) {
+    entry.older = newest;
+    entry.newer = nullptr;
+    (newest ? newest->newer : oldest) = &entry;
+    newest = &entry;
+}
+
+void ShapingCache::unlink(Entry& entry) {
+    (entry.older ? entry.older->newer : oldest) = entry.newer;
+    (entry.newer ? entry.newer->older : newest) = entry.older;
+}
+
+ShapingCache::Statistics ShapingCache::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return statistics;
+}
+
+void ShapingCache::dumpDebugLogs() const {
+    const auto stats = getStatistics();
+    Log::Info(Event::General, "ShapingCache::entries: %zu/%zu", stats.entries, maxEntries);
+    Log::Info(Event::General, "ShapingCache::hits: %zu", stats.hits);
+    Log::Info(Event::General, "ShapingCache::misses: %zu", stats.misses);
+    Log::Info(Event::General, "ShapingCache::evictions: %zu", stats.evictions);
+}
+
+} // namespace mbgl
@@ -0,0 +1,127 @@
+#ifndef MBGL_TEXT_SHAPING_CACHE
+#define MBGL_TEXT_SHAPING_CACHE
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/vec.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mbgl {
+
+class FontStack;
+
+// Remembers the shaping of labels, so that labels that repeat within a tile or across tiles, like
+// road names and house numbers, are only shaped once. The cache is shared by all workers and holds
+// the most recently used shapings of all font stacks. Shapings are immutable once cached.
+class ShapingCache : private util::noncopyable {
+public:
+    struct Key {
+        std::string fontStack;
+        std::u32string text;
+        float maxWidth;
+        float lineHeight;
+        float horizontalAlign;
+        float verticalAlign;
+        float justify;
+        float spacing;
+        vec2<float> translate;
+    };
+
+    struct Statistics {
+        std::size_t entries = 0;
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t evictions = 0;
+    };
+
+    explicit ShapingCache(std::size_t maxEntries = 4096);
+
+    // Returns the cached shaping for the key, or shapes the text with the given font stack, which
+    // must be the one named by the key and must be locked by the caller.
+    std::shared_ptr<const Shaping> get(const Key&, const FontStack&);
+
+    // Drops all shapings, e.g. because glyphs were added to a font stack, which changes how text
+    // that uses them is shaped.
+    void clear();
+
+    Statistics getStatistics() const;
+    void dumpDebugLogs() const;
+
+private:
+    static std::size_t hash(const Key&);
+
+    // Whether the keys are equal, except for their font stacks and texts.
+    static bool equalLayout(const Key&, const Key&);
+
+    // The index refers to the font stacks, texts and layout properties of the entries, so that
+    // they aren't stored twice. Hashes are computed once per lookup, outside of the lock.
+    struct IndexKey {
+        const std::string* fontStack;
+        const std::u32string* text;
+        const Key* layout;
+        std::size_t hash;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const IndexKey& key) const { return key.hash; }
+    };
+
+    struct KeyEqual {
+        bool operator()(const IndexKey& a, const IndexKey& b) const {
+            return a.hash == b.hash && *a.text == *b.text && *a.fontStack == *b.fontStack &&
+                   equalLayout(*a.layout, *b.layout);
+        }
+    };
+
+    // Entries only store the layout properties of their key. The font stack is shared by all
+    // entries that use it, and the text is stored in the shaping. Every entry is a single
+    // allocation that is shared with the users of its shaping.
+    struct Entry {
+        Entry(const Key& key, std::size_t hash_, Shaping&& shaping_)
+            : layout({ {}, {}, key.maxWidth, key.lineHeight, key.horizontalAlign, key.verticalAlign,
+                       key.justify, key.spacing, key.translate }),
+              hash(hash_),
+              shaping(std::move(shaping_)) {}
+
+        IndexKey indexKey() const { return { fontStack, &shaping.text, &layout, hash }; }
+
+        const Key layout;
+        const std::string* fontStack = nullptr;
+        const std::size_t hash;
+        const Shaping shaping;
+
+        // Neighbours in the order of use.
+        Entry* older = nullptr;
+        Entry* newer = nullptr;
+    };
+
+    // Adds the entry as the most recently used one, or removes it from the order of use.
+    void link(Entry&);
+    void unlink(Entry&);
+
+    const std::size_t maxEntries;
+
+    mutable std::mutex mutex;
+    std::unordered_map<IndexKey, std::shared_ptr<Entry>, KeyHash, KeyEqual> index;
+    Entry* oldest = nullptr;
+    Entry* newest = nullptr;
+
+    // The font stacks of all entries.
+    std::unordered_set<std::string> fontStacks;
+
+    // Incremented on every clear(), so that shapings that were computed before can be dropped
+    // instead of being cached.
+    uint64_t generation = 0;
+
+    Statistics statistics;
+};
+
+} // namespace mbgl
+
+#endif
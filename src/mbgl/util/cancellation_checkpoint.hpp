@@ -0,0 +1,53 @@
+#ifndef MBGL_UTIL_CANCELLATION_CHECKPOINT
+#define MBGL_UTIL_CANCELLATION_CHECKPOINT
+
+#include <cstdint>
+#include <functional>
+
+namespace mbgl {
+namespace util {
+
+// Lets long-running loops on worker threads find out whether their result is still needed, so
+// that they can abandon obsolete work early. Once the condition reported cancellation, the
+// checkpoint stays cancelled.
+class CancellationCheckpoint {
+public:
+    // The default checkpoint never cancels.
+    CancellationCheckpoint() = default;
+
+    CancellationCheckpoint(std::function<bool ()> condition_, uint32_t interval_ = 64)
+        : condition(std::move(condition_)), interval(interval_) {}
+
+    // Call once per unit of work, e.g. per feature. Only evaluates the condition every
+    // `interval` calls, which keeps polling cheap in tight loops.
+    bool poll() {
+        if (++count < interval) {
+            return cancelled;
+        }
+        return check();
+    }
+
+    // Evaluates the condition right away. Use between coarse steps like style layers.
+    bool check() {
+        count = 0;
+        if (!cancelled && condition) {
+            cancelled = condition();
+        }
+        return cancelled;
+    }
+
+    bool isCancelled() const {
+        return cancelled;
+    }
+
+private:
+    std::function<bool ()> condition;
+    uint32_t interval = 64;
+    uint32_t count = 0;
+    bool cancelled = false;
+};
+
+} // namespace util
+} // namespace mbgl
+
+#endif
@@ -2,6 +2,7 @@
 
 #include <zlib.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <stdexcept>
@@ -60,29 +61,40 @@ std::string compress(const std::string &raw) {
 }
 
 std::string decompress(const std::string &raw) {
+    return decompress(raw.data(), raw.size());
+}
+
+std::string decompress(const char *data, std::size_t size, std::size_t sizeHint, std::size_t maxSize) {
     z_stream inflate_stream;
     memset(&inflate_stream, 0, sizeof(inflate_stream));
 
     // TODO: reuse z_streams
-    if (inflateInit(&inflate_stream) != Z_OK) {
+    // Accepts both zlib and gzip streams; the latter are common in tile archives.
+    if (inflateInit2(&inflate_stream, MAX_WBITS + 32) != Z_OK) {
         throw std::runtime_error("failed to initialize inflate");
     }
 
-    inflate_stream.next_in = (Bytef *)raw.data();
-    inflate_stream.avail_in = uInt(raw.size());
+    inflate_stream.next_in = (Bytef *)data;
+    inflate_stream.avail_in = uInt(size);
 
-    std::string result;
-    char out[15384];
+    // The buffer may grow one byte beyond the maximum, to tell data that ends at the maximum apart
+    // from data that exceeds it.
+    const std::size_t maxBufferSize = maxSize < std::numeric_limits<std::size_t>::max() ? maxSize + 1 : maxSize;
+    std::string result(std::min(sizeHint, maxSize), '\0');
 
     int code;
     do {
-        inflate_stream.next_out = reinterpret_cast<Bytef *>(out);
-        inflate_stream.avail_out = sizeof(out);
-        code = inflate(&inflate_stream, 0);
-        // result.append(out, sizeof(out) - inflate_stream.avail_out);
-        if (result.size() < inflate_stream.total_out) {
-            result.append(out, inflate_stream.total_out - result.size());
+        if (inflate_stream.total_out == result.size()) {
+            // There was no size hint, or it was too small.
+            if (result.size() >= maxBufferSize) {
+                inflateEnd(&inflate_stream);
+                throw std::runtime_error("decompressed data exceeds the maximum size");
+            }
+            result.resize(std::min(std::max<std::size_t>(result.size() * 2, 16384), maxBufferSize));
         }
+        inflate_stream.next_out = reinterpret_cast<Bytef *>(&result[inflate_stream.total_out]);
+        inflate_stream.avail_out = uInt(result.size() - inflate_stream.total_out);
+        code = inflate(&inflate_stream, Z_NO_FLUSH);
     } while (code == Z_OK);
 
     inflateEnd(&inflate_stream);
@@ -91,6 +103,11 @@ std::string decompress(const std::string &raw) {
         throw std::runtime_error(inflate_stream.msg ? inflate_stream.msg : "decompression error");
     }
 
+    if (inflate_stream.total_out > maxSize) {
+        throw std::runtime_error("decompressed data exceeds the maximum size");
+    }
+
+    result.resize(inflate_stream.total_out);
     return result;
 }
 }
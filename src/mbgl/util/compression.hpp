@@ -1,6 +1,8 @@
 #ifndef MBGL_UTIL_COMPRESSION
 #define MBGL_UTIL_COMPRESSION
 
+#include <cstddef>
+#include <limits>
 #include <string>
 
 namespace mbgl {
@@ -9,6 +11,14 @@ namespace util {
 std::string compress(const std::string &raw);
 std::string decompress(const std::string &raw);
 
+// Decompresses `size` bytes at `data`, e.g. a buffer owned by a database, without copying the
+// input first. When the size of the decompressed data is known, pass it as `sizeHint`: the data is
+// then inflated straight into a buffer of the final size instead of being appended in chunks.
+// Both zlib and gzip streams are accepted. Throws if the data inflates to more than `maxSize`
+// bytes.
+std::string decompress(const char *data, std::size_t size, std::size_t sizeHint = 0,
+                       std::size_t maxSize = std::numeric_limits<std::size_t>::max());
+
 }
 }
 
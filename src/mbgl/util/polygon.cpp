@@ -0,0 +1,252 @@
+#include <mbgl/util/polygon.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+// Checking whether a ring intersects itself takes quadratic time, and so does clipping ears. Most
+// rings that benefit from the fast path, like building footprints, have much fewer vertices.
+const std::size_t maxSimpleRingSize = 128;
+
+// Positive when the path o → a → b turns left, negative when it turns right.
+int64_t cross(const Coordinate& o, const Coordinate& a, const Coordinate& b) {
+    return int64_t(a.x - o.x) * (b.y - o.y) - int64_t(a.y - o.y) * (b.x - o.x);
+}
+
+int64_t dot(const Coordinate& o, const Coordinate& a, const Coordinate& b) {
+    return int64_t(a.x - o.x) * (b.x - o.x) + int64_t(a.y - o.y) * (b.y - o.y);
+}
+
+double segmentDistanceSquared(const Coordinate& p, const Coordinate& a, const Coordinate& b) {
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    const double lengthSquared = dx * dx + dy * dy;
+    double t = lengthSquared == 0 ? 0 : ((p.x - a.x) * dx + (p.y - a.y) * dy) / lengthSquared;
+    t = std::max(0.0, std::min(1.0, t));
+    const double ex = a.x + t * dx - p.x;
+    const double ey = a.y + t * dy - p.y;
+    return ex * ex + ey * ey;
+}
+
+int sign(int64_t value) {
+    return (value > 0) - (value < 0);
+}
+
+// Whether p lies on the segment ab, given that the three points are collinear.
+bool onSegment(const Coordinate& p, const Coordinate& a, const Coordinate& b) {
+    return std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x) &&
+           std::min(a.y, b.y) <= p.y && p.y <= std::max(a.y, b.y);
+}
+
+// Whether the segments ab and cd have any point in common.
+bool segmentsIntersect(const Coordinate& a, const Coordinate& b, const Coordinate& c, const Coordinate& d) {
+    const int d1 = sign(cross(a, b, c));
+    const int d2 = sign(cross(a, b, d));
+    const int d3 = sign(cross(c, d, a));
+    const int d4 = sign(cross(c, d, b));
+
+    if (d1 != d2 && d3 != d4 && d1 != 0 && d2 != 0 && d3 != 0 && d4 != 0) {
+        return true;
+    }
+
+    return (d1 == 0 && onSegment(c, a, b)) || (d2 == 0 && onSegment(d, a, b)) ||
+           (d3 == 0 && onSegment(a, c, d)) || (d4 == 0 && onSegment(b, c, d));
+}
+
+// Counts how often a sequence of signs changes between positive and negative, wrapping around.
+class SignChanges {
+public:
+    void add(int64_t value) {
+        const int s = sign(value);
+        if (s == 0) {
+            return;
+        }
+        if (first == 0) {
+            first = s;
+        } else if (s != last) {
+            changes++;
+        }
+        last = s;
+    }
+
+    int count() const {
+        return changes + (first != 0 && first != last);
+    }
+
+private:
+    int first = 0;
+    int last = 0;
+    int changes = 0;
+};
+
+} // namespace
+
+void simplifyRing(const std::vector<Coordinate>& ring, float tolerance, std::vector<Coordinate>& result) {
+    result.clear();
+
+    std::size_t n = ring.size();
+    while (n > 1 && ring[n - 1] == ring[0]) {
+        n--;
+    }
+
+    if (n < 3) {
+        result.assign(ring.begin(), ring.begin() + n);
+        return;
+    }
+
+    const double toleranceSquared = double(tolerance) * tolerance;
+
+    // A vertex is dropped when it, and all vertices dropped since the last one that was kept, are
+    // close to the segment from the last kept vertex to the next one. This way, dropping many
+    // vertices in a row can't move the outline further than the tolerance.
+    result.push_back(ring[0]);
+    std::size_t lastKept = 0;
+    for (std::size_t i = 1; i < n; i++) {
+        const Coordinate& next = ring[i + 1 < n ? i + 1 : 0];
+        bool drop = true;
+        for (std::size_t j = lastKept + 1; j <= i && drop; j++) {
+            drop = segmentDistanceSquared(ring[j], result.back(), next) <= toleranceSquared;
+        }
+        if (!drop) {
+            result.push_back(ring[i]);
+            lastKept = i;
+        }
+    }
+
+    // The first vertex was kept unconditionally, and the last one was checked against it.
+    bool changed = true;
+    while (changed && result.size() >= 3) {
+        changed = false;
+        if (segmentDistanceSquared(result.front(), result.back(), result[1]) <= toleranceSquared) {
+            result.erase(result.begin());
+            changed = true;
+        } else if (segmentDistanceSquared(result.back(), result[result.size() - 2], result.front()) <= toleranceSquared) {
+            result.pop_back();
+            changed = true;
+        }
+    }
+}
+
+bool triangulateSimpleRing(const std::vector<Coordinate>& ring, std::vector<uint16_t>& triangles) {
+    const std::size_t n = ring.size();
+    if (n < 3 || n > maxSimpleRingSize) {
+        return false;
+    }
+
+    auto prevIndex = [n] (std::size_t i) { return i == 0 ? n - 1 : i - 1; };
+    auto nextIndex = [n] (std::size_t i) { return i + 1 == n ? 0 : i + 1; };
+
+    // A ring is convex when it turns in the same direction at every vertex and winds around only
+    // once, which is the case when its edges change their horizontal and vertical direction at
+    // most twice.
+    bool turnsLeft = false;
+    bool turnsRight = false;
+    SignChanges dx, dy;
+    int64_t area = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        const Coordinate& a = ring[prevIndex(i)];
+        const Coordinate& b = ring[i];
+        const Coordinate& c = ring[nextIndex(i)];
+        const int64_t turn = cross(a, b, c);
+        if (turn > 0) {
+            turnsLeft = true;
+        } else if (turn < 0) {
+            turnsRight = true;
+        } else if (dot(b, a, c) > 0) {
+            // The ring reverses its direction at this vertex.
+            return false;
+        }
+        dx.add(c.x - b.x);
+        dy.add(c.y - b.y);
+        area += int64_t(b.x) * c.y - int64_t(c.x) * b.y;
+    }
+
+    if (area == 0) {
+        return false;
+    }
+
+    if (!(turnsLeft && turnsRight) && dx.count() <= 2 && dy.count() <= 2) {
+        for (std::size_t i = 1; i + 1 < n; i++) {
+            triangles.push_back(0);
+            triangles.push_back(uint16_t(i));
+            triangles.push_back(uint16_t(i + 1));
+        }
+        return true;
+    }
+
+    // Non-adjacent edges of a simple ring have no point in common.
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = i + 2; j < n; j++) {
+            if (i == 0 && j == n - 1) {
+                continue;
+            }
+            if (segmentsIntersect(ring[i], ring[i + 1], ring[j], ring[nextIndex(j)])) {
+                return false;
+            }
+        }
+    }
+
+    // Clips ears until a single triangle remains. An ear is a convex vertex whose triangle with
+    // its neighbours contains no other vertex of the ring.
+    const int64_t orientation = area > 0 ? 1 : -1;
+    std::array<uint16_t, maxSimpleRingSize> prev;
+    std::array<uint16_t, maxSimpleRingSize> next;
+    for (std::size_t i = 0; i < n; i++) {
+        prev[i] = uint16_t(prevIndex(i));
+        next[i] = uint16_t(nextIndex(i));
+    }
+
+    auto isEar = [&] (uint16_t i) {
+        const Coordinate& a = ring[prev[i]];
+        const Coordinate& b = ring[i];
+        const Coordinate& c = ring[next[i]];
+        if (cross(a, b, c) * orientation <= 0) {
+            return false;
+        }
+        for (uint16_t v = next[next[i]]; v != prev[i]; v = next[v]) {
+            const Coordinate& p = ring[v];
+            if (cross(a, b, p) * orientation >= 0 &&
+                cross(b, c, p) * orientation >= 0 &&
+                cross(c, a, p) * orientation >= 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const std::size_t start = triangles.size();
+    std::size_t remaining = n;
+    std::size_t stalled = 0;
+    uint16_t i = 0;
+    while (remaining > 3) {
+        if (isEar(i)) {
+            triangles.push_back(prev[i]);
+            triangles.push_back(i);
+            triangles.push_back(next[i]);
+            next[prev[i]] = next[i];
+            prev[next[i]] = prev[i];
+            i = prev[i];
+            remaining--;
+            stalled = 0;
+        } else {
+            i = next[i];
+            if (++stalled > remaining) {
+                // Only possible with degenerate input; leave it to the tessellator.
+                triangles.resize(start);
+                return false;
+            }
+        }
+    }
+
+    triangles.push_back(prev[i]);
+    triangles.push_back(i);
+    triangles.push_back(next[i]);
+    return true;
+}
+
+} // end namespace util
+} // end namespace mbgl
@@ -0,0 +1,27 @@
+#ifndef MBGL_UTIL_POLYGON
+#define MBGL_UTIL_POLYGON
+
+#include <mbgl/util/vec.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+// Copies the vertices of a polygon ring to the result, leaving out repeated vertices, including
+// a closing vertex that repeats the first one, and vertices that are within the tolerance of the
+// segment between their neighbours. Rings that enclose no area end up with less than three
+// vertices.
+void simplifyRing(const std::vector<Coordinate>& ring, float tolerance, std::vector<Coordinate>& result);
+
+// Triangulates a ring that doesn't intersect itself: convex rings as a fan, others by clipping
+// ears. Appends three indices into the ring per triangle. Returns false without adding any
+// triangles when the ring intersects or touches itself, or has too many vertices to check
+// cheaply; such rings need a full tessellator.
+bool triangulateSimpleRing(const std::vector<Coordinate>& ring, std::vector<uint16_t>& triangles);
+
+} // end namespace util
+} // end namespace mbgl
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef MBGL_UTIL_WORK_PRIORITY
+#define MBGL_UTIL_WORK_PRIORITY
+
+#include <cstdint>
+
+namespace mbgl {
+
+// Determines the order in which the Worker runs queued jobs. Jobs are ordered by type first, and
+// then by the distance of their tile from the center of the viewport, measured in tiles.
+struct WorkPriority {
+    enum Type : uint8_t {
+        Visible,   // Parsing a tile that covers the viewport.
+        Placement, // Placing the symbols of an already parsed tile again.
+        Prefetch,  // Parsing a tile that doesn't cover the viewport yet.
+    };
+
+    Type type = Visible;
+    float distance = 0;
+};
+
+// Returns true if a job with priority a should run before a job with priority b.
+inline bool operator<(const WorkPriority& a, const WorkPriority& b) {
+    return a.type < b.type || (a.type == b.type && a.distance < b.distance);
+}
+
+} // namespace mbgl
+
+#endif
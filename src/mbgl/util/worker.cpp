@@ -2,110 +2,376 @@
 #include <mbgl/util/work_task.hpp>
 #include <mbgl/util/work_request.hpp>
 #include <mbgl/platform/platform.hpp>
+#include <mbgl/platform/log.hpp>
 #include <mbgl/renderer/raster_bucket.hpp>
 #include <mbgl/map/geometry_tile.hpp>
 
 #include <cassert>
-#include <future>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
 
 namespace mbgl {
 
-class Worker::Impl {
+namespace {
+
+class Job : public WorkTask {
 public:
-    Impl() = default;
+    Job(WorkPriority priority_,
+        const std::atomic<TileData::State>* state_,
+        std::shared_ptr<std::atomic<bool>> canceled_)
+        : priority(priority_),
+          state(state_),
+          canceled(canceled_) {
+    }
 
-    void parseRasterTile(std::unique_ptr<RasterBucket> bucket,
-                         const std::shared_ptr<const std::string> data,
-                         std::function<void(RasterTileParseResult)> callback) {
-        std::unique_ptr<util::Image> image(new util::Image(*data));
-        if (!(*image)) {
-            callback(RasterTileParseResult("error parsing raster image"));
+    enum class Outcome {
+        Completed,
+        Abandoned, // The job stopped running because its tile became obsolete.
+        Canceled,  // The job was cancelled before it could run.
+    };
+
+    void operator()() override {
+        // Lock the mutex while processing so that cancel() will block.
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        if (*canceled) {
+            // isObsolete() couldn't tell, since cancel() held the mutex at the time.
+            outcome = Outcome::Canceled;
+            return;
         }
 
-        if (!bucket->setImage(std::move(image))) {
-            callback(RasterTileParseResult("error setting raster image to bucket"));
+        run();
+        // The tile may be destroyed as soon as the mutex is released, so its state can't be read
+        // after this function returns.
+        outcome = isTileObsolete() ? Outcome::Abandoned : Outcome::Completed;
+    }
+
+    // If the job has not yet begun, this will cancel it. If the job is in progress, this will
+    // block until it completed. In both cases, the callback of the job won't be invoked.
+    void cancel() override {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        *canceled = true;
+    }
+
+    // Whether the job can be dropped without running it. The tile may be in the middle of being
+    // destroyed, which cancels the job while holding the mutex, and its state is only valid while
+    // the job isn't cancelled. If the mutex is held, the job is assumed to be current.
+    bool isObsolete() const {
+        std::unique_lock<std::recursive_mutex> lock(mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return false;
         }
+        return *canceled || isTileObsolete();
+    }
 
-        callback(RasterTileParseResult(std::move(bucket)));
+    // Only valid after the job was run.
+    Outcome getOutcome() const {
+        return outcome;
     }
 
-    void parseGeometryTile(TileWorker* worker,
-                           std::vector<util::ptr<StyleLayer>> layers,
-                           std::unique_ptr<GeometryTile> tile,
-                           PlacementConfig config,
-                           std::function<void(TileParseResult)> callback) {
-        try {
-            callback(worker->parseAllLayers(layers, *tile, config));
-        } catch (const std::exception& ex) {
-            callback(TileParseResult(ex.what()));
+    const WorkPriority priority;
+
+    // Set when the job is queued.
+    uint64_t sequence = 0;
+    TimePoint queued;
+
+private:
+    virtual void run() = 0;
+
+    // Must only be called while holding the mutex and if the job isn't cancelled.
+    bool isTileObsolete() const {
+        return state && *state == TileData::State::obsolete;
+    }
+
+    // The state of the tile this job belongs to, if any.
+    const std::atomic<TileData::State>* const state;
+    const std::shared_ptr<std::atomic<bool>> canceled;
+
+    mutable std::recursive_mutex mutex;
+    Outcome outcome = Outcome::Canceled;
+};
+
+template <class Fn>
+class Invoker : public Job {
+public:
+    Invoker(WorkPriority priority_,
+            const std::atomic<TileData::State>* state_,
+            std::shared_ptr<std::atomic<bool>> canceled_,
+            Fn&& fn_)
+        : Job(priority_, state_, canceled_),
+          fn(std::move(fn_)) {
+    }
+
+private:
+    void run() override {
+        fn();
+    }
+
+    Fn fn;
+};
+
+// Returns a function that invokes the callback on the current RunLoop, unless the request was
+// cancelled in the meantime. The flag is checked before posting to the RunLoop, since the RunLoop
+// might have been destroyed if the request was cancelled, and again before invoking the callback,
+// since the request may have been cancelled after the callback was posted.
+template <class... Args>
+std::function<void (Args...)> afterCallback(std::shared_ptr<std::atomic<bool>> canceled,
+                                            std::function<void (Args...)> callback) {
+    util::RunLoop* loop = util::RunLoop::Get();
+    return [canceled, loop, callback] (Args... args) {
+        if (!*canceled) {
+            loop->invoke([canceled, callback] (Args... results) {
+                if (!*canceled) {
+                    callback(std::move(results)...);
+                }
+            }, std::move(args)...);
         }
+    };
+}
+
+// Orders the heap so that the job that should run first is at the top. Jobs with the same
+// priority run in the order they were queued.
+struct RunsAfter {
+    bool operator()(const std::shared_ptr<Job>& a, const std::shared_ptr<Job>& b) const {
+        if (a->priority < b->priority) return false;
+        if (b->priority < a->priority) return true;
+        return a->sequence > b->sequence;
     }
+};
 
-    void parsePendingGeometryTileLayers(TileWorker* worker,
-                                        std::function<void(TileParseResult)> callback) {
-        try {
-            callback(worker->parsePendingLayers());
-        } catch (const std::exception& ex) {
-            callback(TileParseResult(ex.what()));
+} // namespace
+
+class Worker::Impl {
+public:
+    Impl(std::size_t count) {
+        util::ThreadContext context = { "Worker", util::ThreadType::Worker, util::ThreadPriority::Low };
+        for (std::size_t i = 0; i < count; i++) {
+            threads.emplace_back(std::make_unique<util::Thread<Runner>>(context, *this));
+            threads.back()->invoke(&Runner::run);
         }
     }
 
-    void redoPlacement(TileWorker* worker,
-                       std::vector<util::ptr<StyleLayer>> layers,
-                       const std::unordered_map<std::string, std::unique_ptr<Bucket>>* buckets,
-                       PlacementConfig config,
-                       std::function<void()> callback) {
-        worker->redoPlacement(layers, buckets, config);
-        callback();
+    ~Impl() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        condition.notify_all();
+
+        // Threads return from Runner::run() first, so that their run loops can be stopped.
+        threads.clear();
+    }
+
+    template <class Fn>
+    std::unique_ptr<WorkRequest> push(WorkPriority priority,
+                                      const std::atomic<TileData::State>* state,
+                                      std::shared_ptr<std::atomic<bool>> canceled,
+                                      Fn fn) {
+        auto job = std::make_shared<Invoker<Fn>>(priority, state, canceled, std::move(fn));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job->sequence = sequence++;
+            job->queued = Clock::now();
+            jobs.push(job);
+        }
+        condition.notify_one();
+        return std::make_unique<WorkRequest>(job);
     }
-};
 
-Worker::Worker(std::size_t count) {
-    util::ThreadContext context = { "Worker", util::ThreadType::Worker, util::ThreadPriority::Low };
-    for (std::size_t i = 0; i < count; i++) {
-        threads.emplace_back(std::make_unique<util::Thread<Impl>>(context));
+    Statistics getStatistics() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        Statistics result = statistics;
+        result.queued = jobs.size();
+        return result;
     }
+
+private:
+    // Each thread of the pool blocks in run() and processes jobs from the shared queue until the
+    // Worker is destroyed.
+    class Runner {
+    public:
+        Runner(Impl& impl_) : impl(impl_) {}
+
+        void run() {
+            impl.process();
+        }
+
+    private:
+        Impl& impl;
+    };
+
+    void process() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            condition.wait(lock, [this] { return stopped || !jobs.empty(); });
+            if (stopped) {
+                return;
+            }
+
+            std::shared_ptr<Job> job = jobs.top();
+            jobs.pop();
+
+            if (job->isObsolete()) {
+                statistics.dropped++;
+                continue;
+            }
+
+            const TimePoint start = Clock::now();
+            lock.unlock();
+            (*job)();
+            const TimePoint end = Clock::now();
+            lock.lock();
+
+            const Duration wait = start - job->queued;
+            const Duration run = end - start;
+            switch (job->getOutcome()) {
+            case Job::Outcome::Canceled:
+                statistics.dropped++;
+                continue;
+            case Job::Outcome::Abandoned:
+                statistics.abandoned++;
+                statistics.abandonedRun += run;
+                continue;
+            case Job::Outcome::Completed:
+                break;
+            }
+
+            statistics.completed++;
+            statistics.totalWait += wait;
+            statistics.maxWait = std::max(statistics.maxWait, wait);
+            statistics.totalRun += run;
+            statistics.maxRun = std::max(statistics.maxRun, run);
+
+            if (job->priority.type == WorkPriority::Placement) {
+                statistics.placements++;
+                statistics.placementRun += run;
+            }
+        }
+    }
+
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    std::priority_queue<std::shared_ptr<Job>, std::vector<std::shared_ptr<Job>>, RunsAfter> jobs;
+    uint64_t sequence = 0;
+    bool stopped = false;
+    Statistics statistics;
+
+    std::vector<std::unique_ptr<util::Thread<Runner>>> threads;
+};
+
+Worker::Worker(std::size_t count)
+    : impl(std::make_unique<Impl>(count)) {
 }
 
 Worker::~Worker() = default;
 
 std::unique_ptr<WorkRequest>
-Worker::parseRasterTile(std::unique_ptr<RasterBucket> bucket,
+Worker::invoke(WorkPriority priority,
+               std::function<void()> work,
+               std::function<void()> callback) {
+    auto canceled = std::make_shared<std::atomic<bool>>(false);
+    auto after = afterCallback(canceled, callback);
+    return impl->push(priority, nullptr, canceled, [work, after] {
+        work();
+        after();
+    });
+}
+
+std::unique_ptr<WorkRequest>
+Worker::parseRasterTile(WorkPriority priority,
+                        std::unique_ptr<RasterBucket> bucket,
                         const std::shared_ptr<const std::string> data,
                         std::function<void(RasterTileParseResult)> callback) {
-    current = (current + 1) % threads.size();
-    return threads[current]->invokeWithCallback(&Worker::Impl::parseRasterTile, callback, bucket,
-                                                data);
+    auto canceled = std::make_shared<std::atomic<bool>>(false);
+    auto after = afterCallback(canceled, callback);
+    return impl->push(priority, nullptr, canceled, [bucket = std::move(bucket), data, after] () mutable {
+        std::unique_ptr<util::Image> image(new util::Image(*data));
+        if (!(*image)) {
+            after(RasterTileParseResult("error parsing raster image"));
+        }
+
+        if (!bucket->setImage(std::move(image))) {
+            after(RasterTileParseResult("error setting raster image to bucket"));
+        }
+
+        after(RasterTileParseResult(std::move(bucket)));
+    });
 }
 
 std::unique_ptr<WorkRequest>
-Worker::parseGeometryTile(TileWorker& worker,
+Worker::parseGeometryTile(WorkPriority priority,
+                          TileWorker& worker,
                           std::vector<util::ptr<StyleLayer>> layers,
                           std::unique_ptr<GeometryTile> tile,
                           PlacementConfig config,
                           std::function<void(TileParseResult)> callback) {
-    current = (current + 1) % threads.size();
-    return threads[current]->invokeWithCallback(&Worker::Impl::parseGeometryTile, callback, &worker,
-                                                std::move(layers), std::move(tile), config);
+    auto canceled = std::make_shared<std::atomic<bool>>(false);
+    auto after = afterCallback(canceled, callback);
+    return impl->push(priority, &worker.getState(), canceled,
+                      [&worker, layers = std::move(layers), tile = std::move(tile), config, after] () mutable {
+        try {
+            after(worker.parseAllLayers(std::move(layers), *tile, config));
+        } catch (const std::exception& ex) {
+            after(TileParseResult(ex.what()));
+        }
+    });
 }
 
 std::unique_ptr<WorkRequest>
-Worker::parsePendingGeometryTileLayers(TileWorker& worker,
+Worker::parsePendingGeometryTileLayers(WorkPriority priority,
+                                       TileWorker& worker,
                                        std::function<void(TileParseResult)> callback) {
-    current = (current + 1) % threads.size();
-    return threads[current]->invokeWithCallback(&Worker::Impl::parsePendingGeometryTileLayers,
-                                                callback, &worker);
+    auto canceled = std::make_shared<std::atomic<bool>>(false);
+    auto after = afterCallback(canceled, callback);
+    return impl->push(priority, &worker.getState(), canceled, [&worker, after] {
+        try {
+            after(worker.parsePendingLayers());
+        } catch (const std::exception& ex) {
+            after(TileParseResult(ex.what()));
+        }
+    });
 }
 
 std::unique_ptr<WorkRequest>
-Worker::redoPlacement(TileWorker& worker,
+Worker::redoPlacement(WorkPriority priority,
+                      TileWorker& worker,
                       std::vector<util::ptr<StyleLayer>> layers,
                       const std::unordered_map<std::string, std::unique_ptr<Bucket>>& buckets,
                       PlacementConfig config,
                       std::function<void()> callback) {
-    current = (current + 1) % threads.size();
-    return threads[current]->invokeWithCallback(&Worker::Impl::redoPlacement, callback, &worker,
-                                                layers, &buckets, config);
+    auto canceled = std::make_shared<std::atomic<bool>>(false);
+    auto after = afterCallback(canceled, callback);
+    return impl->push(priority, &worker.getState(), canceled, [&worker, layers, &buckets, config, after] {
+        worker.redoPlacement(layers, &buckets, config);
+        after();
+    });
+}
+
+Worker::Statistics Worker::getStatistics() const {
+    return impl->getStatistics();
+}
+
+void Worker::dumpDebugLogs() const {
+    const Statistics statistics = getStatistics();
+
+    using Milliseconds = std::chrono::duration<float, std::chrono::milliseconds::period>;
+    const float completed = std::max<std::size_t>(statistics.completed, 1);
+    Log::Info(Event::General, "Worker::queued: %zu", statistics.queued);
+    Log::Info(Event::General, "Worker::completed: %zu", statistics.completed);
+    Log::Info(Event::General, "Worker::dropped: %zu", statistics.dropped);
+    Log::Info(Event::General, "Worker::averageWait: %fms", Milliseconds(statistics.totalWait).count() / completed);
+    Log::Info(Event::General, "Worker::maxWait: %fms", Milliseconds(statistics.maxWait).count());
+    Log::Info(Event::General, "Worker::averageRun: %fms", Milliseconds(statistics.totalRun).count() / completed);
+    Log::Info(Event::General, "Worker::maxRun: %fms", Milliseconds(statistics.maxRun).count());
+    Log::Info(Event::General, "Worker::placements: %zu", statistics.placements);
+    Log::Info(Event::General, "Worker::placementRun: %fms", Milliseconds(statistics.placementRun).count());
+    Log::Info(Event::General, "Worker::abandoned: %zu", statistics.abandoned);
+    Log::Info(Event::General, "Worker::abandonedRun: %fms", Milliseconds(statistics.abandonedRun).count());
+
+    // Assumes that abandoned jobs would have taken as long as an average completed job.
+    const float averageRun = Milliseconds(statistics.totalRun).count() / completed;
+    const float saved = averageRun * statistics.abandoned - Milliseconds(statistics.abandonedRun).count();
+    Log::Info(Event::General, "Worker::estimatedSavedRun: %fms", std::max(saved, 0.0f));
 }
 
 } // end namespace mbgl
@@ -3,6 +3,8 @@
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/thread.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/work_priority.hpp>
 #include <mbgl/map/tile_worker.hpp>
 
 #include <functional>
@@ -18,6 +20,10 @@ using RasterTileParseResult = mapbox::util::variant<
     std::unique_ptr<Bucket>, // success
     std::string>;            // error
 
+// A pool of threads that share a single queue of jobs. Whenever a thread becomes idle, it takes
+// the queued job with the highest priority, so that a single expensive job never holds up other
+// jobs while threads are available. Jobs for tiles that became obsolete while they were queued are
+// dropped without running.
 class Worker : public mbgl::util::noncopyable {
 public:
     explicit Worker(std::size_t count);
@@ -35,29 +41,65 @@ public:
 
     using Request = std::unique_ptr<WorkRequest>;
 
-    Request parseRasterTile(std::unique_ptr<RasterBucket> bucket,
+    Request invoke(WorkPriority,
+                   std::function<void()> work,
+                   std::function<void()> callback);
+
+    Request parseRasterTile(WorkPriority,
+                            std::unique_ptr<RasterBucket> bucket,
                             std::shared_ptr<const std::string> data,
                             std::function<void(RasterTileParseResult)> callback);
 
-    Request parseGeometryTile(TileWorker&,
+    Request parseGeometryTile(WorkPriority,
+                              TileWorker&,
                               std::vector<util::ptr<StyleLayer>>,
                               std::unique_ptr<GeometryTile>,
                               PlacementConfig,
                               std::function<void(TileParseResult)> callback);
 
-    Request parsePendingGeometryTileLayers(TileWorker&,
+    Request parsePendingGeometryTileLayers(WorkPriority,
+                                           TileWorker&,
                                            std::function<void(TileParseResult)> callback);
 
-    Request redoPlacement(TileWorker&,
+    Request redoPlacement(WorkPriority,
+                          TileWorker&,
                           std::vector<util::ptr<StyleLayer>>,
                           const std::unordered_map<std::string, std::unique_ptr<Bucket>>&,
                           PlacementConfig config,
                           std::function<void()> callback);
 
+    struct Statistics {
+        // Jobs that are currently queued, including cancelled jobs that haven't been dropped yet.
+        std::size_t queued = 0;
+        std::size_t completed = 0;
+
+        // Jobs that were cancelled or became obsolete before they started running.
+        std::size_t dropped = 0;
+
+        // Time completed jobs spent in the queue and running.
+        Duration totalWait = Duration::zero();
+        Duration maxWait = Duration::zero();
+        Duration totalRun = Duration::zero();
+        Duration maxRun = Duration::zero();
+
+        // Completed jobs that placed the symbols of a parsed tile again, and the time they ran.
+        // These are included in the totals above.
+        std::size_t placements = 0;
+        Duration placementRun = Duration::zero();
+
+        // Jobs whose tile became obsolete while they were running, and the time they ran before
+        // they stopped at a cancellation checkpoint. These are not counted as completed.
+        std::size_t abandoned = 0;
+        Duration abandonedRun = Duration::zero();
+    };
+
+    Statistics getStatistics() const;
+
+    void dumpDebugLogs() const;
+
 private:
     class Impl;
-    std::vector<std::unique_ptr<util::Thread<Impl>>> threads;
-    std::size_t current = 0;
+    const std::unique_ptr<Impl> impl;
 };
 }
 
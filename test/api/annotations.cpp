@@ -1,9 +1,12 @@
 #include "../fixtures/util.hpp"
 
+#include <mbgl/annotation/annotation_manager.hpp>
+#include <mbgl/annotation/annotation_tile.hpp>
 #include <mbgl/annotation/point_annotation.hpp>
 #include <mbgl/annotation/shape_annotation.hpp>
 #include <mbgl/sprite/sprite_image.hpp>
 #include <mbgl/map/map.hpp>
+#include <mbgl/map/map_data.hpp>
 #include <mbgl/map/still_image.hpp>
 #include <mbgl/platform/default/headless_display.hpp>
 #include <mbgl/platform/default/headless_view.hpp>
@@ -12,6 +15,7 @@
 #include <mbgl/util/io.hpp>
 
 #include <future>
+#include <set>
 #include <vector>
 
 using namespace mbgl;
@@ -204,3 +208,78 @@ TEST(Annotations, CustomIcon) {
 
     util::write_file("test/output/custom_icon.png", renderPNG(map));
 }
+
+TEST(Annotations, UpdateAffectedTiles) {
+    MapData data(MapMode::Still, GLContextMode::Unique, 1);
+
+    // The four tiles at z1, each of which counts its updates.
+    std::vector<std::unique_ptr<AnnotationTileMonitor>> monitors;
+    std::vector<int> updates(4, 0);
+    for (int32_t i = 0; i < 4; i++) {
+        monitors.push_back(std::make_unique<AnnotationTileMonitor>(TileID(1, i % 2, i / 2, 1), data));
+        monitors.back()->monitorTile([&updates, i] (std::exception_ptr, std::unique_ptr<GeometryTile>) {
+            updates[i]++;
+        });
+    }
+    EXPECT_EQ(std::vector<int>({ 1, 1, 1, 1 }), updates);
+
+    // Edits within one frame cause a single update of the tiles they touch.
+    AnnotationIDs points = data.getAnnotationManager()->addPointAnnotations({
+        PointAnnotation({ 45, 90 }), PointAnnotation({ 40, 100 }), PointAnnotation({ -45, -90 })
+    }, 16);
+    data.getAnnotationManager()->updateTiles();
+    EXPECT_EQ(std::vector<int>({ 1, 2, 2, 1 }), updates);
+
+    // Nothing changed since.
+    data.getAnnotationManager()->updateTiles();
+    EXPECT_EQ(std::vector<int>({ 1, 2, 2, 1 }), updates);
+
+    data.getAnnotationManager()->removeAnnotations({ points[0] });
+    data.getAnnotationManager()->updateTiles();
+    EXPECT_EQ(std::vector<int>({ 1, 3, 2, 1 }), updates);
+
+    // Shapes update every tile they cross.
+    AnnotationSegments segments = {{ {{ { -10, -10 }, { -20, 10 } }} }};
+    data.getAnnotationManager()->addShapeAnnotations({ ShapeAnnotation(segments, LineAnnotationProperties()) }, 16);
+    data.getAnnotationManager()->updateTiles();
+    EXPECT_EQ(std::vector<int>({ 1, 3, 3, 2 }), updates);
+}
+
+TEST(Annotations, PointClustering) {
+    MapData data(MapMode::Still, GLContextMode::Unique, 1);
+    data.getAnnotationManager()->addPointAnnotations({
+        PointAnnotation({ 10, 10 }, "a"), PointAnnotation({ 11, 11 }, "b"), PointAnnotation({ -40, -100 }, "c")
+    }, 16);
+
+    std::multiset<std::string> sprites;
+    std::multiset<std::string> counts;
+    AnnotationTileMonitor monitor(TileID(0, 0, 0, 0), data);
+    monitor.monitorTile([&] (std::exception_ptr, std::unique_ptr<GeometryTile> tile) {
+        sprites.clear();
+        counts.clear();
+        tile->getLayer(AnnotationManager::PointLayerID)->eachFeature([&] (const GeometryTileFeature& feature) {
+            sprites.insert(toString(*feature.getValue("sprite")));
+            auto count = feature.getValue("point_count");
+            counts.insert(count ? toString(*count) : "");
+        });
+    });
+    EXPECT_EQ(std::multiset<std::string>({ "a", "b", "c" }), sprites);
+
+    data.getAnnotationManager()->setPointClustering(true);
+    data.getAnnotationManager()->updateTiles();
+    EXPECT_EQ(std::multiset<std::string>({ "default_marker", "c" }), sprites);
+    EXPECT_EQ(std::multiset<std::string>({ "2", "" }), counts);
+
+    // The index follows edits.
+    AnnotationIDs added = data.getAnnotationManager()->addPointAnnotations({ PointAnnotation({ 12, 12 }, "d") }, 16);
+    data.getAnnotationManager()->updateTiles();
+    EXPECT_EQ(std::multiset<std::string>({ "3", "" }), counts);
+
+    data.getAnnotationManager()->removeAnnotations(added);
+    data.getAnnotationManager()->updateTiles();
+    EXPECT_EQ(std::multiset<std::string>({ "2", "" }), counts);
+
+    data.getAnnotationManager()->setPointClustering(false);
+    data.getAnnotationManager()->updateTiles();
+    EXPECT_EQ(std::multiset<std::string>({ "a", "b", "c" }), sprites);
+}
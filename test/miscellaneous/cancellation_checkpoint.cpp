@@ -0,0 +1,45 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/util/cancellation_checkpoint.hpp>
+
+using namespace mbgl::util;
+
+TEST(CancellationCheckpoint, NeverCancelsByDefault) {
+    CancellationCheckpoint checkpoint;
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_FALSE(checkpoint.poll());
+    }
+    EXPECT_FALSE(checkpoint.check());
+}
+
+TEST(CancellationCheckpoint, PollsEveryInterval) {
+    int evaluated = 0;
+    bool obsolete = false;
+    CancellationCheckpoint checkpoint([&] { evaluated++; return obsolete; }, 4);
+
+    for (int i = 0; i < 8; i++) {
+        EXPECT_FALSE(checkpoint.poll());
+    }
+    EXPECT_EQ(2, evaluated);
+
+    // The condition is only noticed at the next interval.
+    obsolete = true;
+    EXPECT_FALSE(checkpoint.poll());
+    EXPECT_FALSE(checkpoint.poll());
+    EXPECT_FALSE(checkpoint.poll());
+    EXPECT_TRUE(checkpoint.poll());
+    EXPECT_EQ(3, evaluated);
+}
+
+TEST(CancellationCheckpoint, StaysCancelled) {
+    int evaluated = 0;
+    bool obsolete = true;
+    CancellationCheckpoint checkpoint([&] { evaluated++; return obsolete; }, 4);
+
+    EXPECT_TRUE(checkpoint.check());
+    obsolete = false;
+    EXPECT_TRUE(checkpoint.poll());
+    EXPECT_TRUE(checkpoint.check());
+    EXPECT_TRUE(checkpoint.isCancelled());
+    EXPECT_EQ(1, evaluated);
+}
@@ -0,0 +1,61 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/text/collision_tile.hpp>
+
+#include <algorithm>
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+// Places the labels in order and returns the scale at which each of them is shown. Scales at or
+// beyond the maximum scale all mean that the label is never shown.
+std::vector<float> place(const PlacementConfig& config, std::vector<CollisionFeature> features) {
+    CollisionTile tile(config);
+    std::vector<float> scales;
+    for (auto& feature : features) {
+        const float scale = tile.placeFeature(feature);
+        tile.insertFeature(feature, scale);
+        scales.push_back(std::min(scale, tile.maxScale));
+    }
+    return scales;
+}
+
+} // namespace
+
+TEST(CollisionTile, GridMatchesRTree) {
+    // Point labels of random sizes, and labels along random lines, crowding a tile and its edges.
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-512, 4096 + 512);
+    std::uniform_real_distribution<float> size(5, 100);
+    std::uniform_real_distribution<float> direction(-1, 1);
+
+    std::vector<CollisionFeature> features;
+    for (int i = 0; i < 1000; i++) {
+        const float x = position(random), y = position(random);
+        const float width = size(random), height = size(random) / 4;
+        if (i % 4) {
+            features.emplace_back(std::vector<Coordinate>(), Anchor(x, y, 0, 0.5f),
+                                  -height, height, -width, width, 1, 0, false);
+        } else {
+            const Coordinate a(x - 400 * direction(random), y - 400 * direction(random));
+            const Coordinate b(x, y);
+            const Coordinate c(x + 400 * direction(random), y + 400 * direction(random));
+            features.emplace_back(std::vector<Coordinate>{ a, b, c }, Anchor(x, y, 0, 0.5f, 1),
+                                  -height, height, -width, width, 1, 0, true);
+        }
+    }
+
+    for (const float angle : { 0.0, M_PI / 6, M_PI / 2, -M_PI * 3 / 4 }) {
+        for (const float pitch : { 0.0, M_PI / 4 }) {
+            const auto grid = place(PlacementConfig(angle, pitch, false, CollisionIndex::Grid), features);
+            const auto rtree = place(PlacementConfig(angle, pitch, false, CollisionIndex::RTree), features);
+            EXPECT_EQ(rtree, grid) << "angle " << angle << ", pitch " << pitch;
+
+            // Some labels are shown, some only at higher zoom levels, and some never.
+            EXPECT_NE(grid.end(), std::find(grid.begin(), grid.end(), 0.5f));
+            EXPECT_NE(grid.end(), std::find(grid.begin(), grid.end(), 2.0f));
+        }
+    }
+}
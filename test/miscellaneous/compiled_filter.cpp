@@ -0,0 +1,124 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/map/geometry_tile.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/compiled_filter_private.hpp>
+#include <mbgl/style/filter_expression_private.hpp>
+
+#include <map>
+
+using namespace mbgl;
+
+namespace {
+
+typedef std::map<std::string, Value> Properties;
+
+class Extractor {
+public:
+    Extractor(const Properties& properties_, FeatureType type_)
+        : properties(properties_), type(type_) {}
+
+    mapbox::util::optional<Value> getValue(const std::string& key) const {
+        if (key == "$type")
+            return Value(uint64_t(type));
+        auto it = properties.find(key);
+        if (it == properties.end())
+            return mapbox::util::optional<Value>();
+        return it->second;
+    }
+
+private:
+    const Properties& properties;
+    FeatureType type;
+};
+
+bool evaluateCompiled(const CompiledFilter& filter, const Properties& properties, FeatureType type) {
+    return filter.evaluate(type, [&] (std::size_t key) -> const Value* {
+        auto it = properties.find(filter.getKeys()[key]);
+        return it == properties.end() ? nullptr : &it->second;
+    });
+}
+
+FilterExpression typeIs(FeatureType type) {
+    return EqualsExpression { "$type", uint64_t(type) };
+}
+
+} // namespace
+
+TEST(CompiledFilter, MatchesInterpreter) {
+    const std::vector<FilterExpression> filters = {
+        NullExpression {},
+        EqualsExpression { "class", std::string("street") },
+        NotEqualsExpression { "class", std::string("street") },
+        EqualsExpression { "level", int64_t(1) },
+        LessThanExpression { "level", uint64_t(2) },
+        LessThanEqualsExpression { "level", double(1) },
+        GreaterThanExpression { "level", int64_t(0) },
+        GreaterThanEqualsExpression { "level", int64_t(2) },
+        InExpression { "class", { std::string("main"), std::string("street"), std::string("main"), int64_t(1) } },
+        InExpression { "level", { std::string("1"), uint64_t(1), true } },
+        NotInExpression { "class", { std::string("street"), std::string("path") } },
+        NotInExpression { "missing", { std::string("street") } },
+        typeIs(FeatureType::Point),
+        NotEqualsExpression { "$type", uint64_t(FeatureType::Polygon) },
+        InExpression { "$type", { uint64_t(FeatureType::Point), uint64_t(FeatureType::LineString) } },
+        NotInExpression { "$type", { uint64_t(FeatureType::Point) } },
+        AllExpression {},
+        AnyExpression {},
+        NoneExpression {},
+        AllExpression { { typeIs(FeatureType::LineString), InExpression { "class", { std::string("street") } } } },
+        AllExpression { { typeIs(FeatureType::LineString), typeIs(FeatureType::Polygon) } },
+        AnyExpression { { typeIs(FeatureType::LineString), EqualsExpression { "level", int64_t(2) } } },
+        AnyExpression { { NullExpression {}, EqualsExpression { "level", int64_t(2) } } },
+        NoneExpression { { typeIs(FeatureType::Point), EqualsExpression { "class", std::string("path") } } },
+        NoneExpression { { AllExpression { { typeIs(FeatureType::LineString), EqualsExpression { "level", int64_t(1) } } } } },
+        NoneExpression { { EqualsExpression { "class", std::string("path") } } },
+        AllExpression { { AllExpression { { EqualsExpression { "class", std::string("street") },
+                                            AnyExpression { { GreaterThanExpression { "level", int64_t(0) },
+                                                              NotInExpression { "class", { std::string("street") } } } } } },
+                          NotEqualsExpression { "$type", uint64_t(FeatureType::Point) } } },
+    };
+
+    const std::vector<Properties> features = {
+        {},
+        { { "class", std::string("street") } },
+        { { "class", std::string("main") }, { "level", int64_t(1) } },
+        { { "class", std::string("path") }, { "level", uint64_t(2) } },
+        { { "class", int64_t(1) }, { "level", double(0.5) } },
+        { { "level", true } },
+        { { "level", std::string("1") } },
+    };
+
+    for (std::size_t i = 0; i < filters.size(); i++) {
+        const CompiledFilter compiled(filters[i]);
+        for (const auto& properties : features) {
+            for (uint8_t type = 0; type < 4; type++) {
+                EXPECT_EQ(evaluate(filters[i], Extractor(properties, FeatureType(type))),
+                          evaluateCompiled(compiled, properties, FeatureType(type)))
+                    << "filter " << i << ", type " << int(type);
+            }
+        }
+    }
+}
+
+TEST(CompiledFilter, ConstantFolding) {
+    // Tests that only depend on the feature type are merged into a single instruction.
+    EXPECT_EQ(1u, CompiledFilter().size());
+    EXPECT_EQ(1u, CompiledFilter(AllExpression { { typeIs(FeatureType::Point), NullExpression {} } }).size());
+    EXPECT_EQ(1u, CompiledFilter(NoneExpression { { typeIs(FeatureType::Point), typeIs(FeatureType::Polygon) } }).size());
+
+    // Nested all expressions are flattened.
+    const CompiledFilter nested(AllExpression { {
+        EqualsExpression { "class", std::string("street") },
+        AllExpression { { EqualsExpression { "level", int64_t(1) }, typeIs(FeatureType::LineString) } },
+    } });
+    EXPECT_EQ(4u, nested.size());
+    EXPECT_EQ(2u, nested.getKeys().size());
+
+    // Keys are deduplicated.
+    const CompiledFilter duplicateKeys(AnyExpression { {
+        EqualsExpression { "class", std::string("street") },
+        EqualsExpression { "class", std::string("path") },
+    } });
+    EXPECT_EQ(1u, duplicateKeys.getKeys().size());
+}
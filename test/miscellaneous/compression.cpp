@@ -0,0 +1,49 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/util/compression.hpp>
+
+#include <stdexcept>
+
+using namespace mbgl;
+
+TEST(Compression, DecompressWithSizeHint) {
+    std::string raw;
+    for (int i = 0; i < 10000; i++) {
+        raw += std::to_string(i);
+    }
+    const std::string compressed = util::compress(raw);
+
+    // An exact hint, no hint, and hints that are too small or too large all yield the same data.
+    for (const std::size_t hint : { raw.size(), std::size_t(0), std::size_t(1), raw.size() - 1, raw.size() * 2 }) {
+        const std::string result = util::decompress(compressed.data(), compressed.size(), hint);
+        EXPECT_EQ(raw, result) << hint;
+    }
+
+    EXPECT_EQ(raw, util::decompress(compressed));
+    EXPECT_EQ("", util::decompress(util::compress("")));
+}
+
+TEST(Compression, DecompressTruncated) {
+    const std::string compressed = util::compress(std::string(1024, 'x'));
+    EXPECT_THROW(util::decompress(compressed.data(), compressed.size() - 4, 1024), std::runtime_error);
+}
+
+TEST(Compression, DecompressMaximumSize) {
+    const std::string raw(100000, 'x');
+    const std::string compressed = util::compress(raw);
+
+    // Data that ends exactly at the maximum is fine, with or without a size hint.
+    EXPECT_EQ(raw, util::decompress(compressed.data(), compressed.size(), raw.size(), raw.size()));
+    EXPECT_EQ(raw, util::decompress(compressed.data(), compressed.size(), 0, raw.size()));
+
+    // A hint larger than the maximum doesn't allocate more than the maximum.
+    EXPECT_THROW(util::decompress(compressed.data(), compressed.size(), raw.size() * 1000, raw.size() - 1), std::runtime_error);
+    EXPECT_THROW(util::decompress(compressed.data(), compressed.size(), 0, 1024), std::runtime_error);
+}
+
+TEST(Compression, DecompressGzip) {
+    // "hello gzip", as written by gzip(1).
+    const std::string compressed("\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\x03\xcb\x48\xcd\xc9\xc9\x57"
+                                 "\x48\xaf\xca\x2c\x00\x00\x19\x6a\xd2\xdf\x0a\x00\x00\x00", 30);
+    EXPECT_EQ("hello gzip", util::decompress(compressed));
+}
@@ -0,0 +1,67 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/map/vector_tile.hpp>
+#include <mbgl/map/decoded_geometry_tile.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+TEST(DecodedGeometryTile, MatchesSourceTile) {
+    VectorTile tile(std::make_shared<std::string>(
+        util::read_file("test/fixtures/tiles/streets/15-17605-10749.vector.pbf")));
+    DecodedGeometryTile decoded(tile);
+
+    for (const auto& name : { "landuse", "road", "building" }) {
+        auto layer = tile.getLayer(name);
+        auto decodedLayer = decoded.getLayer(name);
+        ASSERT_TRUE(layer.get());
+        ASSERT_TRUE(decodedLayer.get());
+
+        // Subsequent lookups must not decode the layer again.
+        EXPECT_EQ(decodedLayer, decoded.getLayer(name));
+
+        ASSERT_EQ(layer->featureCount(), decodedLayer->featureCount());
+        for (std::size_t i = 0; i < layer->featureCount(); i++) {
+            auto feature = layer->getFeature(i);
+            auto decodedFeature = decodedLayer->getFeature(i);
+
+            EXPECT_EQ(feature->getType(), decodedFeature->getType());
+            EXPECT_EQ(feature->getGeometries(), decodedFeature->getGeometries());
+
+            for (const auto& key : { "class", "type", "osm_id", "missing" }) {
+                auto value = feature->getValue(key);
+                auto decodedValue = decodedFeature->getValue(key);
+                ASSERT_EQ(bool(value), bool(decodedValue));
+                if (value) {
+                    EXPECT_EQ(*value, *decodedValue);
+                }
+
+                // Repeated lookups must return the same result.
+                ASSERT_EQ(bool(value), bool(decodedFeature->getValue(key)));
+            }
+        }
+
+        // Iterating reuses one feature and the geometry buffer, but yields the same features.
+        std::size_t i = 0;
+        GeometryCollection buffer;
+        decodedLayer->eachFeature([&] (const GeometryTileFeature& decodedFeature) {
+            auto feature = layer->getFeature(i++);
+            EXPECT_EQ(feature->getType(), decodedFeature.getType());
+            EXPECT_EQ(feature->getGeometries(), decodedFeature.readGeometries(buffer));
+
+            auto keyID = decodedLayer->getKeyID("class");
+            if (keyID) {
+                const Value* value = feature->getInternedValue(*keyID);
+                const Value* decodedValue = decodedFeature.getInternedValue(*keyID);
+                ASSERT_EQ(bool(value), bool(decodedValue));
+                if (value) {
+                    EXPECT_EQ(value, decodedValue);
+                }
+            }
+        });
+        EXPECT_EQ(layer->featureCount(), i);
+    }
+
+    EXPECT_FALSE(decoded.getLayer("missing").get());
+    EXPECT_FALSE(decoded.getLayer("missing").get());
+}
@@ -0,0 +1,67 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/geometry/dirty_regions.hpp>
+
+using namespace mbgl;
+
+using Regions = std::vector<Rect<uint32_t>>;
+
+TEST(DirtyRegions, Merge) {
+    DirtyRegions regions(1024, 1024, 1);
+    EXPECT_TRUE(regions.empty());
+
+    // Glyphs next to each other are uploaded at once.
+    regions.add({ 0, 0, 20, 24 });
+    regions.add({ 20, 0, 16, 24 });
+    EXPECT_EQ((Regions { { 0, 0, 36, 24 } }), regions.getRegions());
+
+    // Distant glyphs are uploaded separately.
+    regions.add({ 500, 500, 20, 24 });
+    EXPECT_EQ((Regions { { 0, 0, 36, 24 }, { 500, 500, 20, 24 } }), regions.getRegions());
+
+    // A region that overlaps two others merges all of them.
+    regions.add({ 30, 0, 480, 510 });
+    EXPECT_EQ((Regions { { 0, 0, 520, 524 } }), regions.getRegions());
+}
+
+TEST(DirtyRegions, Clip) {
+    DirtyRegions regions(256, 256, 4);
+    regions.add({ 250, 250, 20, 20 });
+    regions.add({ 300, 0, 20, 20 });
+    regions.add({ 10, 10, 0, 20 });
+    EXPECT_EQ((Regions { { 250, 250, 6, 6 } }), regions.getRegions());
+}
+
+TEST(DirtyRegions, MaximumRegions) {
+    DirtyRegions regions(2048, 2048, 1);
+    for (uint32_t i = 0; i < 32; i++) {
+        regions.add({ (i % 6) * 200, (i / 6) * 200, 64, 64 });
+    }
+    EXPECT_EQ(32u, regions.getRegions().size());
+
+    // Too many regions are merged into one.
+    for (uint32_t i = 32; i < 36; i++) {
+        regions.add({ (i % 6) * 200, (i / 6) * 200, 64, 64 });
+    }
+    EXPECT_EQ((Regions { { 0, 0, 1064, 1064 } }), regions.getRegions());
+
+    regions.addAll();
+    EXPECT_EQ((Regions { { 0, 0, 2048, 2048 } }), regions.getRegions());
+}
+
+TEST(DirtyRegions, Stage) {
+    std::vector<uint8_t> pixels(64 * 64, 1);
+    DirtyRegions regions(64, 64, 1);
+    regions.add({ 3, 5, 7, 9 });
+    regions.stage(pixels.data());
+
+    // Changes after staging are tracked separately.
+    EXPECT_TRUE(regions.empty());
+    regions.add({ 40, 40, 4, 4 });
+    EXPECT_EQ((Regions { { 40, 40, 4, 4 } }), regions.getRegions());
+
+    // Staging again before uploading stages the earlier regions again.
+    regions.stage(pixels.data());
+    EXPECT_TRUE(regions.empty());
+    EXPECT_EQ(0u, regions.getStatistics().totalBytes);
+}
@@ -0,0 +1,174 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/text/edge_collision_index.hpp>
+
+#include <algorithm>
+
+using namespace mbgl;
+
+namespace {
+
+// A 100 × 20 label centered on the anchor.
+CollisionFeature label(float x, float y) {
+    return CollisionFeature({}, Anchor(x, y, 0, 0.5f), -10, 10, -50, 50, 1, 0, false);
+}
+
+} // namespace
+
+TEST(PlacementConfig, IsCloseTo) {
+    EXPECT_TRUE(PlacementConfig(0, 0).isCloseTo(PlacementConfig(0.02, 0)));
+    EXPECT_TRUE(PlacementConfig(0, 0.5).isCloseTo(PlacementConfig(0, 0.52)));
+    EXPECT_TRUE(PlacementConfig(M_PI - 0.01, 0).isCloseTo(PlacementConfig(-M_PI + 0.01, 0)));
+    EXPECT_FALSE(PlacementConfig(0, 0).isCloseTo(PlacementConfig(0.1, 0)));
+    EXPECT_FALSE(PlacementConfig(0, 0).isCloseTo(PlacementConfig(0, 0.1)));
+    EXPECT_FALSE(PlacementConfig(0, 0, false).isCloseTo(PlacementConfig(0, 0, true)));
+}
+
+TEST(EdgeCollisionIndex, NeighbourLabels) {
+    EdgeCollisionIndex index;
+    const TileID left(10, 100, 200, 10);
+    const TileID right(10, 101, 200, 10);
+    const TileID other(10, 300, 200, 10);
+
+    // The left tile places a label at its right edge, and one in its center.
+    CollisionTile leftTile(PlacementConfig {});
+    index.seed("source", left, leftTile);
+    auto edgeLabel = label(4090, 2000);
+    auto centerLabel = label(2048, 2000);
+    leftTile.insertFeature(edgeLabel, leftTile.placeFeature(edgeLabel));
+    leftTile.insertFeature(centerLabel, leftTile.placeFeature(centerLabel));
+    ASSERT_EQ(1u, leftTile.getEdgeBoxes().size());
+    index.publish("source", left, 1, leftTile);
+
+    // A label at the left edge of the right tile overlaps it.
+    CollisionTile rightTile(PlacementConfig {});
+    index.seed("source", right, rightTile);
+    auto overlapping = label(10, 2000);
+    EXPECT_LT(rightTile.minScale, rightTile.placeFeature(overlapping));
+
+    // Tiles that aren't neighbours, and other sources, are unaffected.
+    CollisionTile otherTile(PlacementConfig {});
+    index.seed("source", other, otherTile);
+    EXPECT_EQ(otherTile.minScale, otherTile.placeFeature(overlapping));
+
+    CollisionTile otherSourceTile(PlacementConfig {});
+    index.seed("other", right, otherSourceTile);
+    EXPECT_EQ(otherSourceTile.minScale, otherSourceTile.placeFeature(overlapping));
+
+    // Only the tile object that published the boxes removes them.
+    index.remove("source", left, 2);
+    CollisionTile stillBlocked(PlacementConfig {});
+    index.seed("source", right, stillBlocked);
+    EXPECT_LT(stillBlocked.minScale, stillBlocked.placeFeature(overlapping));
+
+    index.remove("source", left, 1);
+    CollisionTile unblocked(PlacementConfig {});
+    index.seed("source", right, unblocked);
+    EXPECT_EQ(unblocked.minScale, unblocked.placeFeature(overlapping));
+}
+
+TEST(EdgeCollisionIndex, Precedence) {
+    EdgeCollisionIndex index;
+    const TileID left(10, 100, 200, 10);
+    const TileID right(10, 101, 200, 10);
+
+    // The right tile is placed first, and keeps its label at the left edge.
+    CollisionTile rightTile(PlacementConfig {});
+    index.seed("source", right, rightTile);
+    auto rightLabel = label(10, 2000);
+    rightTile.insertFeature(rightLabel, rightTile.placeFeature(rightLabel));
+    index.publish("source", right, 2, rightTile);
+
+    // The left tile takes precedence anyway, so it keeps its overlapping label, too. Once the
+    // right tile is placed again, it hides its label, and it stays hidden from then on.
+    auto leftLabel = label(4090, 2000);
+    for (int i = 0; i < 2; i++) {
+        CollisionTile leftTile(PlacementConfig {});
+        index.seed("source", left, leftTile);
+        EXPECT_EQ(leftTile.minScale, leftTile.placeFeature(leftLabel));
+        leftTile.insertFeature(leftLabel, leftTile.placeFeature(leftLabel));
+        index.publish("source", left, 1, leftTile);
+
+        CollisionTile placedAgain(PlacementConfig {});
+        index.seed("source", right, placedAgain);
+        EXPECT_LT(placedAgain.minScale, placedAgain.placeFeature(rightLabel));
+        index.publish("source", right, 2, placedAgain);
+    }
+}
+
+TEST(EdgeCollisionIndex, Antimeridian) {
+    EdgeCollisionIndex index;
+    const TileID east(10, 1023, 200, 10);
+    const TileID west(10, 0, 200, 10);
+
+    CollisionTile westTile(PlacementConfig {});
+    index.seed("source", west, westTile);
+    auto westLabel = label(10, 2000);
+    westTile.insertFeature(westLabel, westTile.placeFeature(westLabel));
+    index.publish("source", west, 1, westTile);
+
+    // The tile at the western end of the world comes first, and is east of the other one.
+    CollisionTile eastTile(PlacementConfig {});
+    index.seed("source", east, eastTile);
+    auto eastLabel = label(4090, 2000);
+    EXPECT_LT(eastTile.minScale, eastTile.placeFeature(eastLabel));
+}
+
+TEST(EdgeCollisionIndex, PlacedBeforeNeighbour) {
+    EdgeCollisionIndex index;
+    const TileID left(10, 100, 200, 10);
+    const TileID right(10, 101, 200, 10);
+
+    // The right tile finishes loading first, and keeps its label at the left edge.
+    CollisionTile rightTile(PlacementConfig {});
+    const uint64_t seeded = index.seed("source", right, rightTile);
+    auto rightLabel = label(10, 2000);
+    rightTile.insertFeature(rightLabel, rightTile.placeFeature(rightLabel));
+    index.publish("source", right, 2, rightTile);
+    EXPECT_FALSE(index.isStale("source", right, seeded));
+
+    // Once the left tile publishes its overlapping label, the right tile has to be placed again.
+    CollisionTile leftTile(PlacementConfig {});
+    index.seed("source", left, leftTile);
+    auto leftLabel = label(4090, 2000);
+    leftTile.insertFeature(leftLabel, leftTile.placeFeature(leftLabel));
+    index.publish("source", left, 1, leftTile);
+
+    const auto dependents = EdgeCollisionIndex::dependents(left);
+    EXPECT_NE(dependents.end(), std::find(dependents.begin(), dependents.end(), right));
+    EXPECT_TRUE(index.isStale("source", right, seeded));
+
+    // Tiles that don't avoid the left tile aren't affected.
+    EXPECT_FALSE(index.isStale("source", TileID(10, 99, 200, 10), seeded));
+    EXPECT_FALSE(index.isStale("source", TileID(10, 100, 199, 10), seeded));
+
+    // Placed again, the right tile hides its label, and is current.
+    CollisionTile placedAgain(PlacementConfig {});
+    const uint64_t reseeded = index.seed("source", right, placedAgain);
+    EXPECT_LT(placedAgain.minScale, placedAgain.placeFeature(rightLabel));
+    index.publish("source", right, 2, placedAgain);
+    EXPECT_FALSE(index.isStale("source", right, reseeded));
+}
+
+TEST(EdgeCollisionIndex, Dependents) {
+    // The tile to the right and the three below.
+    EXPECT_EQ((std::vector<TileID> {
+        TileID(10, 101, 200, 10),
+        TileID(10, 99, 201, 10), TileID(10, 100, 201, 10), TileID(10, 101, 201, 10),
+    }), EdgeCollisionIndex::dependents(TileID(10, 100, 200, 10)));
+
+    // Across the antimeridian, the tile at the western end of the world comes first, so the one at
+    // the eastern end only has the three below it.
+    EXPECT_EQ((std::vector<TileID> {
+        TileID(10, 1022, 201, 10), TileID(10, 1023, 201, 10), TileID(10, 0, 201, 10),
+    }), EdgeCollisionIndex::dependents(TileID(10, 1023, 200, 10)));
+    EXPECT_EQ((std::vector<TileID> {
+        TileID(10, 1023, 200, 10), TileID(10, 1, 200, 10),
+        TileID(10, 1023, 201, 10), TileID(10, 0, 201, 10), TileID(10, 1, 201, 10),
+    }), EdgeCollisionIndex::dependents(TileID(10, 0, 200, 10)));
+
+    // Tiles in the bottom row only have the one to their right.
+    EXPECT_EQ((std::vector<TileID> { TileID(10, 101, 1023, 10) }),
+              EdgeCollisionIndex::dependents(TileID(10, 100, 1023, 10)));
+}
@@ -0,0 +1,94 @@
+#include "../fixtures/fixture_log_observer.hpp"
+#include "../fixtures/util.hpp"
+
+#include <mbgl/geometry/glyph_atlas.hpp>
+#include <mbgl/text/font_stack.hpp>
+#include <mbgl/util/thread.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// Glyphs of 10×10 pixels take up 20×20 pixels of the atlas, including the SDF buffer, the border
+// and the padding to a multiple of four.
+FontStack fontStack(const std::u32string& characters) {
+    FontStack stack;
+    for (const char32_t character : characters) {
+        SDFGlyph glyph;
+        glyph.id = character;
+        glyph.metrics.width = 10;
+        glyph.metrics.height = 10;
+        glyph.metrics.advance = 10;
+        glyph.bitmap = std::string(16 * 16, char(character));
+        stack.insert(character, glyph);
+    }
+    return stack;
+}
+
+// The atlas must be destroyed on the Map thread.
+class GlyphAtlasThread {
+public:
+    void run() {
+        // Pages of 32×32 pixels have room for a single glyph.
+        GlyphAtlas atlas(32, 32, 2);
+        const FontStack stack = fontStack(U"abc");
+        const uintptr_t tile1 = 1;
+        const uintptr_t tile2 = 2;
+
+        GlyphPositions first;
+        atlas.addGlyphs(tile1, U"ab", "Test", stack, first);
+        EXPECT_EQ(0, first.at(U'a').page);
+        EXPECT_EQ(1, first.at(U'b').page);
+        EXPECT_EQ(2u, atlas.getStatistics().pages);
+
+        // There is no room for another page, and no glyph to evict.
+        {
+            FixtureLog log;
+            GlyphPositions overflow;
+            atlas.addGlyphs(tile2, U"c", "Test", stack, overflow);
+            EXPECT_FALSE(overflow.at(U'c').rect.hasArea());
+            EXPECT_EQ(1u, atlas.getStatistics().overflows);
+            EXPECT_EQ(1u, log.count({ EventSeverity::Error, Event::OpenGL, int64_t(-1), "glyph bitmap overflow" }));
+        }
+
+        // Glyphs that no tile uses stay in the atlas.
+        atlas.removeGlyphs(tile1);
+        EXPECT_EQ(2u, atlas.getStatistics().glyphs);
+        EXPECT_EQ(2u, atlas.getStatistics().unusedGlyphs);
+
+        GlyphPositions second;
+        atlas.addGlyphs(tile2, U"a", "Test", stack, second);
+        EXPECT_EQ(0, second.at(U'a').page);
+        EXPECT_TRUE(second.at(U'a').rect == first.at(U'a').rect);
+        EXPECT_EQ(1u, atlas.getStatistics().unusedGlyphs);
+
+        // Makes room by evicting the glyph that was unused for the longest time.
+        atlas.addGlyphs(tile2, U"c", "Test", stack, second);
+        EXPECT_EQ(1, second.at(U'c').page);
+        EXPECT_TRUE(second.at(U'c').rect.hasArea());
+
+        const auto statistics = atlas.getStatistics();
+        EXPECT_EQ(2u, statistics.pages);
+        EXPECT_EQ(2u, statistics.glyphs);
+        EXPECT_EQ(0u, statistics.unusedGlyphs);
+        EXPECT_EQ(1u, statistics.evictions);
+
+        // "b" was evicted, and there is no room to add it again.
+        {
+            FixtureLog log;
+            GlyphPositions third;
+            atlas.addGlyphs(tile1, U"b", "Test", stack, third);
+            EXPECT_FALSE(third.at(U'b').rect.hasArea());
+            EXPECT_EQ(2u, atlas.getStatistics().overflows);
+            EXPECT_EQ(1u, log.count({ EventSeverity::Error, Event::OpenGL, int64_t(-1), "glyph bitmap overflow" }));
+        }
+    }
+};
+
+} // namespace
+
+TEST(GlyphAtlas, EvictionAndPages) {
+    const util::ThreadContext context = { "Map", util::ThreadType::Map, util::ThreadPriority::Regular };
+    util::Thread<GlyphAtlasThread> thread(context);
+    thread.invokeSync(&GlyphAtlasThread::run);
+}
@@ -0,0 +1,97 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/annotation/point_cluster_index.hpp>
+#include <mbgl/map/tile_id.hpp>
+
+#include <random>
+
+using namespace mbgl;
+
+TEST(PointClusterIndex, Clusters) {
+    PointClusterIndex index;
+    index.insert({ 10, 10 });
+    index.insert({ 11, 11 });
+    index.insert({ -40, -100 });
+
+    // The two points in the north east are in the same cell at z0.
+    auto clusters = index.getClusters(TileID(0, 0, 0, 0));
+    ASSERT_EQ(2u, clusters.size());
+    EXPECT_EQ(2u, clusters[0].count);
+    EXPECT_EQ(1u, clusters[1].count);
+    EXPECT_TRUE(clusters[0].contains({ 10, 10 }));
+    EXPECT_TRUE(clusters[0].contains({ 11, 11 }));
+    EXPECT_FALSE(clusters[0].contains({ -40, -100 }));
+    EXPECT_TRUE(clusters[1].bounds().contains({ -40, -100 }));
+
+    const PrecisionPoint a = LatLng(10, 10).project();
+    const PrecisionPoint b = LatLng(11, 11).project();
+    EXPECT_DOUBLE_EQ((a.x + b.x) / 2, clusters[0].center.x);
+    EXPECT_DOUBLE_EQ((a.y + b.y) / 2, clusters[0].center.y);
+
+    // They are apart at the maximum zoom level.
+    EXPECT_EQ(1u, index.getClusters(TileID(12, 2161, 1933, 12)).size());
+    EXPECT_EQ(1u, index.getClusters(TileID(12, 2173, 1922, 12)).size());
+
+    // There is no pyramid above the maximum zoom level, or outside of the world.
+    EXPECT_TRUE(index.getClusters(TileID(13, 4323, 3867, 13)).empty());
+    EXPECT_TRUE(index.getClusters(TileID(1, -1, 0, 1)).empty());
+
+    index.remove({ 11, 11 });
+    clusters = index.getClusters(TileID(0, 0, 0, 0));
+    ASSERT_EQ(2u, clusters.size());
+    EXPECT_EQ(1u, clusters[0].count);
+    EXPECT_NEAR(a.x, clusters[0].center.x, 1e-12);
+    EXPECT_NEAR(a.y, clusters[0].center.y, 1e-12);
+
+    // Points that aren't in the index are ignored.
+    index.remove({ 11, 11 });
+    EXPECT_EQ(2u, index.getStatistics().points);
+    EXPECT_EQ(2u * 13, index.getStatistics().cells);
+}
+
+TEST(PointClusterIndex, LoadAndInsert) {
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> latitude(-60, 60);
+    std::uniform_real_distribution<double> longitude(-180, 180);
+
+    std::vector<LatLng> positions;
+    for (int i = 0; i < 1000; i++) {
+        positions.emplace_back(latitude(generator), longitude(generator));
+    }
+
+    PointClusterIndex loaded(8);
+    loaded.load(positions);
+
+    PointClusterIndex inserted(8);
+    for (const auto& position : positions) {
+        inserted.insert(position);
+    }
+
+    EXPECT_EQ(1000u, loaded.getStatistics().points);
+    EXPECT_EQ(loaded.getStatistics().cells, inserted.getStatistics().cells);
+
+    for (const auto& tile : { TileID(0, 0, 0, 0), TileID(2, 1, 1, 2), TileID(8, 100, 120, 8) }) {
+        const auto expected = loaded.getClusters(tile);
+        const auto actual = inserted.getClusters(tile);
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); i++) {
+            EXPECT_EQ(expected[i].x, actual[i].x);
+            EXPECT_EQ(expected[i].y, actual[i].y);
+            EXPECT_EQ(expected[i].count, actual[i].count);
+            EXPECT_NEAR(expected[i].center.x, actual[i].center.x, 1e-12);
+            EXPECT_NEAR(expected[i].center.y, actual[i].center.y, 1e-12);
+        }
+    }
+
+    std::size_t total = 0;
+    for (const auto& cluster : loaded.getClusters(TileID(0, 0, 0, 0))) {
+        total += cluster.count;
+    }
+    EXPECT_EQ(1000u, total);
+
+    for (const auto& position : positions) {
+        loaded.remove(position);
+    }
+    EXPECT_EQ(0u, loaded.getStatistics().points);
+    EXPECT_EQ(0u, loaded.getStatistics().cells);
+}
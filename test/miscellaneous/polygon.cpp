@@ -0,0 +1,123 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/util/polygon.hpp>
+
+#include <cmath>
+
+using namespace mbgl;
+
+namespace {
+
+using Ring = std::vector<Coordinate>;
+
+double triangleArea(const Coordinate& a, const Coordinate& b, const Coordinate& c) {
+    return std::abs(double(b.x - a.x) * (c.y - a.y) - double(b.y - a.y) * (c.x - a.x)) / 2;
+}
+
+double ringArea(const Ring& ring) {
+    double area = 0;
+    for (std::size_t i = 0; i < ring.size(); i++) {
+        const Coordinate& a = ring[i];
+        const Coordinate& b = ring[(i + 1) % ring.size()];
+        area += double(a.x) * b.y - double(b.x) * a.y;
+    }
+    return std::abs(area) / 2;
+}
+
+// The triangles of a simple ring cover it exactly when their areas add up to the area of the ring.
+double coveredArea(const Ring& ring, const std::vector<uint16_t>& triangles) {
+    double area = 0;
+    for (std::size_t i = 0; i < triangles.size(); i += 3) {
+        area += triangleArea(ring[triangles[i]], ring[triangles[i + 1]], ring[triangles[i + 2]]);
+    }
+    return area;
+}
+
+} // namespace
+
+TEST(Polygon, SimplifyRing) {
+    Ring result;
+
+    // Closing, repeated and collinear vertices are dropped.
+    util::simplifyRing({ { 0, 0 }, { 5, 0 }, { 10, 0 }, { 10, 0 }, { 10, 10 }, { 0, 10 }, { 0, 0 } }, 0, result);
+    EXPECT_EQ((Ring { { 0, 0 }, { 10, 0 }, { 10, 10 }, { 0, 10 } }), result);
+
+    // Vertices close to the outline are only dropped with a tolerance.
+    const Ring bumpy { { 0, 0 }, { 50, 1 }, { 100, 0 }, { 100, 100 }, { 0, 100 } };
+    util::simplifyRing(bumpy, 0, result);
+    EXPECT_EQ(bumpy, result);
+    util::simplifyRing(bumpy, 1, result);
+    EXPECT_EQ((Ring { { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 } }), result);
+
+    // Many vertices in a row only get dropped if none of them is too far off.
+    util::simplifyRing({ { 0, 0 }, { 10, 1 }, { 20, 2 }, { 30, 1 }, { 40, 0 }, { 40, 40 } }, 1, result);
+    EXPECT_EQ((Ring { { 0, 0 }, { 20, 2 }, { 40, 0 }, { 40, 40 } }), result);
+
+    // Rings without area end up with less than three vertices.
+    util::simplifyRing({ { 0, 0 }, { 10, 0 }, { 20, 0 }, { 10, 0 } }, 0, result);
+    EXPECT_GT(3u, result.size());
+}
+
+TEST(Polygon, TriangulateConvexRing) {
+    const Ring square { { 0, 0 }, { 10, 0 }, { 10, 10 }, { 0, 10 } };
+    std::vector<uint16_t> triangles;
+    ASSERT_TRUE(util::triangulateSimpleRing(square, triangles));
+    EXPECT_EQ((std::vector<uint16_t> { 0, 1, 2, 0, 2, 3 }), triangles);
+
+    // Indices are appended.
+    ASSERT_TRUE(util::triangulateSimpleRing({ { 0, 0 }, { 0, 10 }, { 10, 0 } }, triangles));
+    EXPECT_EQ(9u, triangles.size());
+}
+
+TEST(Polygon, TriangulateConcaveRing) {
+    const std::vector<Ring> rings {
+        // An L-shaped building, clockwise.
+        { { 0, 0 }, { 0, 20 }, { 10, 20 }, { 10, 10 }, { 20, 10 }, { 20, 0 } },
+        // A U shape with a straight vertex.
+        { { 0, 0 }, { 30, 0 }, { 30, 30 }, { 20, 30 }, { 20, 10 }, { 10, 10 }, { 10, 30 }, { 0, 30 }, { 0, 15 } },
+    };
+
+    for (const auto& ring : rings) {
+        std::vector<uint16_t> triangles;
+        ASSERT_TRUE(util::triangulateSimpleRing(ring, triangles));
+        EXPECT_EQ((ring.size() - 2) * 3, triangles.size());
+        EXPECT_DOUBLE_EQ(ringArea(ring), coveredArea(ring, triangles));
+    }
+
+    // A star with many spikes.
+    Ring star;
+    for (int i = 0; i < 64; i++) {
+        const double radius = i % 2 ? 1000 : 400;
+        const double angle = i * M_PI / 32;
+        star.emplace_back(int16_t(std::round(radius * std::cos(angle))), int16_t(std::round(radius * std::sin(angle))));
+    }
+    std::vector<uint16_t> triangles;
+    ASSERT_TRUE(util::triangulateSimpleRing(star, triangles));
+    EXPECT_DOUBLE_EQ(ringArea(star), coveredArea(star, triangles));
+}
+
+TEST(Polygon, RejectComplexRings) {
+    std::vector<uint16_t> triangles;
+
+    // A bow tie.
+    EXPECT_FALSE(util::triangulateSimpleRing({ { 0, 0 }, { 10, 10 }, { 10, 0 }, { 0, 10 } }, triangles));
+
+    // A pentagram, which turns in the same direction everywhere.
+    EXPECT_FALSE(util::triangulateSimpleRing({ { 0, 10 }, { 6, -8 }, { -10, 3 }, { 10, 3 }, { -6, -8 } }, triangles));
+
+    // Rings that touch themselves.
+    EXPECT_FALSE(util::triangulateSimpleRing({ { 0, 0 }, { 20, 0 }, { 20, 20 }, { 10, 0 }, { 0, 20 } }, triangles));
+    EXPECT_FALSE(util::triangulateSimpleRing({ { 0, 0 }, { 20, 0 }, { 10, 0 }, { 10, 10 } }, triangles));
+
+    // Rings without area.
+    EXPECT_FALSE(util::triangulateSimpleRing({ { 0, 0 }, { 10, 0 }, { 20, 0 } }, triangles));
+
+    // Large rings.
+    Ring circle;
+    for (int i = 0; i < 1000; i++) {
+        circle.emplace_back(int16_t(std::round(1000 * std::cos(i * M_PI / 500))), int16_t(std::round(1000 * std::sin(i * M_PI / 500))));
+    }
+    EXPECT_FALSE(util::triangulateSimpleRing(circle, triangles));
+
+    EXPECT_TRUE(triangles.empty());
+}
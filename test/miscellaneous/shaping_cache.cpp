@@ -0,0 +1,111 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/text/font_stack.hpp>
+#include <mbgl/text/shaping_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// A font stack with glyphs of the given advance for the given characters.
+FontStack fontStack(const std::u32string& characters, uint32_t advance) {
+    FontStack stack;
+    for (const char32_t character : characters) {
+        SDFGlyph glyph;
+        glyph.id = character;
+        glyph.metrics.width = advance;
+        glyph.metrics.height = 20;
+        glyph.metrics.advance = advance;
+        stack.insert(character, glyph);
+    }
+    return stack;
+}
+
+ShapingCache::Key key(const std::u32string& text) {
+    return { "Open Sans Regular", text, 240, 28.8, 0.5, 0.5, 0.5, 0, { 0, 0 } };
+}
+
+} // namespace
+
+TEST(ShapingCache, MatchesFontStack) {
+    const FontStack stack = fontStack(U"Main Street", 10);
+    ShapingCache cache;
+
+    auto shaping = cache.get(key(U"Main Street"), stack);
+    const Shaping expected = stack.getShaping(U"Main Street", 240, 28.8, 0.5, 0.5, 0.5, 0, { 0, 0 });
+    ASSERT_EQ(expected.positionedGlyphs.size(), shaping->positionedGlyphs.size());
+    for (std::size_t i = 0; i < expected.positionedGlyphs.size(); i++) {
+        EXPECT_EQ(expected.positionedGlyphs[i].glyph, shaping->positionedGlyphs[i].glyph);
+        EXPECT_EQ(expected.positionedGlyphs[i].x, shaping->positionedGlyphs[i].x);
+        EXPECT_EQ(expected.positionedGlyphs[i].y, shaping->positionedGlyphs[i].y);
+    }
+    EXPECT_EQ(expected.top, shaping->top);
+    EXPECT_EQ(expected.bottom, shaping->bottom);
+    EXPECT_EQ(expected.left, shaping->left);
+    EXPECT_EQ(expected.right, shaping->right);
+}
+
+TEST(ShapingCache, Hits) {
+    const FontStack stack = fontStack(U"Main Street", 10);
+    ShapingCache cache;
+
+    auto first = cache.get(key(U"Main Street"), stack);
+    auto second = cache.get(key(U"Main Street"), stack);
+    EXPECT_EQ(first, second);
+
+    // Any difference in the layout properties shapes the text again.
+    auto wrapped = key(U"Main Street");
+    wrapped.maxWidth = 24;
+    auto third = cache.get(wrapped, stack);
+    EXPECT_NE(first, third);
+
+    auto otherFont = key(U"Main Street");
+    otherFont.fontStack = "Open Sans Bold";
+    auto fourth = cache.get(otherFont, stack);
+    EXPECT_NE(first, fourth);
+
+    const auto stats = cache.getStatistics();
+    EXPECT_EQ(3u, stats.entries);
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(3u, stats.misses);
+    EXPECT_EQ(0u, stats.evictions);
+}
+
+TEST(ShapingCache, EvictsLeastRecentlyUsed) {
+    const FontStack stack = fontStack(U"123", 10);
+    ShapingCache cache(2);
+
+    auto one = cache.get(key(U"1"), stack);
+    auto two = cache.get(key(U"2"), stack);
+    EXPECT_EQ(one, cache.get(key(U"1"), stack));
+
+    // "2" was used least recently.
+    cache.get(key(U"3"), stack);
+    EXPECT_EQ(1u, cache.getStatistics().evictions);
+    EXPECT_EQ(2u, cache.getStatistics().entries);
+    EXPECT_EQ(one, cache.get(key(U"1"), stack));
+    EXPECT_NE(two, cache.get(key(U"2"), stack));
+
+    // Evicted shapings stay valid while they are in use.
+    EXPECT_EQ(1u, two->positionedGlyphs.size());
+}
+
+TEST(ShapingCache, Clear) {
+    FontStack stack = fontStack(U"ab", 10);
+    ShapingCache cache;
+
+    auto before = cache.get(key(U"abc"), stack);
+    EXPECT_EQ(2u, before->positionedGlyphs.size());
+
+    // Text is shaped again once glyphs were added.
+    SDFGlyph glyph;
+    glyph.id = U'c';
+    glyph.metrics.advance = 10;
+    stack.insert(glyph.id, glyph);
+    cache.clear();
+
+    auto after = cache.get(key(U"abc"), stack);
+    EXPECT_EQ(3u, after->positionedGlyphs.size());
+    EXPECT_EQ(1u, cache.getStatistics().entries);
+    EXPECT_EQ(2u, cache.getStatistics().misses);
+}
@@ -0,0 +1,102 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/map/tile_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+class StubTileData : public TileData {
+public:
+    StubTileData(const TileID& id_, std::size_t bytes_) : TileData(id_), bytes(bytes_) {
+        state = State::parsed;
+    }
+
+    void cancel() override {}
+    Bucket* getBucket(const StyleLayer&) override { return nullptr; }
+    std::size_t getMemoryUsage() const override { return bytes; }
+
+private:
+    const std::size_t bytes;
+};
+
+std::shared_ptr<TileData> tile(int8_t z, std::size_t bytes) {
+    return std::make_shared<StubTileData>(TileID(z, 0, 0, z), bytes);
+}
+
+// Every cached tile also accounts for a fixed amount of bookkeeping.
+const std::size_t overhead = 4096;
+
+} // namespace
+
+TEST(TileCache, ByteBudget) {
+    TileCache cache(4 * overhead + 300 * 1024);
+
+    // A large tile takes up as much room as many small ones.
+    cache.add("vector", 1, tile(10, 100 * 1024));
+    cache.add("raster", 1, tile(10, 200 * 1024));
+    cache.add("vector", 2, tile(10, 0));
+    EXPECT_EQ(3u, cache.getStatistics().tiles);
+    EXPECT_EQ(3 * overhead + 300 * 1024, cache.getStatistics().size);
+
+    // Tiles of different sources don't collide.
+    EXPECT_TRUE(cache.has("vector", 1));
+    EXPECT_TRUE(cache.has("raster", 1));
+    EXPECT_FALSE(cache.has("raster", 2));
+
+    // Evicts the least recently used tile to make room.
+    cache.add("vector", 3, tile(10, 1024));
+    EXPECT_FALSE(cache.has("vector", 1));
+    EXPECT_TRUE(cache.has("raster", 1));
+
+    // Tiles that don't fit at all are not cached.
+    cache.add("raster", 2, tile(10, 1024 * 1024));
+    EXPECT_FALSE(cache.has("raster", 2));
+
+    EXPECT_NE(nullptr, cache.get("raster", 1));
+    EXPECT_EQ(nullptr, cache.get("raster", 1));
+
+    const TileCache::Statistics statistics = cache.getStatistics();
+    EXPECT_EQ(2u, statistics.tiles);
+    EXPECT_EQ(2 * overhead + 1024, statistics.size);
+    EXPECT_EQ(1u, statistics.hits);
+    EXPECT_EQ(1u, statistics.misses);
+    EXPECT_EQ(1u, statistics.evictions);
+    EXPECT_EQ(overhead + 100 * 1024, statistics.evictedBytes);
+}
+
+TEST(TileCache, EvictsDistantZoomLevelsFirst) {
+    TileCache cache(4 * overhead);
+    cache.setZoom(12);
+
+    cache.add("vector", 1, tile(12, 0));
+    cache.add("vector", 2, tile(8, 0));
+    cache.add("vector", 3, tile(11, 0));
+    cache.add("vector", 4, tile(14, 0));
+
+    // The tile at z8 is furthest away from the current zoom level.
+    cache.add("vector", 5, tile(12, 0));
+    EXPECT_FALSE(cache.has("vector", 2));
+
+    // z11 and z14 are next, even though the z12 tile was used less recently.
+    cache.add("vector", 6, tile(12, 0));
+    EXPECT_FALSE(cache.has("vector", 4));
+    cache.add("vector", 7, tile(12, 0));
+    EXPECT_FALSE(cache.has("vector", 3));
+    EXPECT_TRUE(cache.has("vector", 1));
+
+    // Within the same zoom level, the least recently used tile goes first.
+    cache.add("vector", 8, tile(12, 0));
+    EXPECT_FALSE(cache.has("vector", 1));
+    EXPECT_TRUE(cache.has("vector", 5));
+
+    // Shrinking the cache evicts right away.
+    cache.setSize(2 * overhead);
+    EXPECT_EQ(2u, cache.getStatistics().tiles);
+    EXPECT_TRUE(cache.has("vector", 7));
+    EXPECT_TRUE(cache.has("vector", 8));
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.getStatistics().tiles);
+    EXPECT_EQ(0u, cache.getStatistics().size);
+}
@@ -177,3 +177,30 @@ TEST(Transform, ConstrainWidthAndHeight) {
     ASSERT_NEAR(85.021422866378742, loc.latitude, 0.0001);
     ASSERT_NEAR(179.65667724609358, std::abs(loc.longitude), 0.0001);
 }
+
+TEST(Transform, TransitionPath) {
+    MockView view;
+    Transform transform(view, ConstrainMode::HeightOnly);
+    transform.resize({{ 1000, 1000 }});
+    transform.setLatLngZoom({ 0, 0 }, 10);
+
+    EXPECT_TRUE(transform.getTransitionPath(4).empty());
+
+    transform.setLatLngZoom({ 10, 20 }, 14, std::chrono::seconds(10));
+
+    const std::vector<TransformState> path = transform.getTransitionPath(4);
+    ASSERT_EQ(4u, path.size());
+
+    // The camera has barely moved, but the last sample is the destination.
+    EXPECT_NEAR(10, transform.getZoom(), 0.01);
+    EXPECT_NEAR(14, path.back().getZoom(), 0.0001);
+    EXPECT_NEAR(10, path.back().getLatLng().latitude, 0.0001);
+    EXPECT_NEAR(20, path.back().getLatLng().longitude, 0.0001);
+
+    for (std::size_t i = 1; i < path.size(); i++) {
+        EXPECT_LT(path[i - 1].getZoom(), path[i].getZoom());
+    }
+
+    transform.cancelTransitions();
+    EXPECT_TRUE(transform.getTransitionPath(4).empty());
+}
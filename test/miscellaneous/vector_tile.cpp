@@ -0,0 +1,139 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/map/vector_tile.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+TEST(VectorTile, EachFeature) {
+    VectorTile tile(std::make_shared<std::string>(
+        util::read_file("test/fixtures/tiles/streets/15-17605-10749.vector.pbf")));
+
+    for (const auto& name : { "landuse", "road", "building", "poi_label" }) {
+        auto layer = tile.getLayer(name);
+        ASSERT_TRUE(layer.get());
+
+        GeometryCollection buffer;
+        std::size_t i = 0;
+        layer->eachFeature([&] (const GeometryTileFeature& feature) {
+            ASSERT_LT(i, layer->featureCount());
+            auto expected = layer->getFeature(i++);
+
+            EXPECT_EQ(expected->getType(), feature.getType());
+            EXPECT_EQ(expected->getGeometries(), feature.readGeometries(buffer));
+            EXPECT_EQ(expected->getGeometries(), buffer);
+
+            for (const auto& key : { "class", "type", "name" }) {
+                auto value = expected->getValue(key);
+                auto actual = feature.getValue(key);
+                ASSERT_EQ(bool(value), bool(actual));
+                if (value) {
+                    EXPECT_EQ(*value, *actual);
+                }
+            }
+        });
+
+        EXPECT_EQ(layer->featureCount(), i);
+    }
+}
+
+TEST(VectorTile, InternedKeyFilter) {
+    VectorTile tile(std::make_shared<std::string>(
+        util::read_file("test/fixtures/tiles/streets/15-17605-10749.vector.pbf")));
+
+    auto layer = tile.getLayer("road");
+    ASSERT_TRUE(layer.get());
+    ASSERT_TRUE(layer->hasKeyIDs());
+    EXPECT_TRUE(bool(layer->getKeyID("class")));
+    EXPECT_FALSE(bool(layer->getKeyID("missing")));
+
+    const std::vector<FilterExpression> filters = {
+        EqualsExpression { "class", std::string("street") },
+        NotEqualsExpression { "class", std::string("street") },
+        InExpression { "class", { std::string("main"), std::string("motorway") } },
+        NotInExpression { "missing", { std::string("main") } },
+        EqualsExpression { "$type", uint64_t(FeatureType::LineString) },
+        AllExpression { { EqualsExpression { "$type", uint64_t(FeatureType::LineString) },
+                          GreaterThanExpression { "osm_id", int64_t(0) } } },
+    };
+
+    for (const auto& filter : filters) {
+        const CompiledFilter compiled(filter);
+        GeometryTileLayerFilter layerFilter(*layer, compiled);
+        layer->eachFeature([&] (const GeometryTileFeature& feature) {
+            EXPECT_EQ(evaluate(filter, GeometryTileFeatureExtractor(feature)), layerFilter(feature));
+        });
+    }
+}
+
+TEST(VectorTile, EveryFeatureStops) {
+    VectorTile tile(std::make_shared<std::string>(
+        util::read_file("test/fixtures/tiles/streets/15-17605-10749.vector.pbf")));
+
+    auto layer = tile.getLayer("road");
+    ASSERT_TRUE(layer.get());
+    ASSERT_LT(3u, layer->featureCount());
+
+    std::size_t visited = 0;
+    EXPECT_FALSE(layer->everyFeature([&] (const GeometryTileFeature&) {
+        return ++visited < 3;
+    }));
+    EXPECT_EQ(3u, visited);
+
+    visited = 0;
+    EXPECT_TRUE(layer->everyFeature([&] (const GeometryTileFeature&) {
+        visited++;
+        return true;
+    }));
+    EXPECT_EQ(layer->featureCount(), visited);
+}
+
+TEST(VectorTile, InternedValues) {
+    VectorTile tile(std::make_shared<std::string>(
+        util::read_file("test/fixtures/tiles/streets/15-17605-10749.vector.pbf")));
+
+    auto layer = tile.getLayer("road");
+    ASSERT_TRUE(layer.get());
+
+    std::size_t properties = 0;
+    layer->eachFeature([&] (const GeometryTileFeature& feature) {
+        // Properties come in ascending order of key IDs, and every one of them can be looked up.
+        uint32_t previous = 0;
+        bool first = true;
+        feature.eachInternedValue([&] (uint32_t keyID, const Value& value) {
+            EXPECT_TRUE(first || previous < keyID);
+            EXPECT_EQ(&value, feature.getInternedValue(keyID));
+            previous = keyID;
+            first = false;
+            properties++;
+        });
+    });
+    EXPECT_LT(0u, properties);
+}
+
+TEST(VectorTile, InternedValueLookup) {
+    VectorTile tile(std::make_shared<std::string>(
+        util::read_file("test/fixtures/tiles/streets/15-17605-10749.vector.pbf")));
+
+    auto layer = tile.getLayer("road");
+    ASSERT_TRUE(layer.get());
+
+    const std::vector<std::string> keys = { "class", "oneway", "osm_id", "missing" };
+
+    std::size_t found = 0;
+    layer->eachFeature([&] (const GeometryTileFeature& feature) {
+        // Looking up a value by key ID finds the same value as looking it up by key.
+        for (const auto& key : keys) {
+            auto keyID = layer->getKeyID(key);
+            auto value = feature.getValue(key);
+            const Value* interned = keyID ? feature.getInternedValue(*keyID) : nullptr;
+            ASSERT_EQ(bool(value), bool(interned));
+            if (interned) {
+                EXPECT_TRUE(*value == *interned);
+                found++;
+            }
+        }
+    });
+    EXPECT_LT(0u, found);
+}
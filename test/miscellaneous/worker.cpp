@@ -0,0 +1,89 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/util/worker.hpp>
+#include <mbgl/util/work_request.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <future>
+
+using namespace mbgl;
+using namespace mbgl::util;
+
+TEST(Worker, ExecutesAfter) {
+    RunLoop loop(uv_default_loop());
+    Worker worker(2);
+
+    bool didWork = false;
+    bool didAfter = false;
+
+    auto request = worker.invoke(WorkPriority(), [&] {
+        didWork = true;
+    }, [&] {
+        EXPECT_TRUE(ThreadContext::currentlyOn(ThreadType::Main));
+        didAfter = true;
+        loop.stop();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    EXPECT_TRUE(didWork);
+    EXPECT_TRUE(didAfter);
+}
+
+TEST(Worker, Priority) {
+    RunLoop loop(uv_default_loop());
+    Worker worker(1);
+
+    // Occupy the only thread until all other jobs are queued.
+    std::promise<void> queued;
+    std::shared_future<void> queuedFuture = queued.get_future().share();
+    auto blocker = worker.invoke(WorkPriority(), [queuedFuture] { queuedFuture.wait(); }, [] {});
+
+    // Only the worker thread writes the order. The main thread counts the callbacks instead, and
+    // reads the order once all jobs are done.
+    std::vector<int> order;
+    std::size_t callbacks = 0;
+    std::vector<std::unique_ptr<WorkRequest>> requests;
+
+    auto push = [&] (WorkPriority priority, int id) {
+        requests.push_back(worker.invoke(priority, [&order, id] { order.push_back(id); }, [&] {
+            if (++callbacks == 6) {
+                loop.stop();
+            }
+        }));
+    };
+
+    push({ WorkPriority::Prefetch, 0 }, 5);
+    push({ WorkPriority::Placement, 3 }, 4);
+    push({ WorkPriority::Visible, 2 }, 2);
+    push({ WorkPriority::Placement, 1 }, 3);
+    push({ WorkPriority::Visible, 0 }, 0);
+    push({ WorkPriority::Visible, 0 }, 1);
+
+    queued.set_value();
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    EXPECT_EQ((std::vector<int> { 0, 1, 2, 3, 4, 5 }), order);
+}
+
+TEST(Worker, CancelledJobsAreDropped) {
+    RunLoop loop(uv_default_loop());
+    Worker worker(1);
+
+    std::promise<void> queued;
+    std::shared_future<void> queuedFuture = queued.get_future().share();
+    auto blocker = worker.invoke(WorkPriority(), [queuedFuture] { queuedFuture.wait(); }, [] {});
+
+    // Cancelled before it had a chance to run.
+    worker.invoke(WorkPriority(), [] { ADD_FAILURE(); }, [] { ADD_FAILURE(); });
+
+    auto request = worker.invoke({ WorkPriority::Prefetch, 0 }, [] {}, [&] { loop.stop(); });
+
+    queued.set_value();
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    // The cancelled job is dropped before the job with a lower priority starts running.
+    const Worker::Statistics statistics = worker.getStatistics();
+    EXPECT_EQ(0u, statistics.queued);
+    EXPECT_EQ(1u, statistics.dropped);
+}
@@ -183,3 +183,55 @@ TEST_F(Storage, CacheRevalidateEtag) {
 
     uv_run(uv_default_loop(), UV_RUN_DEFAULT);
 }
+
+TEST_F(Storage, CacheRevalidateMemoryCacheHit) {
+    SCOPED_TEST(CacheRevalidateMemoryCacheHit)
+
+    using namespace mbgl;
+
+    SQLiteCache cache(":memory:");
+    DefaultFileSource fs(&cache);
+    util::RunLoop loop(uv_default_loop());
+
+    // Expires after two seconds.
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/test?cachecontrol=max-age=2" };
+    std::unique_ptr<FileRequest> req1;
+    std::unique_ptr<FileRequest> req2;
+    int responses = 0;
+    req1 = fs.request(resource, [&](Response res) {
+        // Cancelling the request leaves the fresh response in memory.
+        req1.reset();
+        EXPECT_EQ(nullptr, res.error);
+        EXPECT_EQ(false, res.stale);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Hello World!", *res.data);
+
+        req2 = fs.request(resource, [&, res](Response res2) {
+            if (res2.stale) {
+                // Discard stale responses, if any.
+                return;
+            }
+
+            EXPECT_EQ(nullptr, res2.error);
+            ASSERT_TRUE(res2.data.get());
+            EXPECT_EQ("Hello World!", *res2.data);
+
+            if (++responses == 1) {
+                // The first response comes from memory.
+                EXPECT_EQ(res.data, res2.data);
+                EXPECT_EQ(res.expires, res2.expires);
+                EXPECT_EQ(1u, fs.getMemoryCacheStatistics().other.hits);
+                return;
+            }
+
+            // Once it expires, the response is revalidated without requesting it again.
+            EXPECT_LE(res.expires, res2.expires);
+
+            req2.reset();
+            loop.stop();
+            CacheRevalidateMemoryCacheHit.finish();
+        });
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
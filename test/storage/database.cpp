@@ -4,7 +4,9 @@
 #include "sqlite_cache_impl.hpp"
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/util/compression.hpp>
 #include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
 
 #include <sqlite3.h>
 
@@ -39,6 +41,14 @@ void deleteFile(const char* name) {
     } else {
         ASSERT_EQ(0, ret);
     }
+
+    // Databases in WAL mode consist of more than one file.
+    for (const auto suffix : { "-wal", "-shm" }) {
+        const std::string sidecar = std::string(name) + suffix;
+        if (unlink(sidecar.c_str()) == -1) {
+            ASSERT_EQ(ENOENT, errno);
+        }
+    }
 }
 
 
@@ -318,3 +328,378 @@ TEST_F(Storage, DatabaseInvalid) {
         EXPECT_EQ(1ul, flo->count({ EventSeverity::Warning, Event::Database, -1, "Trashing invalid database" }));
     }
 }
+
+// Returns data that the cache stores uncompressed, so that its size on disk is known.
+std::string incompressibleData(std::size_t size) {
+    std::string data(size, '\0');
+    uint32_t state = 1;
+    for (auto& c : data) {
+        state = state * 1103515245 + 12345;
+        c = char(state >> 24);
+    }
+    return data;
+}
+
+TEST_F(Storage, DatabaseEviction) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/eviction.db");
+
+    Log::setObserver(std::make_unique<FixtureLogObserver>());
+
+    SQLiteCache::Impl cache("test/fixtures/database/eviction.db");
+
+    // Every entry takes up exactly 1 KB.
+    auto response = std::make_shared<Response>();
+    response->data = std::make_shared<std::string>(incompressibleData(1024));
+
+    cache.put({ Resource::Style, "mapbox://style" }, response);
+    cache.put({ Resource::SpriteImage, "mapbox://sprite" }, response);
+    for (int i = 0; i < 8; i++) {
+        cache.put({ Resource::Tile, "mapbox://tile/" + std::to_string(i) }, response);
+    }
+    EXPECT_EQ(10 * 1024u, cache.getStatistics().size);
+
+    // Reading tile 0 makes tile 1 the least recently used one.
+    cache.get({ Resource::Tile, "mapbox://tile/0" }, [] (std::unique_ptr<Response> res) {
+        EXPECT_NE(nullptr, res.get());
+    });
+
+    // Evicts until the cache is at 90 % of its size: tiles go first, in order of their last access.
+    cache.setMaximumCacheSize(9 * 1024);
+    EXPECT_EQ(8 * 1024u, cache.getStatistics().size);
+    EXPECT_EQ(2 * 1024u, cache.getStatistics().evictedBytes);
+
+    auto expect = [&] (Resource resource, bool cached) {
+        cache.get(resource, [&] (std::unique_ptr<Response> res) {
+            EXPECT_EQ(cached, res != nullptr) << resource.url;
+        });
+    };
+
+    expect({ Resource::Tile, "mapbox://tile/0" }, true);
+    expect({ Resource::Tile, "mapbox://tile/1" }, false);
+    expect({ Resource::Tile, "mapbox://tile/2" }, false);
+    expect({ Resource::Tile, "mapbox://tile/3" }, true);
+
+    // Once all tiles are gone, other resources are evicted, and styles last.
+    cache.setMaximumCacheSize(2 * 1024);
+    expect({ Resource::Style, "mapbox://style" }, true);
+    expect({ Resource::SpriteImage, "mapbox://sprite" }, false);
+    expect({ Resource::Tile, "mapbox://tile/0" }, false);
+
+    const SQLiteCache::Statistics statistics = cache.getStatistics();
+    EXPECT_EQ(1024u, statistics.size);
+    EXPECT_EQ(9 * 1024u, statistics.evictedBytes);
+    EXPECT_EQ(4u, statistics.hits);
+    EXPECT_EQ(4u, statistics.misses);
+
+    auto observer = Log::removeObserver();
+    EXPECT_TRUE(dynamic_cast<FixtureLogObserver*>(observer.get())->empty());
+}
+
+TEST_F(Storage, DatabaseEvictionBatches) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/eviction.db");
+
+    Log::setObserver(std::make_unique<FixtureLogObserver>());
+
+    {
+        util::RunLoop loop(uv_default_loop());
+        SQLiteCache::Impl cache("test/fixtures/database/eviction.db");
+        cache.setMaximumCacheSize(10 * 1024);
+
+        // Every entry takes up exactly 1 KB.
+        auto response = std::make_shared<Response>();
+        response->data = std::make_shared<std::string>(incompressibleData(1024));
+
+        // A full write batch exceeds the maximum size by far more entries than are evicted in a
+        // single transaction.
+        for (int i = 0; i < 128; i++) {
+            cache.put({ Resource::Tile, "mapbox://tile/" + std::to_string(i) }, response);
+        }
+        EXPECT_EQ(9 * 1024u, cache.getStatistics().size);
+        EXPECT_EQ(119 * 1024u, cache.getStatistics().evictedBytes);
+
+        // Shrinking the maximum size evicts as many entries as necessary, too.
+        cache.setMaximumCacheSize(200 * 1024);
+        for (int i = 128; i < 256; i++) {
+            cache.put({ Resource::Tile, "mapbox://tile/" + std::to_string(i) }, response);
+        }
+        EXPECT_EQ(137 * 1024u, cache.getStatistics().size);
+
+        cache.setMaximumCacheSize(10 * 1024);
+        EXPECT_EQ(9 * 1024u, cache.getStatistics().size);
+        EXPECT_EQ(247 * 1024u, cache.getStatistics().evictedBytes);
+
+        // The most recently written entries are kept.
+        cache.get({ Resource::Tile, "mapbox://tile/255" }, [] (std::unique_ptr<Response> res) {
+            EXPECT_NE(nullptr, res.get());
+        });
+        cache.get({ Resource::Tile, "mapbox://tile/246" }, [] (std::unique_ptr<Response> res) {
+            EXPECT_EQ(nullptr, res.get());
+        });
+    }
+
+    auto observer = Log::removeObserver();
+    EXPECT_TRUE(dynamic_cast<FixtureLogObserver*>(observer.get())->empty());
+
+    deleteFile("test/fixtures/database/eviction.db");
+}
+
+TEST_F(Storage, DatabaseAccessTimesArePersisted) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/eviction.db");
+
+    auto response = std::make_shared<Response>();
+    response->data = std::make_shared<std::string>(incompressibleData(1024));
+
+    {
+        SQLiteCache::Impl cache("test/fixtures/database/eviction.db");
+        cache.put({ Resource::Tile, "mapbox://tile/0" }, response);
+        cache.put({ Resource::Tile, "mapbox://tile/1" }, response);
+        cache.get({ Resource::Tile, "mapbox://tile/0" }, [] (std::unique_ptr<Response>) {});
+    }
+
+    {
+        // The size and the order of accesses survive reopening the database.
+        SQLiteCache::Impl cache("test/fixtures/database/eviction.db");
+        cache.get({ Resource::Tile, "mapbox://tile/2" }, [] (std::unique_ptr<Response>) {});
+        EXPECT_EQ(2 * 1024u, cache.getStatistics().size);
+
+        cache.setMaximumCacheSize(1536);
+        cache.get({ Resource::Tile, "mapbox://tile/0" }, [] (std::unique_ptr<Response> res) {
+            EXPECT_NE(nullptr, res.get());
+        });
+        cache.get({ Resource::Tile, "mapbox://tile/1" }, [] (std::unique_ptr<Response> res) {
+            EXPECT_EQ(nullptr, res.get());
+        });
+    }
+
+    deleteFile("test/fixtures/database/eviction.db");
+}
+
+TEST_F(Storage, DatabaseWriteQueue) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/queue.db");
+
+    {
+        util::RunLoop loop(uv_default_loop());
+        SQLiteCache::Impl cache("test/fixtures/database/queue.db");
+
+        auto response = std::make_shared<Response>();
+        response->data = std::make_shared<std::string>(incompressibleData(1024));
+        response->expires = 1;
+        cache.put({ Resource::Tile, "mapbox://tile/0" }, response);
+        cache.refresh({ Resource::Tile, "mapbox://tile/0" }, 2);
+
+        // Queued writes are visible right away, but aren't committed yet.
+        cache.get({ Resource::Tile, "mapbox://tile/0" }, [] (std::unique_ptr<Response> res) {
+            ASSERT_NE(nullptr, res.get());
+            EXPECT_EQ(2, res->expires);
+        });
+        EXPECT_EQ(0u, cache.getStatistics().size);
+
+        // Wait for the queue to be committed.
+        uv_run(uv_default_loop(), UV_RUN_ONCE);
+        EXPECT_EQ(1024u, cache.getStatistics().size);
+
+        // Filling up a batch commits it right away.
+        for (int i = 1; i <= 128; i++) {
+            cache.put({ Resource::Tile, "mapbox://tile/" + std::to_string(i) }, response);
+        }
+        EXPECT_EQ(129 * 1024u, cache.getStatistics().size);
+    }
+
+    // Writes that are still queued are committed on shutdown.
+    {
+        util::RunLoop loop(uv_default_loop());
+        {
+            SQLiteCache::Impl cache("test/fixtures/database/queue.db");
+            auto response = std::make_shared<Response>();
+            response->data = std::make_shared<std::string>("Demo");
+            cache.put({ Resource::Tile, "mapbox://tile/pending" }, response);
+        }
+
+        SQLiteCache::Impl cache("test/fixtures/database/queue.db");
+        cache.get({ Resource::Tile, "mapbox://tile/pending" }, [] (std::unique_ptr<Response> res) {
+            ASSERT_NE(nullptr, res.get());
+            EXPECT_EQ("Demo", *res->data);
+        });
+    }
+
+    deleteFile("test/fixtures/database/queue.db");
+}
+
+TEST_F(Storage, DatabaseCompressedReads) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/compressed.db");
+
+    Log::setObserver(std::make_unique<FixtureLogObserver>());
+
+    std::string data;
+    for (int i = 0; i < 10000; i++) {
+        data += std::to_string(i);
+    }
+
+    {
+        SQLiteCache::Impl cache("test/fixtures/database/compressed.db");
+        auto response = std::make_shared<Response>();
+        response->data = std::make_shared<std::string>(data);
+        cache.put({ Resource::Tile, "mapbox://tile/compressed" }, response);
+        response->data = std::make_shared<std::string>(incompressibleData(1024));
+        cache.put({ Resource::Tile, "mapbox://tile/uncompressed" }, response);
+    }
+
+    SQLiteCache::Impl cache("test/fixtures/database/compressed.db");
+    cache.get({ Resource::Tile, "mapbox://tile/compressed" }, [&] (std::unique_ptr<Response> res) {
+        ASSERT_NE(nullptr, res.get());
+        EXPECT_EQ(data, *res->data);
+    });
+    cache.get({ Resource::Tile, "mapbox://tile/uncompressed" }, [&] (std::unique_ptr<Response> res) {
+        ASSERT_NE(nullptr, res.get());
+        EXPECT_EQ(incompressibleData(1024), *res->data);
+    });
+
+    // Responses are built directly from the stored data, without intermediate copies.
+    const SQLiteCache::Statistics statistics = cache.getStatistics();
+    EXPECT_EQ(statistics.size, statistics.bytesRead);
+    EXPECT_EQ(data.size() + 1024, statistics.bytesCopied);
+    EXPECT_LT(statistics.bytesRead, statistics.bytesCopied);
+
+    auto observer = Log::removeObserver();
+    EXPECT_TRUE(dynamic_cast<FixtureLogObserver*>(observer.get())->empty());
+
+    deleteFile("test/fixtures/database/compressed.db");
+}
+
+TEST_F(Storage, DatabaseMigration) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/migration.db");
+
+    std::string data;
+    for (int i = 0; i < 10000; i++) {
+        data += std::to_string(i);
+    }
+    const std::string compressed = util::compress(data);
+
+    {
+        // Creates a cache with the schema that predates size accounting.
+        sqlite3* db = nullptr;
+        ASSERT_EQ(SQLITE_OK, sqlite3_open_v2("test/fixtures/database/migration.db", &db, SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE, nullptr));
+        ASSERT_EQ(SQLITE_OK, sqlite3_exec(db,
+            "CREATE TABLE `http_cache` ("
+            "    `url` TEXT PRIMARY KEY NOT NULL,"
+            "    `status` INTEGER NOT NULL,"
+            "    `kind` INTEGER NOT NULL,"
+            "    `modified` INTEGER,"
+            "    `etag` TEXT,"
+            "    `expires` INTEGER,"
+            "    `data` BLOB,"
+            "    `compressed` INTEGER NOT NULL DEFAULT 0"
+            ");"
+            "CREATE INDEX `http_cache_kind_idx` ON `http_cache` (`kind`);", nullptr, nullptr, nullptr));
+
+        sqlite3_stmt* stmt = nullptr;
+        ASSERT_EQ(SQLITE_OK, sqlite3_prepare_v2(db, "INSERT INTO `http_cache` (`url`, `status`, `kind`, `data`, `compressed`) VALUES (?, 1, 3, ?, ?)", -1, &stmt, nullptr));
+        for (const auto& row : { std::make_pair("mapbox://tile/compressed", &compressed), std::make_pair("mapbox://tile/uncompressed", &data) }) {
+            sqlite3_reset(stmt);
+            sqlite3_bind_text(stmt, 1, row.first, -1, SQLITE_STATIC);
+            sqlite3_bind_blob(stmt, 2, row.second->data(), int(row.second->size()), SQLITE_STATIC);
+            sqlite3_bind_int(stmt, 3, row.second == &compressed);
+            ASSERT_EQ(SQLITE_DONE, sqlite3_step(stmt));
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+    }
+
+    Log::setObserver(std::make_unique<FixtureLogObserver>());
+
+    {
+        // Existing entries survive the upgrade and count towards the size of the cache.
+        SQLiteCache::Impl cache("test/fixtures/database/migration.db");
+        cache.get({ Resource::Tile, "mapbox://tile/compressed" }, [&] (std::unique_ptr<Response> res) {
+            ASSERT_NE(nullptr, res.get());
+            EXPECT_EQ(data, *res->data);
+        });
+        cache.get({ Resource::Tile, "mapbox://tile/uncompressed" }, [&] (std::unique_ptr<Response> res) {
+            ASSERT_NE(nullptr, res.get());
+            EXPECT_EQ(data, *res->data);
+        });
+        EXPECT_EQ(compressed.size() + data.size(), cache.getStatistics().size);
+    }
+
+    {
+        // The database is at the current version now and is opened as is.
+        SQLiteCache::Impl cache("test/fixtures/database/migration.db");
+        cache.get({ Resource::Tile, "mapbox://tile/compressed" }, [&] (std::unique_ptr<Response> res) {
+            ASSERT_NE(nullptr, res.get());
+            EXPECT_EQ(data, *res->data);
+        });
+        EXPECT_EQ(compressed.size() + data.size(), cache.getStatistics().size);
+    }
+
+    auto observer = Log::removeObserver();
+    EXPECT_TRUE(dynamic_cast<FixtureLogObserver*>(observer.get())->empty());
+
+    deleteFile("test/fixtures/database/migration.db");
+}
+
+TEST_F(Storage, DatabaseInvalidUncompressedSize) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/size.db");
+
+    std::string data;
+    for (int i = 0; i < 10000; i++) {
+        data += std::to_string(i);
+    }
+
+    {
+        SQLiteCache::Impl cache("test/fixtures/database/size.db");
+        auto response = std::make_shared<Response>();
+        response->data = std::make_shared<std::string>(data);
+        cache.put({ Resource::Tile, "mapbox://tile/huge" }, response);
+        cache.put({ Resource::Tile, "mapbox://tile/mismatch" }, response);
+    }
+
+    {
+        // Corrupts the stored sizes of the decompressed data.
+        sqlite3* db = nullptr;
+        ASSERT_EQ(SQLITE_OK, sqlite3_open_v2("test/fixtures/database/size.db", &db, SQLITE_OPEN_READWRITE, nullptr));
+        const std::string sql =
+            "UPDATE `http_cache` SET `uncompressed_size` = 1099511627776 WHERE `url` = 'mapbox://tile/huge';"
+            "UPDATE `http_cache` SET `uncompressed_size` = " + std::to_string(data.size() + 1) + " WHERE `url` = 'mapbox://tile/mismatch';";
+        ASSERT_EQ(SQLITE_OK, sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr));
+        sqlite3_close(db);
+    }
+
+    Log::setObserver(std::make_unique<FixtureLogObserver>());
+
+    // Entries with implausible sizes are cache misses, without allocating the claimed size.
+    SQLiteCache::Impl cache("test/fixtures/database/size.db");
+    cache.get({ Resource::Tile, "mapbox://tile/huge" }, [&] (std::unique_ptr<Response> res) {
+        EXPECT_EQ(nullptr, res.get());
+    });
+    cache.get({ Resource::Tile, "mapbox://tile/mismatch" }, [&] (std::unique_ptr<Response> res) {
+        EXPECT_EQ(nullptr, res.get());
+    });
+    EXPECT_EQ(0u, cache.getStatistics().hits);
+    EXPECT_EQ(2u, cache.getStatistics().misses);
+
+    auto observer = Log::removeObserver();
+    EXPECT_EQ(2ul, dynamic_cast<FixtureLogObserver*>(observer.get())->count({ EventSeverity::Warning, Event::Database, -1, "Ignoring cache entry with an invalid size" }));
+
+    deleteFile("test/fixtures/database/size.db");
+}
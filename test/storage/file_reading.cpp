@@ -66,6 +66,37 @@ TEST_F(Storage, AssetNonEmptyFile) {
     uv_run(uv_default_loop(), UV_RUN_DEFAULT);
 }
 
+TEST_F(Storage, AssetCompressedFile) {
+    SCOPED_TEST(CompressedFile)
+
+    using namespace mbgl;
+
+#ifdef MBGL_ASSET_ZIP
+    DefaultFileSource fs(nullptr, "test/fixtures/storage/assets.zip");
+#else
+    DefaultFileSource fs(nullptr);
+#endif
+
+    util::RunLoop loop(uv_default_loop());
+
+    std::unique_ptr<FileRequest> req = fs.request({ Resource::Unknown, "asset://TEST_DATA/fixtures/storage/compressible" }, [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        EXPECT_EQ(false, res.stale);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ(4022u, res.data->size());
+        EXPECT_EQ("line 0 of a file that is stored deflated in the asset archive\n", res.data->substr(0, 62));
+        EXPECT_EQ("line 63 of a file that is stored deflated in the asset archive\n", res.data->substr(3959));
+        EXPECT_EQ(0, res.expires);
+        EXPECT_LT(1420000000, res.modified);
+        EXPECT_NE("", res.etag);
+        loop.stop();
+        CompressedFile.finish();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
+
 TEST_F(Storage, AssetNonExistentFile) {
     SCOPED_TEST(NonExistentFile)
 
@@ -0,0 +1,65 @@
+#include "storage.hpp"
+
+#include <mbgl/util/uv_detail.hpp>
+
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <memory>
+#include <vector>
+
+TEST_F(Storage, HTTPPriority) {
+    SCOPED_TEST(HTTPPriority)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+    util::RunLoop loop(uv_default_loop());
+
+    // Fails the test instead of blocking the test suite if a request never completes.
+    uv::timer timeout(uv_default_loop());
+    timeout.start(10000, 0, [&] {
+        ADD_FAILURE() << "Timed out waiting for the requests to complete";
+        loop.stop();
+        uv_stop(uv_default_loop());
+    });
+
+    // The server holds these responses until /release is requested, so they occupy every
+    // connection to the host that prefetch requests are allowed to use.
+    const int prefetchCount = 24;
+    int prefetched = 0;
+
+    std::unique_ptr<FileRequest> reset;
+    std::vector<std::unique_ptr<FileRequest>> prefetches;
+    for (int i = 0; i < prefetchCount; i++) {
+        const Resource resource { Resource::Tile, "http://127.0.0.1:3000/held?prefetch=" + std::to_string(i) };
+        prefetches.push_back(fs.request(resource, RequestPriority::Prefetch, [&] (Response res) {
+            EXPECT_EQ(nullptr, res.error);
+            if (++prefetched == prefetchCount) {
+                // Makes the server hold /held responses again for the next run.
+                reset = fs.request({ Resource::Unknown, "http://127.0.0.1:3000/reset" }, [&] (Response res2) {
+                    EXPECT_EQ(nullptr, res2.error);
+                    timeout.stop();
+                    loop.stop();
+                    HTTPPriority.finish();
+                });
+            }
+        }));
+    }
+
+    // Prefetch requests leave connections to the host to required requests. If the required
+    // request had to wait for a prefetch request instead, it would never complete.
+    std::unique_ptr<FileRequest> release;
+    std::unique_ptr<FileRequest> required = fs.request({ Resource::Tile, "http://127.0.0.1:3000/test" }, [&] (Response res) {
+        EXPECT_EQ(nullptr, res.error);
+        EXPECT_EQ(0, prefetched);
+
+        release = fs.request({ Resource::Unknown, "http://127.0.0.1:3000/release" }, [&] (Response res2) {
+            EXPECT_EQ(nullptr, res2.error);
+            ASSERT_TRUE(res2.data.get());
+            EXPECT_EQ("Released", *res2.data);
+        });
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
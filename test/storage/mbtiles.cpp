@@ -0,0 +1,127 @@
+#include "storage.hpp"
+
+#include <uv.h>
+
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+TEST_F(Storage, MBTilesTileJSON) {
+    SCOPED_TEST(MBTilesTileJSON)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+    util::RunLoop loop(uv_default_loop());
+
+    std::unique_ptr<FileRequest> req = fs.request({ Resource::Source, "mbtiles://test/fixtures/storage/tiles.mbtiles" }, [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        // Tile URLs point back into the archive; everything else comes from the metadata table.
+        EXPECT_NE(std::string::npos, res.data->find(R"("tiles":["mbtiles://test/fixtures/storage/tiles.mbtiles/{z}/{x}/{y}"])"));
+        EXPECT_NE(std::string::npos, res.data->find(R"("attribution":"fixture")"));
+        EXPECT_NE(std::string::npos, res.data->find(R"("minzoom":0)"));
+        EXPECT_NE(std::string::npos, res.data->find(R"("maxzoom":2)"));
+        EXPECT_NE(std::string::npos, res.data->find(R"("bounds":[)"));
+        EXPECT_NE(std::string::npos, res.data->find(R"("center":[)"));
+        loop.stop();
+        MBTilesTileJSON.finish();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
+
+TEST_F(Storage, MBTilesTile) {
+    SCOPED_TEST(MBTilesTile)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+    util::RunLoop loop(uv_default_loop());
+
+    int responses = 0;
+    auto done = [&] {
+        if (++responses == 3) {
+            loop.stop();
+            MBTilesTile.finish();
+        }
+    };
+
+    // Stored gzipped, and in TMS row order.
+    std::unique_ptr<FileRequest> gzipped = fs.request({ Resource::Tile, "mbtiles://test/fixtures/storage/tiles.mbtiles/1/0/0" }, [&](Response res) {
+        gzipped.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("gzipped tile 1/0/0", *res.data);
+        done();
+    });
+
+    std::unique_ptr<FileRequest> plain = fs.request({ Resource::Tile, "mbtiles://test/fixtures/storage/tiles.mbtiles/1/1/0" }, [&](Response res) {
+        plain.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("plain tile 1/1/0", *res.data);
+        done();
+    });
+
+    std::unique_ptr<FileRequest> missing = fs.request({ Resource::Tile, "mbtiles://test/fixtures/storage/tiles.mbtiles/1/0/1" }, [&](Response res) {
+        missing.reset();
+        ASSERT_NE(nullptr, res.error);
+        EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason);
+        EXPECT_FALSE(res.data.get());
+        done();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
+
+TEST_F(Storage, MBTilesInvalidTile) {
+    SCOPED_TEST(MBTilesInvalidTile)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+    util::RunLoop loop(uv_default_loop());
+
+    // Coordinates outside of the tile pyramid, and zoom levels whose rows can't be flipped.
+    const std::vector<std::string> tiles = {
+        "1/2/0", "1/0/2", "31/0/0", "64/0/0", "1/99999999999999999999/0",
+    };
+
+    std::vector<std::unique_ptr<FileRequest>> requests;
+    std::size_t responses = 0;
+    for (const auto& tile : tiles) {
+        requests.push_back(fs.request({ Resource::Tile, "mbtiles://test/fixtures/storage/tiles.mbtiles/" + tile }, [&, tile](Response res) {
+            ASSERT_NE(nullptr, res.error) << tile;
+            EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason) << tile;
+            EXPECT_FALSE(res.data.get()) << tile;
+
+            if (++responses == tiles.size()) {
+                requests.clear();
+                loop.stop();
+                MBTilesInvalidTile.finish();
+            }
+        }));
+    }
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
+
+TEST_F(Storage, MBTilesMissingArchive) {
+    SCOPED_TEST(MBTilesMissingArchive)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+    util::RunLoop loop(uv_default_loop());
+
+    std::unique_ptr<FileRequest> req = fs.request({ Resource::Tile, "mbtiles://test/fixtures/storage/nonexistent.mbtiles/0/0/0" }, [&](Response res) {
+        req.reset();
+        ASSERT_NE(nullptr, res.error);
+        EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason);
+        loop.stop();
+        MBTilesMissingArchive.finish();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
@@ -0,0 +1,279 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/offline_download.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <uv.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace mbgl;
+
+namespace {
+
+const char* const style = R"({
+    "version": 8,
+    "sources": {
+        "vector": { "type": "vector", "url": "http://example.com/vector.json" },
+        "raster": { "type": "raster", "tiles": [ "http://example.com/raster/{z}/{x}/{y}.png" ], "tileSize": 256, "maxzoom": 1 }
+    },
+    "sprite": "http://example.com/sprite",
+    "glyphs": "http://example.com/{fontstack}/{range}.pbf",
+    "layers": [{
+        "id": "labels", "type": "symbol", "source": "vector", "source-layer": "labels",
+        "layout": { "text-field": "{name}", "text-font": [ "Open Sans Regular" ] }
+    }, {
+        "id": "icons", "type": "symbol", "source": "vector", "source-layer": "icons",
+        "layout": { "icon-image": "{maki}", "text-font": [ "Unused Font" ] }
+    }]
+})";
+
+const char* const tileJSON = R"({ "tiles": [ "http://example.com/vector/{z}/{x}/{y}.pbf" ], "maxzoom": 14 })";
+
+// Replies to every request on the next iteration of the run loop, or right away if `synchronous`
+// is set. Vector tiles have 100 bytes, raster tiles 200, glyph ranges 50 and sprites 10.
+class StubFileSource : public FileSource {
+public:
+    class Request : public FileRequest {
+    public:
+        Request(StubFileSource& fs_) : fs(fs_) {
+            fs.maxActive = std::max(++fs.active, fs.maxActive);
+        }
+
+        ~Request() {
+            *cancelled = true;
+            fs.active--;
+        }
+
+        StubFileSource& fs;
+        std::shared_ptr<bool> cancelled = std::make_shared<bool>(false);
+    };
+
+    std::unique_ptr<FileRequest> request(const Resource& resource, Callback callback) override {
+        requests[resource.url]++;
+        auto req = std::make_unique<Request>(*this);
+        if (synchronous) {
+            callback(respond(resource));
+            return std::move(req);
+        }
+        auto cancelled = req->cancelled;
+        util::RunLoop::Get()->invoke([this, resource, callback, cancelled] {
+            if (!*cancelled) {
+                callback(respond(resource));
+            }
+        });
+        return std::move(req);
+    }
+
+    Response respond(const Resource& resource) const {
+        Response res;
+        if (resource.url == failingURL) {
+            res.error = std::make_unique<Response::Error>(Response::Error::Reason::Server, "failed");
+        } else if (resource.kind == Resource::Kind::Style) {
+            res.data = std::make_shared<std::string>(style);
+        } else if (resource.kind == Resource::Kind::Source) {
+            res.data = std::make_shared<std::string>(tileJSON);
+        } else if (resource.kind == Resource::Kind::Tile) {
+            res.data = std::make_shared<std::string>(resource.url.find(".png") != std::string::npos ? 200 : 100, 'x');
+        } else if (resource.kind == Resource::Kind::Glyphs) {
+            res.data = std::make_shared<std::string>(50, 'x');
+        } else {
+            res.data = std::make_shared<std::string>(10, 'x');
+        }
+        return res;
+    }
+
+    std::unordered_map<std::string, int> requests;
+    std::string failingURL;
+    bool synchronous = false;
+    std::size_t active = 0;
+    std::size_t maxActive = 0;
+};
+
+class Observer : public OfflineDownload::Observer {
+public:
+    void onResolved(const OfflineDownload::Status& status) override {
+        resolved = status;
+        if (stopOnResolved) {
+            util::RunLoop::Get()->stop();
+        }
+    }
+
+    void onStatusChanged(const OfflineDownload::Status& status) override {
+        if (statusChanged) {
+            statusChanged(status);
+        }
+        if (status.complete()) {
+            util::RunLoop::Get()->stop();
+        }
+    }
+
+    void onResourceError(const Resource& resource, const Response::Error&) override {
+        errors.push_back(resource.url);
+    }
+
+    bool stopOnResolved = false;
+    OfflineDownload::Status resolved;
+    std::function<void (const OfflineDownload::Status&)> statusChanged;
+    std::vector<std::string> errors;
+};
+
+OfflineRegionDefinition world() {
+    OfflineRegionDefinition definition;
+    definition.styleURL = "http://example.com/style.json";
+    definition.minZoom = 0;
+    definition.maxZoom = 1;
+    return definition;
+}
+
+} // namespace
+
+TEST(OfflineDownload, Resolve) {
+    util::RunLoop loop(uv_default_loop());
+    StubFileSource fs;
+    Observer observer;
+    observer.stopOnResolved = true;
+
+    OfflineDownload download(fs, world(), observer);
+    download.resolve();
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    // Style, TileJSON, sprite JSON and image, 256 glyph ranges of the font stack that is used for
+    // labels, 5 vector tiles at z0 and z1, and 4 raster tiles at z1 only, since their tiles are
+    // half as large and the source has a maximum zoom level of 1.
+    const auto status = download.getStatus();
+    EXPECT_TRUE(status.resolved);
+    EXPECT_FALSE(status.complete());
+    EXPECT_EQ(1u + 1 + 2 + 256 + 5 + 4, status.requiredResourceCount);
+    EXPECT_EQ(1, fs.requests.count("http://example.com/Open%20Sans%20Regular/0-255.pbf"));
+    EXPECT_EQ(0, fs.requests.count("http://example.com/Unused%20Font/0-255.pbf"));
+    EXPECT_EQ(1, fs.requests.count("http://example.com/raster/1/1/1.png"));
+    EXPECT_EQ(0, fs.requests.count("http://example.com/raster/0/0/0.png"));
+
+    // Only samples of every group of resources were loaded.
+    EXPECT_EQ(1u + 1 + 2 + 4 + 4 + 4, status.completedResourceCount);
+    EXPECT_EQ(status.completedResourceCount, fs.requests.size());
+
+    // Resources of the same group all have the same size, so the estimate is exact.
+    const uint64_t metadataSize = std::string(style).size() + std::string(tileJSON).size();
+    EXPECT_EQ(metadataSize + 2 * 10 + 256 * 50 + 5 * 100 + 4 * 200, status.estimatedResourceSize);
+    EXPECT_EQ(status.estimatedResourceSize, observer.resolved.estimatedResourceSize);
+}
+
+TEST(OfflineDownload, Download) {
+    util::RunLoop loop(uv_default_loop());
+    StubFileSource fs;
+    fs.failingURL = "http://example.com/vector/1/0/1.pbf";
+    Observer observer;
+
+    OfflineDownload download(fs, world(), observer);
+    download.setMaximumConcurrentRequests(4);
+    download.start();
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    const auto status = download.getStatus();
+    EXPECT_TRUE(status.complete());
+    EXPECT_EQ(status.requiredResourceCount - 1, status.completedResourceCount);
+    EXPECT_EQ(1u, status.failedResourceCount);
+    EXPECT_EQ(std::vector<std::string>{ fs.failingURL }, observer.errors);
+    EXPECT_EQ(status.completedResourceSize + 100, observer.resolved.estimatedResourceSize);
+
+    // Every resource was requested exactly once, never more than four at a time.
+    EXPECT_EQ(status.requiredResourceCount, fs.requests.size());
+    for (const auto& request : fs.requests) {
+        EXPECT_EQ(1, request.second) << request.first;
+    }
+    EXPECT_EQ(4u, fs.maxActive);
+}
+
+TEST(OfflineDownload, StopAndResume) {
+    util::RunLoop loop(uv_default_loop());
+    StubFileSource fs;
+    Observer observer;
+
+    OfflineDownload download(fs, world(), observer);
+    bool stopped = false;
+    observer.statusChanged = [&] (const OfflineDownload::Status& status) {
+        if (!stopped && status.completedResourceCount == 100) {
+            stopped = true;
+            download.stop();
+
+            // Requests in progress were cancelled.
+            EXPECT_EQ(0u, fs.active);
+
+            util::RunLoop::Get()->invoke([&] {
+                EXPECT_EQ(100u, download.getStatus().completedResourceCount);
+                download.start();
+            });
+        }
+    };
+    download.start();
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    // Cancelled resources were requested again, but none of the completed ones.
+    const auto status = download.getStatus();
+    EXPECT_TRUE(status.complete());
+    EXPECT_EQ(status.requiredResourceCount, status.completedResourceCount);
+    EXPECT_EQ(status.requiredResourceCount, fs.requests.size());
+}
+
+TEST(OfflineDownload, ExceedsCacheSize) {
+    util::RunLoop loop(uv_default_loop());
+    StubFileSource fs;
+    Observer observer;
+
+    OfflineDownload download(fs, world(), observer);
+    download.setMaximumCacheSize(10 * 1024);
+    bool raised = false;
+    observer.statusChanged = [&] (const OfflineDownload::Status& status) {
+        if (!raised && status.resolved) {
+            raised = true;
+
+            // The region is estimated to take more than 13 KB, so only the resources that are
+            // needed to resolve it were downloaded.
+            EXPECT_TRUE(status.exceedsCacheSize);
+            EXPECT_TRUE(observer.resolved.exceedsCacheSize);
+            EXPECT_EQ(1u + 1 + 2 + 4 + 4 + 4, status.completedResourceCount);
+            EXPECT_EQ(status.completedResourceCount, fs.requests.size());
+
+            // Downloading continues once the cache is large enough.
+            util::RunLoop::Get()->invoke([&] {
+                EXPECT_EQ(1u + 1 + 2 + 4 + 4 + 4, download.getStatus().completedResourceCount);
+                download.setMaximumCacheSize(64 * 1024);
+            });
+        }
+    };
+    download.start();
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    const auto status = download.getStatus();
+    EXPECT_TRUE(status.complete());
+    EXPECT_FALSE(status.exceedsCacheSize);
+    EXPECT_EQ(status.requiredResourceCount, status.completedResourceCount);
+}
+
+TEST(OfflineDownload, SynchronousResponses) {
+    util::RunLoop loop(uv_default_loop());
+    StubFileSource fs;
+    fs.synchronous = true;
+    Observer observer;
+
+    // Thousands of vector tiles at zoom levels 0 to 6.
+    OfflineRegionDefinition definition = world();
+    definition.maxZoom = 6;
+
+    // Responses that arrive before request() returns don't leave their fetch behind, occupying
+    // the only request slot, and don't start the next request before returning.
+    OfflineDownload download(fs, definition, observer);
+    download.setMaximumConcurrentRequests(1);
+    download.start();
+
+    const auto status = download.getStatus();
+    EXPECT_TRUE(status.complete());
+    EXPECT_LT(5000u, status.requiredResourceCount);
+    EXPECT_EQ(status.requiredResourceCount, status.completedResourceCount);
+    EXPECT_EQ(status.requiredResourceCount, fs.requests.size());
+    EXPECT_EQ(1u, fs.maxActive);
+}
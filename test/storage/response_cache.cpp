@@ -0,0 +1,84 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/storage/response_cache.hpp>
+#include <mbgl/util/chrono.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+std::shared_ptr<Response> response(const std::string& data, int64_t expires) {
+    auto res = std::make_shared<Response>();
+    res->data = std::make_shared<std::string>(data);
+    res->expires = expires;
+    return res;
+}
+
+int64_t now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(SystemClock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+TEST(ResponseCache, LeastRecentlyUsed) {
+    // Room for two entries: every entry takes up 4 bytes of URL and 6 bytes of data.
+    ResponseCache cache(20);
+
+    const Resource a { Resource::Tile, "a:/0" };
+    const Resource b { Resource::Tile, "b:/0" };
+    const Resource c { Resource::Glyphs, "c:/0" };
+
+    cache.add(a, response("Data A", now() + 3600));
+    cache.add(b, response("Data B", now() + 3600));
+    EXPECT_EQ(20u, cache.getStatistics().size);
+
+    // Adding a third entry purges the least recently used one.
+    cache.add(c, response("Data C", now() + 3600));
+    EXPECT_EQ(20u, cache.getStatistics().size);
+    EXPECT_EQ(nullptr, cache.get(a));
+
+    // Hits remove the entry from the cache.
+    auto hit = cache.get(b);
+    ASSERT_NE(nullptr, hit);
+    EXPECT_EQ("Data B", *hit->data);
+    EXPECT_EQ(nullptr, cache.get(b));
+    EXPECT_EQ(10u, cache.getStatistics().size);
+
+    ASSERT_NE(nullptr, cache.get(c));
+
+    const ResponseCache::Statistics statistics = cache.getStatistics();
+    EXPECT_EQ(0u, statistics.size);
+    EXPECT_EQ(1u, statistics.tiles.hits);
+    EXPECT_EQ(2u, statistics.tiles.misses);
+    EXPECT_EQ(1u, statistics.glyphs.hits);
+    EXPECT_EQ(0u, statistics.glyphs.misses);
+    EXPECT_EQ(0u, statistics.sprites.hits + statistics.sprites.misses);
+}
+
+TEST(ResponseCache, OnlyFreshResponses) {
+    ResponseCache cache(1024);
+
+    const Resource resource { Resource::SpriteJSON, "sprite" };
+
+    // Responses without an expiration date have to be revalidated.
+    cache.add(resource, response("Sprite", 0));
+    EXPECT_EQ(0u, cache.getStatistics().size);
+
+    auto error = response("Sprite", now() + 3600);
+    error->error = std::make_unique<Response::Error>(Response::Error::Reason::Server);
+    cache.add(resource, error);
+    EXPECT_EQ(0u, cache.getStatistics().size);
+
+    cache.add(resource, response("Sprite", now() + 3600));
+    EXPECT_NE(0u, cache.getStatistics().size);
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.getStatistics().size);
+    EXPECT_EQ(nullptr, cache.get(resource));
+    EXPECT_EQ(1u, cache.getStatistics().sprites.misses);
+
+    // A size of 0 disables the cache.
+    cache.setSize(0);
+    cache.add(resource, response("Sprite", now() + 3600));
+    EXPECT_EQ(0u, cache.getStatistics().size);
+}
@@ -108,6 +108,32 @@ app.get('/delayed', function(req, res) {
     }, 200);
 });
 
+// Requests to /held don't get a response until /release is requested. After that, they are answered
+// right away until /reset is requested.
+var held = [];
+var released = false;
+app.get('/held', function(req, res) {
+    if (released) {
+        res.status(200).send('Response');
+    } else {
+        held.push(res);
+    }
+});
+
+app.get('/release', function(req, res) {
+    released = true;
+    held.forEach(function(heldRes) {
+        heldRes.status(200).send('Response');
+    });
+    held = [];
+    res.status(200).send('Released');
+});
+
+app.get('/reset', function(req, res) {
+    released = false;
+    res.status(200).send('Reset');
+});
+
 
 app.get('/load/:number(\\d+)', function(req, res) {
     res.send('Request ' + req.params.number);